@@ -0,0 +1,102 @@
+#include "AllPairsTable.h"
+#include <limits>
+
+AllPairsTable::AllPairsTable(quint64 graphVersion, std::shared_ptr<const std::unordered_map<int, int>> index, std::vector<int> stationIds,
+                             std::vector<double> distances, std::vector<int> nextHops, QueryStatus status)
+    : version(graphVersion), tableStatus(status), indexById(std::move(index)), stationIds(std::move(stationIds)),
+      distances(std::move(distances)), nextHops(std::move(nextHops))
+{
+}
+
+quint64 AllPairsTable::graphVersion() const
+{
+    return version;
+}
+
+QueryStatus AllPairsTable::status() const
+{
+    return tableStatus;
+}
+
+double AllPairsTable::distance(int fromId, int toId) const
+{
+    int from = indexOf(fromId);
+    int to = indexOf(toId);
+    if (from < 0 || to < 0)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    return distances[from * stationIds.size() + to];
+}
+
+PathDetail AllPairsTable::route(int fromId, int toId) const
+{
+    int from = indexOf(fromId);
+    int to = indexOf(toId);
+    size_t size = stationIds.size();
+    if (from < 0 || to < 0 || nextHops[from * size + to] == -1)
+    {
+        return {{}, std::numeric_limits<double>::infinity(), tableStatus};
+    }
+    std::vector<int> path;
+    int current = from;
+    path.push_back(stationIds[current]);
+    while (current != to)
+    {
+        current = nextHops[current * size + to];
+        // Una tabla cortada por un límite puede tener saltos incompletos
+        if (current == -1 || path.size() > size)
+        {
+            return {{}, std::numeric_limits<double>::infinity(), tableStatus};
+        }
+        path.push_back(stationIds[current]);
+    }
+    return {path, distances[from * size + to], tableStatus};
+}
+
+qint64 AllPairsTable::memoryBytes() const
+{
+    return static_cast<qint64>(sizeof(*this) + stationIds.capacity() * sizeof(int) + distances.capacity() * sizeof(double) +
+                               nextHops.capacity() * sizeof(int));
+}
+
+int AllPairsTable::indexOf(int stationId) const
+{
+    auto it = indexById->find(stationId);
+    return it == indexById->end() || it->second >= static_cast<int>(stationIds.size()) ? -1 : it->second;
+}
+
+AllPairsCache::AllPairsCache()
+    : repairCount(0)
+{
+}
+
+std::shared_ptr<const AllPairsTable> AllPairsCache::latest() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return table;
+}
+
+void AllPairsCache::store(const std::shared_ptr<const AllPairsTable> &table)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    this->table = table;
+}
+
+void AllPairsCache::recordRepair()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    ++repairCount;
+}
+
+quint64 AllPairsCache::repairs() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return repairCount;
+}
+
+void AllPairsCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    table.reset();
+}
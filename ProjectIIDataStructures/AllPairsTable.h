@@ -0,0 +1,48 @@
+#pragma once
+
+#include "GraphNetwork.h"
+#include <QtGlobal>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Resultado de Floyd-Warshall: distancias y primer salto de cada par en arreglos planos por filas.
+// Una vez calculada, cada consulta cuesta O(largo del camino).
+class AllPairsTable
+{
+public:
+    AllPairsTable(quint64 graphVersion, std::shared_ptr<const std::unordered_map<int, int>> index, std::vector<int> stationIds,
+                  std::vector<double> distances, std::vector<int> nextHops, QueryStatus status);
+    quint64 graphVersion() const;
+    QueryStatus status() const;
+    double distance(int fromId, int toId) const;
+    PathDetail route(int fromId, int toId) const;
+    qint64 memoryBytes() const;
+private:
+    // GraphNetwork repara tablas viejas a partir de sus arreglos
+    friend class GraphNetwork;
+    quint64 version;
+    QueryStatus tableStatus;
+    std::shared_ptr<const std::unordered_map<int, int>> indexById;
+    std::vector<int> stationIds;
+    std::vector<double> distances;
+    std::vector<int> nextHops; // -1 si no hay camino
+    int indexOf(int stationId) const;
+};
+
+// Guarda la última tabla completa; se comparte entre las copias de un GraphNetwork como la caché de árboles
+class AllPairsCache
+{
+public:
+    AllPairsCache();
+    std::shared_ptr<const AllPairsTable> latest() const;
+    void store(const std::shared_ptr<const AllPairsTable> &table);
+    void recordRepair();
+    quint64 repairs() const;
+    void clear();
+private:
+    mutable std::mutex mutex;
+    std::shared_ptr<const AllPairsTable> table;
+    quint64 repairCount;
+};
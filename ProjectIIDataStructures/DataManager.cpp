@@ -9,6 +9,11 @@ DataManager::DataManager()
     setBasePath(QDir::currentPath());
 }
 
+DataManager::DataManager(const QString &path)
+{
+    setBasePath(path);
+}
+
 void DataManager::setBasePath(const QString &path)
 {
     QDir dir(path);
@@ -18,6 +23,8 @@ void DataManager::setBasePath(const QString &path)
     closuresFile = dir.filePath("cierres.txt");
     reportsFile = dir.filePath("reportes.txt");
     traversalFile = dir.filePath("recorridos_rutas.txt");
+    landmarksFile = dir.filePath("landmarks.bin");
+    hubLabelsFile = dir.filePath("hub_labels.bin");
     ensureFiles();
 }
 
@@ -210,6 +217,16 @@ QString DataManager::getBasePath() const
     return basePath;
 }
 
+QString DataManager::getLandmarksPath() const
+{
+    return landmarksFile;
+}
+
+QString DataManager::getHubLabelsPath() const
+{
+    return hubLabelsFile;
+}
+
 void DataManager::ensureFiles() const
 {
     QFile stationData(stationsFile);
@@ -9,6 +9,7 @@ class DataManager
 {
 public:
     DataManager();
+    explicit DataManager(const QString &path);
     void setBasePath(const QString &path);
     void load(StationTree &tree, GraphNetwork &graph) const;
     void save(const StationTree &tree, const GraphNetwork &graph) const;
@@ -17,6 +18,8 @@ public:
     void appendReportLine(const QString &line) const;
     void saveTraversal(const QString &content) const;
     QString getBasePath() const;
+    QString getLandmarksPath() const;
+    QString getHubLabelsPath() const;
 private:
     QString basePath;
     QString stationsFile;
@@ -24,5 +27,7 @@ private:
     QString closuresFile;
     QString reportsFile;
     QString traversalFile;
+    QString landmarksFile;
+    QString hubLabelsFile;
     void ensureFiles() const;
 };
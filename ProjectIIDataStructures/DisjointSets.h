@@ -0,0 +1,58 @@
+#pragma once
+
+#include <numeric>
+#include <utility>
+#include <vector>
+
+// Conjuntos disjuntos sobre índices densos 0..n-1, con unión por tamaño y compresión de caminos por mitades
+class DisjointSets
+{
+public:
+    explicit DisjointSets(int count = 0)
+    {
+        reset(count);
+    }
+    void reset(int count)
+    {
+        parents.resize(count);
+        std::iota(parents.begin(), parents.end(), 0);
+        sizes.assign(count, 1);
+    }
+    int find(int node)
+    {
+        while (parents[node] != node)
+        {
+            parents[node] = parents[parents[node]];
+            node = parents[node];
+        }
+        return node;
+    }
+    // Sin compresión: varios hilos pueden consultar a la vez mientras nadie une
+    int peek(int node) const
+    {
+        while (parents[node] != node)
+        {
+            node = parents[node];
+        }
+        return node;
+    }
+    bool unite(int a, int b)
+    {
+        a = find(a);
+        b = find(b);
+        if (a == b)
+        {
+            return false;
+        }
+        if (sizes[a] < sizes[b])
+        {
+            std::swap(a, b);
+        }
+        parents[b] = a;
+        sizes[a] += sizes[b];
+        return true;
+    }
+private:
+    std::vector<int> parents;
+    std::vector<int> sizes;
+};
@@ -0,0 +1,367 @@
+#include "DynamicForest.h"
+#include <algorithm>
+
+DynamicForest::DynamicForest(int stations)
+    : stations(stations), left(stations, -1), right(stations, -1), parent(stations, -1), flipped(stations, 0), heaviest(stations, -1),
+      edgeOf(stations, GraphEdge{-1, -1, 0}), neighbours(stations), sideStamp(stations, 0), stamp(0), removedSide(0)
+{
+}
+
+int DynamicForest::stationCount() const
+{
+    return stations;
+}
+
+bool DynamicForest::contains(int from, int to) const
+{
+    return nodeByEdge.count(edgeKey(from, to)) != 0;
+}
+
+void DynamicForest::offer(int from, int to, double weight)
+{
+    if (from > to)
+    {
+        std::swap(from, to);
+    }
+    if (findRoot(from) != findRoot(to))
+    {
+        addEdge(from, to, weight);
+        return;
+    }
+    makeRoot(from);
+    access(to);
+    int worst = heaviest[to];
+    const GraphEdge &current = edgeOf[worst];
+    GraphEdge candidate{from, to, weight};
+    bool lighter = candidate.weight != current.weight ? candidate.weight < current.weight
+                                                       : std::make_pair(from, to) < std::make_pair(current.from, current.to);
+    if (lighter)
+    {
+        removeEdge(current.from, current.to);
+        addEdge(from, to, weight);
+    }
+}
+
+void DynamicForest::lower(int from, int to, double weight)
+{
+    auto it = nodeByEdge.find(edgeKey(from, to));
+    if (it == nodeByEdge.end())
+    {
+        return;
+    }
+    // Con el nodo en la raíz de su splay, su agregado es el único que depende del peso
+    access(it->second);
+    ordered.erase(edgeOf[it->second]);
+    edgeOf[it->second].weight = weight;
+    ordered.insert(edgeOf[it->second]);
+    pull(it->second);
+}
+
+void DynamicForest::remove(int from, int to, std::vector<int> &side)
+{
+    side.clear();
+    if (!contains(from, to))
+    {
+        return;
+    }
+    removeEdge(from, to);
+    // Dos recorridos intercalados por el bosque; el primero que se agota es el lado chico
+    std::vector<int> sides[2] = {{from}, {to}};
+    size_t next[2] = {0, 0};
+    quint32 marks[2] = {stamp + 1, stamp + 2};
+    stamp += 2;
+    sideStamp[from] = marks[0];
+    sideStamp[to] = marks[1];
+    while (true)
+    {
+        for (int turn = 0; turn < 2; ++turn)
+        {
+            std::vector<int> &queue = sides[turn];
+            if (next[turn] == queue.size())
+            {
+                removedSide = marks[turn];
+                side = std::move(queue);
+                return;
+            }
+            int station = queue[next[turn]++];
+            for (int neighbour : neighbours[station])
+            {
+                if (sideStamp[neighbour] != marks[turn])
+                {
+                    sideStamp[neighbour] = marks[turn];
+                    queue.push_back(neighbour);
+                }
+            }
+        }
+    }
+}
+
+bool DynamicForest::inRemovedSide(int station) const
+{
+    return sideStamp[station] == removedSide;
+}
+
+std::vector<GraphEdge> DynamicForest::edges() const
+{
+    return std::vector<GraphEdge>(ordered.begin(), ordered.end());
+}
+
+bool DynamicForest::EdgeOrder::operator()(const GraphEdge &a, const GraphEdge &b) const
+{
+    if (a.weight != b.weight)
+    {
+        return a.weight < b.weight;
+    }
+    return std::make_pair(a.from, a.to) < std::make_pair(b.from, b.to);
+}
+
+quint64 DynamicForest::edgeKey(int from, int to)
+{
+    if (from > to)
+    {
+        std::swap(from, to);
+    }
+    return (static_cast<quint64>(static_cast<quint32>(from)) << 32) | static_cast<quint32>(to);
+}
+
+bool DynamicForest::isSplayRoot(int node) const
+{
+    int up = parent[node];
+    return up == -1 || (left[up] != node && right[up] != node);
+}
+
+bool DynamicForest::heavier(int a, int b) const
+{
+    if (b < 0)
+    {
+        return a >= 0;
+    }
+    if (a < 0)
+    {
+        return false;
+    }
+    const GraphEdge &x = edgeOf[a];
+    const GraphEdge &y = edgeOf[b];
+    if (x.weight != y.weight)
+    {
+        return x.weight > y.weight;
+    }
+    return std::make_pair(x.from, x.to) > std::make_pair(y.from, y.to);
+}
+
+void DynamicForest::push(int node)
+{
+    if (!flipped[node])
+    {
+        return;
+    }
+    std::swap(left[node], right[node]);
+    if (left[node] >= 0)
+    {
+        flipped[left[node]] ^= 1;
+    }
+    if (right[node] >= 0)
+    {
+        flipped[right[node]] ^= 1;
+    }
+    flipped[node] = 0;
+}
+
+void DynamicForest::pull(int node)
+{
+    int best = node >= stations ? node : -1;
+    for (int child : {left[node], right[node]})
+    {
+        if (child >= 0 && heavier(heaviest[child], best))
+        {
+            best = heaviest[child];
+        }
+    }
+    heaviest[node] = best;
+}
+
+void DynamicForest::rotate(int node)
+{
+    int up = parent[node];
+    int grand = parent[up];
+    if (!isSplayRoot(up))
+    {
+        (left[grand] == up ? left[grand] : right[grand]) = node;
+    }
+    parent[node] = grand;
+    if (left[up] == node)
+    {
+        left[up] = right[node];
+        if (right[node] >= 0)
+        {
+            parent[right[node]] = up;
+        }
+        right[node] = up;
+    }
+    else
+    {
+        right[up] = left[node];
+        if (left[node] >= 0)
+        {
+            parent[left[node]] = up;
+        }
+        left[node] = up;
+    }
+    parent[up] = node;
+    pull(up);
+    pull(node);
+}
+
+void DynamicForest::splay(int node)
+{
+    // Las inversiones pendientes se bajan desde la raíz del splay antes de rotar
+    splayPath.assign(1, node);
+    for (int current = node; !isSplayRoot(current); current = parent[current])
+    {
+        splayPath.push_back(parent[current]);
+    }
+    for (auto it = splayPath.rbegin(); it != splayPath.rend(); ++it)
+    {
+        push(*it);
+    }
+    while (!isSplayRoot(node))
+    {
+        int up = parent[node];
+        if (!isSplayRoot(up))
+        {
+            int grand = parent[up];
+            rotate((left[grand] == up) == (left[up] == node) ? up : node);
+        }
+        rotate(node);
+    }
+}
+
+void DynamicForest::access(int node)
+{
+    for (int current = node, last = -1; current != -1; last = current, current = parent[current])
+    {
+        splay(current);
+        right[current] = last;
+        pull(current);
+    }
+    splay(node);
+}
+
+void DynamicForest::makeRoot(int node)
+{
+    access(node);
+    flipped[node] ^= 1;
+}
+
+int DynamicForest::findRoot(int node)
+{
+    access(node);
+    push(node);
+    while (left[node] >= 0)
+    {
+        node = left[node];
+        push(node);
+    }
+    splay(node);
+    return node;
+}
+
+void DynamicForest::link(int child, int node)
+{
+    makeRoot(child);
+    parent[child] = node;
+}
+
+void DynamicForest::cut(int a, int b)
+{
+    makeRoot(a);
+    access(b);
+    // a y b son vecinos: tras access(b), a es el hijo izquierdo de b y no tiene hijo derecho
+    left[b] = -1;
+    parent[a] = -1;
+    pull(b);
+}
+
+void DynamicForest::addEdge(int from, int to, double weight)
+{
+    int node;
+    if (!freeNodes.empty())
+    {
+        node = freeNodes.back();
+        freeNodes.pop_back();
+    }
+    else
+    {
+        node = static_cast<int>(left.size());
+        left.push_back(-1);
+        right.push_back(-1);
+        parent.push_back(-1);
+        flipped.push_back(0);
+        heaviest.push_back(-1);
+        edgeOf.push_back({-1, -1, 0});
+    }
+    left[node] = right[node] = parent[node] = -1;
+    flipped[node] = 0;
+    edgeOf[node] = {std::min(from, to), std::max(from, to), weight};
+    heaviest[node] = node;
+    link(node, from);
+    link(to, node);
+    nodeByEdge[edgeKey(from, to)] = node;
+    ordered.insert(edgeOf[node]);
+    neighbours[from].push_back(to);
+    neighbours[to].push_back(from);
+}
+
+void DynamicForest::removeEdge(int from, int to)
+{
+    auto it = nodeByEdge.find(edgeKey(from, to));
+    int node = it->second;
+    nodeByEdge.erase(it);
+    ordered.erase(edgeOf[node]);
+    cut(from, node);
+    cut(node, to);
+    freeNodes.push_back(node);
+    for (auto [station, other] : {std::make_pair(from, to), std::make_pair(to, from)})
+    {
+        std::vector<int> &list = neighbours[station];
+        auto position = std::find(list.begin(), list.end(), other);
+        *position = list.back();
+        list.pop_back();
+    }
+}
+
+SpanningForestCache::SpanningForestCache()
+    : version(0), updateCount(0), rebuildCount(0), rescanCount(0), rescannedArcCount(0)
+{
+}
+
+void SpanningForestCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    forest.reset();
+    detail.reset();
+}
+
+quint64 SpanningForestCache::updates() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return updateCount;
+}
+
+quint64 SpanningForestCache::rebuilds() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return rebuildCount;
+}
+
+quint64 SpanningForestCache::rescans() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return rescanCount;
+}
+
+quint64 SpanningForestCache::rescannedArcs() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return rescannedArcCount;
+}
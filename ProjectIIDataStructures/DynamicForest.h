@@ -0,0 +1,95 @@
+#pragma once
+
+#include "GraphNetwork.h"
+#include <QtGlobal>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+// Bosque de expansión mínimo que se mantiene tramo a tramo con un árbol link-cut. Cada tramo del bosque es un nodo
+// propio entre sus dos estaciones, así el máximo de un camino es una consulta O(log n) amortizada. Trabaja con índices
+// de estación y desempata como kruskal, por (peso, índice menor, índice mayor): el bosque es el mismo que el de kruskal.
+class DynamicForest
+{
+public:
+    explicit DynamicForest(int stations);
+    int stationCount() const;
+    bool contains(int from, int to) const;
+    // Tramo nuevo o más barato fuera del bosque: entra si une dos árboles o si es más liviano que el más pesado
+    // del ciclo que cierra, que sale
+    void offer(int from, int to, double weight);
+    // Un tramo del bosque que se abarata sigue en él; solo cambia su peso
+    void lower(int from, int to, double weight);
+    // Saca un tramo del bosque y deja en side las estaciones del lado más chico de los dos árboles resultantes.
+    // Recorre ambos lados a la vez, así el costo es el del lado chico
+    void remove(int from, int to, std::vector<int> &side);
+    // Si la estación quedó en side en el último remove
+    bool inRemovedSide(int station) const;
+    // Tramos del bosque con from < to, en índices de estación y en el orden de kruskal
+    std::vector<GraphEdge> edges() const;
+private:
+    struct EdgeOrder
+    {
+        bool operator()(const GraphEdge &a, const GraphEdge &b) const;
+    };
+    int stations;
+    // Nodos 0..stations-1 son estaciones; los demás, tramos (se reciclan con freeNodes)
+    std::vector<int> left;
+    std::vector<int> right;
+    std::vector<int> parent;
+    std::vector<char> flipped;
+    std::vector<int> heaviest; // nodo tramo más pesado del subárbol del splay, -1 si no hay
+    std::vector<GraphEdge> edgeOf;
+    std::vector<int> freeNodes;
+    std::unordered_map<quint64, int> nodeByEdge;
+    // Los mismos tramos ordenados, para entregar el bosque sin ordenarlo en cada consulta
+    std::set<GraphEdge, EdgeOrder> ordered;
+    // Vecinos de cada estación en el bosque, para recorrer los lados al quitar un tramo
+    std::vector<std::vector<int>> neighbours;
+    // Marca de recorrido por estación: cada remove usa dos valores nuevos, uno por lado
+    std::vector<quint32> sideStamp;
+    quint32 stamp;
+    quint32 removedSide;
+    std::vector<int> splayPath;
+
+    static quint64 edgeKey(int from, int to);
+    bool isSplayRoot(int node) const;
+    bool heavier(int a, int b) const;
+    void push(int node);
+    void pull(int node);
+    void rotate(int node);
+    void splay(int node);
+    void access(int node);
+    void makeRoot(int node);
+    int findRoot(int node);
+    void link(int child, int node);
+    void cut(int a, int b);
+    void addEdge(int from, int to, double weight);
+    void removeEdge(int from, int to);
+};
+
+// Último bosque mantenido, compartido entre las copias de un GraphNetwork como las demás cachés.
+// GraphNetwork lo actualiza con los cambios de tramos registrados desde su versión.
+class SpanningForestCache
+{
+public:
+    SpanningForestCache();
+    void clear();
+    quint64 updates() const;
+    quint64 rebuilds() const;
+    // Tramos del bosque quitados o encarecidos y tramos recorridos buscando su reemplazo
+    quint64 rescans() const;
+    quint64 rescannedArcs() const;
+private:
+    friend class GraphNetwork;
+    mutable std::mutex mutex;
+    std::unique_ptr<DynamicForest> forest;
+    quint64 version;
+    std::shared_ptr<const TreeDetail> detail;
+    quint64 updateCount;
+    quint64 rebuildCount;
+    quint64 rescanCount;
+    quint64 rescannedArcCount;
+};
@@ -0,0 +1,463 @@
+#include "EdgeLayerItem.h"
+#include <QBrush>
+#include <QColor>
+#include <QFontMetricsF>
+#include <QGraphicsSceneHoverEvent>
+#include <QPainter>
+#include <QPen>
+#include <QSizeF>
+#include <QStyleOptionGraphicsItem>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+constexpr qreal kLabelOffset = 22.0;
+constexpr qreal kLabelMinLevelOfDetail = 0.35;
+constexpr qreal kMinCellSize = 64.0;
+
+qreal distanceToSegment(const QPointF &point, const QPointF &start, const QPointF &end)
+{
+    QPointF segment = end - start;
+    qreal lengthSquared = segment.x() * segment.x() + segment.y() * segment.y();
+    if (lengthSquared <= 0.0)
+    {
+        return QLineF(point, start).length();
+    }
+    QPointF relative = point - start;
+    qreal t = (relative.x() * segment.x() + relative.y() * segment.y()) / lengthSquared;
+    t = std::clamp(t, static_cast<qreal>(0.0), static_cast<qreal>(1.0));
+    return QLineF(point, start + segment * t).length();
+}
+
+QPen penForStyle(EdgeLayerItem::EdgeStyle style)
+{
+    QPen pen;
+    switch (style)
+    {
+    case EdgeLayerItem::EdgeStyle::Closed:
+        pen = QPen(QColor(239, 68, 68), 4.5);
+        pen.setStyle(Qt::DashLine);
+        pen.setDashPattern({8.0, 4.0});
+        break;
+    case EdgeLayerItem::EdgeStyle::Mst:
+        pen = QPen(QColor(16, 185, 129), 5.0);
+        break;
+    default:
+        pen = QPen(QColor(99, 102, 241), 3.5);
+        break;
+    }
+    pen.setCapStyle(Qt::RoundCap);
+    pen.setJoinStyle(Qt::RoundJoin);
+    return pen;
+}
+
+QColor labelBackgroundForStyle(EdgeLayerItem::EdgeStyle style)
+{
+    switch (style)
+    {
+    case EdgeLayerItem::EdgeStyle::Closed:
+        return QColor(239, 68, 68, 140);
+    case EdgeLayerItem::EdgeStyle::Mst:
+        return QColor(16, 185, 129, 170);
+    default:
+        return QColor(255, 255, 255, 230);
+    }
+}
+
+QColor labelTextForStyle(EdgeLayerItem::EdgeStyle style)
+{
+    return style == EdgeLayerItem::EdgeStyle::Open ? QColor(30, 41, 59) : QColor(255, 255, 255);
+}
+}
+
+EdgeLayerItem::EdgeLayerItem(QGraphicsItem *parent)
+    : QGraphicsItem(parent),
+      labelFont("Segoe UI", 10, QFont::Bold),
+      cellSize(kMinCellSize),
+      gridDirty(true),
+      currentStamp(0)
+{
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption, true);
+    setAcceptHoverEvents(true);
+    setAcceptedMouseButtons(Qt::NoButton);
+}
+
+void EdgeLayerItem::clearEdges()
+{
+    prepareGeometryChange();
+    edges.clear();
+    points.clear();
+    for (auto &batch : styleBatches)
+    {
+        batch.clear();
+    }
+    totalBounds = QRectF();
+    grid.clear();
+    gridDirty = true;
+    update();
+}
+
+void EdgeLayerItem::reserve(size_t edgeCount, size_t pointCount)
+{
+    edges.reserve(edgeCount);
+    points.reserve(pointCount);
+}
+
+void EdgeLayerItem::addEdge(int fromId, int toId, double weight, EdgeStyle style, const std::vector<QPointF> &path)
+{
+    if (path.size() < 2)
+    {
+        return;
+    }
+    prepareGeometryChange();
+    EdgeRecord record;
+    record.fromId = fromId;
+    record.toId = toId;
+    record.weight = weight;
+    record.style = style;
+    record.firstPoint = static_cast<int>(points.size());
+    record.pointCount = static_cast<int>(path.size());
+    points.insert(points.end(), path.begin(), path.end());
+    qreal minX = path.front().x();
+    qreal maxX = minX;
+    qreal minY = path.front().y();
+    qreal maxY = minY;
+    for (const auto &point : path)
+    {
+        minX = std::min(minX, point.x());
+        maxX = std::max(maxX, point.x());
+        minY = std::min(minY, point.y());
+        maxY = std::max(maxY, point.y());
+    }
+    qreal margin = penForStyle(style).widthF();
+    record.bounds = QRectF(QPointF(minX, minY), QPointF(maxX, maxY)).adjusted(-margin, -margin, margin, margin);
+    record.labelText = QString::number(weight, 'f', 1) + " min";
+    if (style == EdgeStyle::Closed)
+    {
+        record.labelText = "✖ " + record.labelText;
+    }
+    placeLabel(record);
+    QRectF edgeArea = record.bounds.united(record.labelRect.adjusted(-8.0, -5.0, 10.0, 7.0));
+    totalBounds = totalBounds.isNull() ? edgeArea : totalBounds.united(edgeArea);
+    styleBatches[static_cast<int>(style)].push_back(static_cast<int>(edges.size()));
+    edges.push_back(std::move(record));
+    gridDirty = true;
+}
+
+int EdgeLayerItem::edgeCount() const
+{
+    return static_cast<int>(edges.size());
+}
+
+int EdgeLayerItem::edgeAt(const QPointF &point, qreal tolerance) const
+{
+    if (edges.empty())
+    {
+        return -1;
+    }
+    std::vector<int> candidates;
+    collectEdges(QRectF(point.x() - tolerance, point.y() - tolerance, tolerance * 2.0, tolerance * 2.0), candidates);
+    int best = -1;
+    qreal bestDistance = tolerance;
+    for (int index : candidates)
+    {
+        const EdgeRecord &record = edges[index];
+        if (record.labelRect.adjusted(-8.0, -5.0, 8.0, 5.0).contains(point))
+        {
+            return index;
+        }
+        qreal halfWidth = penForStyle(record.style).widthF() / 2.0;
+        for (int i = 1; i < record.pointCount; ++i)
+        {
+            const QPointF &start = points[record.firstPoint + i - 1];
+            const QPointF &end = points[record.firstPoint + i];
+            qreal distance = distanceToSegment(point, start, end) - halfWidth;
+            if (distance <= bestDistance)
+            {
+                bestDistance = distance;
+                best = index;
+            }
+        }
+    }
+    return best;
+}
+
+std::pair<int, int> EdgeLayerItem::edgeStations(int index) const
+{
+    if (index < 0 || index >= static_cast<int>(edges.size()))
+    {
+        return {0, 0};
+    }
+    return {edges[index].fromId, edges[index].toId};
+}
+
+void EdgeLayerItem::setLabelFont(const QFont &font)
+{
+    prepareGeometryChange();
+    labelFont = font;
+    totalBounds = QRectF();
+    for (auto &record : edges)
+    {
+        placeLabel(record);
+        QRectF edgeArea = record.bounds.united(record.labelRect.adjusted(-8.0, -5.0, 10.0, 7.0));
+        totalBounds = totalBounds.isNull() ? edgeArea : totalBounds.united(edgeArea);
+    }
+    gridDirty = true;
+}
+
+QRectF EdgeLayerItem::boundingRect() const
+{
+    return totalBounds;
+}
+
+bool EdgeLayerItem::contains(const QPointF &point) const
+{
+    return edgeAt(point) >= 0;
+}
+
+void EdgeLayerItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(widget);
+    if (edges.empty())
+    {
+        return;
+    }
+    QRectF exposed = option->exposedRect;
+    if (exposed.isNull() || exposed.contains(totalBounds))
+    {
+        for (int style = 0; style < kStyleCount; ++style)
+        {
+            visibleBuffer[style] = styleBatches[style];
+        }
+    }
+    else
+    {
+        collectVisible(exposed);
+    }
+
+    // Un solo drawLines por estilo: abiertas, cerradas y luego el árbol mínimo encima
+    for (int style = 0; style < kStyleCount; ++style)
+    {
+        if (visibleBuffer[style].empty())
+        {
+            continue;
+        }
+        lineBuffer.clear();
+        for (int index : visibleBuffer[style])
+        {
+            const EdgeRecord &record = edges[index];
+            for (int i = 1; i < record.pointCount; ++i)
+            {
+                lineBuffer.append(QLineF(points[record.firstPoint + i - 1], points[record.firstPoint + i]));
+            }
+        }
+        painter->setPen(penForStyle(static_cast<EdgeStyle>(style)));
+        painter->setBrush(Qt::NoBrush);
+        painter->drawLines(lineBuffer);
+    }
+
+    // Las etiquetas de peso solo se dibujan cuando el zoom permite leerlas
+    qreal levelOfDetail = QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+    if (levelOfDetail < kLabelMinLevelOfDetail)
+    {
+        return;
+    }
+    painter->setFont(labelFont);
+    for (int style = 0; style < kStyleCount; ++style)
+    {
+        if (visibleBuffer[style].empty())
+        {
+            continue;
+        }
+        EdgeStyle edgeStyle = static_cast<EdgeStyle>(style);
+        QColor background = labelBackgroundForStyle(edgeStyle);
+        QColor textColor = labelTextForStyle(edgeStyle);
+        for (int index : visibleBuffer[style])
+        {
+            const EdgeRecord &record = edges[index];
+            QRectF backgroundRect = record.labelRect.adjusted(-8.0, -5.0, 8.0, 5.0);
+            painter->setPen(Qt::NoPen);
+            painter->setBrush(QColor(0, 0, 0, 30));
+            painter->drawRoundedRect(backgroundRect.translated(2.0, 2.0), 6.0, 6.0);
+            painter->setPen(QPen(QColor(200, 200, 200, 100), 0.5));
+            painter->setBrush(background);
+            painter->drawRoundedRect(backgroundRect, 6.0, 6.0);
+            painter->setPen(textColor);
+            painter->drawText(record.labelRect, Qt::AlignCenter, record.labelText);
+        }
+    }
+}
+
+void EdgeLayerItem::hoverMoveEvent(QGraphicsSceneHoverEvent *event)
+{
+    int index = edgeAt(event->pos());
+    if (index < 0)
+    {
+        setToolTip(QString());
+    }
+    else
+    {
+        const EdgeRecord &record = edges[index];
+        setToolTip(QString("%1 ⇄ %2 : %3 minutos").arg(QString::number(record.fromId), QString::number(record.toId), QString::number(record.weight, 'f', 2)));
+    }
+    QGraphicsItem::hoverMoveEvent(event);
+}
+
+void EdgeLayerItem::rebuildGrid() const
+{
+    grid.clear();
+    visitStamp.assign(edges.size(), 0);
+    currentStamp = 0;
+    if (edges.empty() || totalBounds.isNull())
+    {
+        gridDirty = false;
+        return;
+    }
+    qreal area = totalBounds.width() * totalBounds.height();
+    cellSize = std::max(kMinCellSize, std::sqrt(area / static_cast<qreal>(edges.size())));
+    auto insertRect = [&](const QRectF &rect, int index) {
+        int x0 = static_cast<int>(std::floor(rect.left() / cellSize));
+        int x1 = static_cast<int>(std::floor(rect.right() / cellSize));
+        int y0 = static_cast<int>(std::floor(rect.top() / cellSize));
+        int y1 = static_cast<int>(std::floor(rect.bottom() / cellSize));
+        for (int cx = x0; cx <= x1; ++cx)
+        {
+            for (int cy = y0; cy <= y1; ++cy)
+            {
+                auto &bucket = grid[cellKey(cx, cy)];
+                if (bucket.empty() || bucket.back() != index)
+                {
+                    bucket.push_back(index);
+                }
+            }
+        }
+    };
+    for (size_t index = 0; index < edges.size(); ++index)
+    {
+        const EdgeRecord &record = edges[index];
+        qreal margin = penForStyle(record.style).widthF();
+        for (int i = 1; i < record.pointCount; ++i)
+        {
+            QRectF segmentRect = QRectF(points[record.firstPoint + i - 1], points[record.firstPoint + i]).normalized();
+            insertRect(segmentRect.adjusted(-margin, -margin, margin, margin), static_cast<int>(index));
+        }
+        insertRect(record.labelRect.adjusted(-8.0, -5.0, 8.0, 5.0), static_cast<int>(index));
+    }
+    gridDirty = false;
+}
+
+long long EdgeLayerItem::cellKey(int cx, int cy) const
+{
+    return (static_cast<long long>(cx) << 32) ^ static_cast<long long>(static_cast<unsigned int>(cy));
+}
+
+void EdgeLayerItem::collectEdges(const QRectF &rect, std::vector<int> &result) const
+{
+    result.clear();
+    if (gridDirty)
+    {
+        rebuildGrid();
+    }
+    if (grid.empty())
+    {
+        return;
+    }
+    QRectF area = rect.normalized();
+    if (!area.intersects(totalBounds))
+    {
+        return;
+    }
+    area = area.intersected(totalBounds);
+    if (++currentStamp == 0)
+    {
+        std::fill(visitStamp.begin(), visitStamp.end(), 0);
+        currentStamp = 1;
+    }
+    int x0 = static_cast<int>(std::floor(area.left() / cellSize));
+    int x1 = static_cast<int>(std::floor(area.right() / cellSize));
+    int y0 = static_cast<int>(std::floor(area.top() / cellSize));
+    int y1 = static_cast<int>(std::floor(area.bottom() / cellSize));
+    for (int cx = x0; cx <= x1; ++cx)
+    {
+        for (int cy = y0; cy <= y1; ++cy)
+        {
+            auto it = grid.find(cellKey(cx, cy));
+            if (it == grid.end())
+            {
+                continue;
+            }
+            for (int index : it->second)
+            {
+                if (visitStamp[index] == currentStamp)
+                {
+                    continue;
+                }
+                visitStamp[index] = currentStamp;
+                if (edges[index].bounds.intersects(area) || edges[index].labelRect.adjusted(-8.0, -5.0, 10.0, 7.0).intersects(area))
+                {
+                    result.push_back(index);
+                }
+            }
+        }
+    }
+}
+
+void EdgeLayerItem::collectVisible(const QRectF &rect) const
+{
+    for (auto &batch : visibleBuffer)
+    {
+        batch.clear();
+    }
+    std::vector<int> candidates;
+    collectEdges(rect, candidates);
+    std::sort(candidates.begin(), candidates.end());
+    for (int index : candidates)
+    {
+        visibleBuffer[static_cast<int>(edges[index].style)].push_back(index);
+    }
+}
+
+void EdgeLayerItem::placeLabel(EdgeRecord &record) const
+{
+    const QPointF *path = points.data() + record.firstPoint;
+    double totalLength = 0.0;
+    for (int i = 1; i < record.pointCount; ++i)
+    {
+        totalLength += QLineF(path[i - 1], path[i]).length();
+    }
+    QPointF mid = path[0];
+    QPointF direction(1.0, 0.0);
+    if (totalLength > 0.0)
+    {
+        double half = totalLength / 2.0;
+        double accumulated = 0.0;
+        for (int i = 1; i < record.pointCount; ++i)
+        {
+            double length = QLineF(path[i - 1], path[i]).length();
+            if (accumulated + length >= half)
+            {
+                double ratio = length > 0.0 ? (half - accumulated) / length : 0.0;
+                mid = path[i - 1] + (path[i] - path[i - 1]) * ratio;
+                direction = path[i] - path[i - 1];
+                break;
+            }
+            accumulated += length;
+        }
+    }
+    if (qFuzzyIsNull(direction.x()) && qFuzzyIsNull(direction.y()))
+    {
+        direction = path[record.pointCount - 1] - path[0];
+    }
+    double length = std::hypot(direction.x(), direction.y());
+    QPointF offset(0.0, 0.0);
+    if (length > 0.0)
+    {
+        offset = QPointF(-direction.y() / length, direction.x() / length) * kLabelOffset;
+    }
+    QFontMetricsF metrics(labelFont);
+    QSizeF textSize = metrics.size(Qt::TextSingleLine, record.labelText) + QSizeF(8.0, 8.0);
+    QPointF center = mid + offset;
+    record.labelRect = QRectF(center - QPointF(textSize.width() / 2.0, textSize.height() / 2.0), textSize);
+}
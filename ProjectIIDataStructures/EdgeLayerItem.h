@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QFont>
+#include <QGraphicsItem>
+#include <QLineF>
+#include <QPointF>
+#include <QRectF>
+#include <QString>
+#include <QVector>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class EdgeLayerItem : public QGraphicsItem
+{
+public:
+    enum class EdgeStyle
+    {
+        Open = 0,
+        Closed = 1,
+        Mst = 2
+    };
+
+    explicit EdgeLayerItem(QGraphicsItem *parent = nullptr);
+
+    void clearEdges();
+    void reserve(size_t edgeCount, size_t pointCount);
+    void addEdge(int fromId, int toId, double weight, EdgeStyle style, const std::vector<QPointF> &path);
+    int edgeCount() const;
+    int edgeAt(const QPointF &point, qreal tolerance = 6.0) const;
+    std::pair<int, int> edgeStations(int index) const;
+    void setLabelFont(const QFont &font);
+
+    QRectF boundingRect() const override;
+    bool contains(const QPointF &point) const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
+
+protected:
+    void hoverMoveEvent(QGraphicsSceneHoverEvent *event) override;
+
+private:
+    static constexpr int kStyleCount = 3;
+    struct EdgeRecord
+    {
+        int fromId;
+        int toId;
+        double weight;
+        EdgeStyle style;
+        int firstPoint;
+        int pointCount;
+        QRectF bounds;
+        QRectF labelRect;
+        QString labelText;
+    };
+    std::vector<EdgeRecord> edges;
+    std::vector<QPointF> points;
+    std::vector<int> styleBatches[kStyleCount];
+    QRectF totalBounds;
+    QFont labelFont;
+    mutable std::unordered_map<long long, std::vector<int>> grid;
+    mutable qreal cellSize;
+    mutable bool gridDirty;
+    mutable std::vector<unsigned int> visitStamp;
+    mutable unsigned int currentStamp;
+    mutable QVector<QLineF> lineBuffer;
+    mutable std::vector<int> visibleBuffer[kStyleCount];
+    void rebuildGrid() const;
+    long long cellKey(int cx, int cy) const;
+    void collectEdges(const QRectF &rect, std::vector<int> &result) const;
+    void collectVisible(const QRectF &rect) const;
+    void placeLabel(EdgeRecord &record) const;
+};
@@ -1,13 +1,125 @@
 #include "GraphNetwork.h"
+#include "AllPairsTable.h"
+#include "DisjointSets.h"
+#include "DynamicForest.h"
+#include "LandmarkTable.h"
+#include "QueryWorkspace.h"
+#include "SearchQueues.h"
+#include "ShortestPathTree.h"
+#include "ThreadPool.h"
+#include <QtAlgorithms>
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cmath>
 #include <limits>
+#include <mutex>
 #include <numeric>
-#include <queue>
-#include <stack>
+#include <set>
+
+namespace
+{
+std::atomic<quint64> graphVersionCounter(0);
+// Versiones hacia atrás desde las que todavía se puede reparar un resultado en caché
+constexpr size_t kMaxRepairSteps = 32;
+
+// El tramo from-to estaba en un camino mínimo de la fila: la distancia de un extremo es la del otro más el peso
+bool tightArc(double fromDistance, double toDistance, double weight)
+{
+    return std::isfinite(fromDistance) && std::isfinite(toDistance) &&
+           std::fabs(fromDistance + weight - toDistance) <= 1e-9 * std::max(1.0, toDistance);
+}
+
+// Debajo de este tamaño Filter-Kruskal ordena directamente; por encima de kParallelEdges reparte entre hilos
+constexpr size_t kKruskalBase = 1024;
+constexpr size_t kParallelEdges = 1 << 14;
+
+// Umbrales de hopCounts: se pasa a recorrer de abajo hacia arriba cuando los tramos de la frontera superan
+// 1/kBottomUpRatio de los que quedan sin explorar, y se vuelve cuando la frontera baja de 1/kTopDownRatio de las estaciones.
+// Beamer usa 14 para redes sociales; en una red de transporte el diámetro es grande, casi ninguna estación sin visitar
+// toca la frontera y el recorrido de abajo hacia arriba solo conviene con fronteras mucho más anchas
+constexpr long long kBottomUpRatio = 2;
+constexpr int kTopDownRatio = 24;
+
+quint64 bitOf(int index)
+{
+    return quint64(1) << (index % 64);
+}
+
+// Orden total de los tramos: a igual peso decide el par de índices, así el bosque mínimo es único
+template <typename Edge>
+bool lighter(const Edge &a, const Edge &b)
+{
+    if (a.weight != b.weight)
+    {
+        return a.weight < b.weight;
+    }
+    return a.from != b.from ? a.from < b.from : a.to < b.to;
+}
+
+// Pasa al frente de [begin, end) los tramos que cumplen keep y devuelve dónde empieza el resto. Con pool cada bloque
+// cuenta los suyos, una suma de prefijos da las posiciones y cada bloque copia a scratch sin coordinarse con los demás
+template <typename Edge, typename Keep>
+size_t splitEdges(std::vector<Edge> &edges, std::vector<Edge> &scratch, size_t begin, size_t end, const Keep &keep, ThreadPool *pool)
+{
+    if (!pool || pool->size() <= 1 || end - begin < kParallelEdges)
+    {
+        return std::partition(edges.begin() + begin, edges.begin() + end, keep) - edges.begin();
+    }
+    int blocks = pool->size() * 4;
+    size_t blockSize = (end - begin + blocks - 1) / blocks;
+    std::vector<size_t> kept(blocks + 1, 0);
+    pool->parallelFor(blocks, [&](int first, int last) {
+        for (int block = first; block < last; ++block)
+        {
+            size_t from = begin + block * blockSize;
+            size_t to = std::min(end, from + blockSize);
+            for (size_t i = from; i < to; ++i)
+            {
+                kept[block + 1] += keep(edges[i]) ? 1 : 0;
+            }
+        }
+    });
+    std::partial_sum(kept.begin(), kept.end(), kept.begin());
+    size_t middle = begin + kept[blocks];
+    pool->parallelFor(blocks, [&](int first, int last) {
+        for (int block = first; block < last; ++block)
+        {
+            size_t from = std::min(end, begin + block * blockSize);
+            size_t to = std::min(end, from + blockSize);
+            size_t front = begin + kept[block];
+            size_t back = middle + (from - begin) - kept[block];
+            for (size_t i = from; i < to; ++i)
+            {
+                scratch[keep(edges[i]) ? front++ : back++] = edges[i];
+            }
+        }
+    });
+    pool->parallelFor(blocks, [&](int first, int last) {
+        size_t from = std::min(end, begin + first * blockSize);
+        size_t to = std::min(end, begin + last * blockSize);
+        std::copy(scratch.begin() + from, scratch.begin() + to, edges.begin() + from);
+    });
+    return middle;
+}
+}
 
 GraphNetwork::GraphNetwork()
+    : indexById(std::make_shared<const std::unordered_map<int, int>>()), version(++graphVersionCounter), routesVersion(version),
+      treeCache(std::make_shared<ShortestPathTreeCache>()), tableCache(std::make_shared<AllPairsCache>()),
+      forestCache(std::make_shared<SpanningForestCache>())
+{
+}
+
+template <typename T>
+std::vector<T> &GraphNetwork::writableRow(std::vector<std::shared_ptr<std::vector<T>>> &rows, size_t index)
 {
+    // Copia al escribir: una fila compartida con otra versión del grafo se duplica antes de modificarla
+    if (rows[index].use_count() > 1)
+    {
+        rows[index] = std::make_shared<std::vector<T>>(*rows[index]);
+    }
+    return *rows[index];
 }
 
 bool GraphNetwork::addStation(const Station &station)
@@ -31,15 +143,22 @@ bool GraphNetwork::removeStation(int id)
     }
     stationList.erase(stationList.begin() + index);
     baseMatrix.erase(baseMatrix.begin() + index);
-    matrix.erase(matrix.begin() + index);
-    for (auto &row : baseMatrix)
-    {
-        row.erase(row.begin() + index);
-    }
-    for (auto &row : matrix)
+    baseAdjacency.erase(baseAdjacency.begin() + index);
+    for (size_t i = 0; i < baseMatrix.size(); ++i)
     {
+        auto &row = writableRow(baseMatrix, i);
         row.erase(row.begin() + index);
+        auto &arcs = writableRow(baseAdjacency, i);
+        arcs.erase(std::remove_if(arcs.begin(), arcs.end(), [index](const Arc &arc) { return arc.target == index; }), arcs.end());
+        for (auto &arc : arcs)
+        {
+            if (arc.target > index)
+            {
+                --arc.target;
+            }
+        }
     }
+    // rebuildIndices vuelve a derivar la matriz con cierres a partir de la base
     rebuildIndices();
     return true;
 }
@@ -56,10 +175,17 @@ bool GraphNetwork::addConnection(int fromId, int toId, double weight)
     {
         return false;
     }
-    baseMatrix[fromIndex][toIndex] = weight;
-    baseMatrix[toIndex][fromIndex] = weight;
-    matrix[fromIndex][toIndex] = weight;
-    matrix[toIndex][fromIndex] = weight;
+    ArcChange change{std::min(fromIndex, toIndex), std::max(fromIndex, toIndex), (*matrix[fromIndex])[toIndex]};
+    writableRow(baseMatrix, fromIndex)[toIndex] = weight;
+    writableRow(baseMatrix, toIndex)[fromIndex] = weight;
+    writableRow(matrix, fromIndex)[toIndex] = weight;
+    writableRow(matrix, toIndex)[fromIndex] = weight;
+    setArc(baseAdjacency, fromIndex, toIndex, weight);
+    setArc(baseAdjacency, toIndex, fromIndex, weight);
+    setArc(adjacency, fromIndex, toIndex, weight);
+    setArc(adjacency, toIndex, fromIndex, weight);
+    touchArcs({change});
+    routesVersion = version;
     return true;
 }
 
@@ -72,16 +198,24 @@ bool GraphNetwork::removeConnection(int fromId, int toId)
         return false;
     }
     double inf = std::numeric_limits<double>::infinity();
-    baseMatrix[fromIndex][toIndex] = inf;
-    baseMatrix[toIndex][fromIndex] = inf;
-    matrix[fromIndex][toIndex] = inf;
-    matrix[toIndex][fromIndex] = inf;
+    ArcChange change{std::min(fromIndex, toIndex), std::max(fromIndex, toIndex), (*matrix[fromIndex])[toIndex]};
+    writableRow(baseMatrix, fromIndex)[toIndex] = inf;
+    writableRow(baseMatrix, toIndex)[fromIndex] = inf;
+    writableRow(matrix, fromIndex)[toIndex] = inf;
+    writableRow(matrix, toIndex)[fromIndex] = inf;
+    setArc(baseAdjacency, fromIndex, toIndex, inf);
+    setArc(baseAdjacency, toIndex, fromIndex, inf);
+    setArc(adjacency, fromIndex, toIndex, inf);
+    setArc(adjacency, toIndex, fromIndex, inf);
+    // La diagonal no interviene en los caminos
+    touchArcs(fromIndex == toIndex ? std::vector<ArcChange>() : std::vector<ArcChange>{change});
+    routesVersion = version;
     return true;
 }
 
 bool GraphNetwork::hasStation(int id) const
 {
-    return indexById.find(id) != indexById.end();
+    return indexById->find(id) != indexById->end();
 }
 
 std::vector<Station> GraphNetwork::getStations() const
@@ -94,17 +228,37 @@ std::vector<GraphEdge> GraphNetwork::getConnections() const
     std::vector<GraphEdge> edges;
     for (size_t i = 0; i < baseMatrix.size(); ++i)
     {
-        for (size_t j = i + 1; j < baseMatrix.size(); ++j)
+        const auto &row = *baseMatrix[i];
+        for (size_t j = i + 1; j < row.size(); ++j)
         {
-            if (std::isfinite(baseMatrix[i][j]))
+            if (std::isfinite(row[j]))
             {
-                edges.push_back({stationList[i].getId(), stationList[j].getId(), baseMatrix[i][j]});
+                edges.push_back({stationList[i].getId(), stationList[j].getId(), row[j]});
             }
         }
     }
     return edges;
 }
 
+std::vector<GraphEdge> GraphNetwork::getConnectionsOf(int id) const
+{
+    std::vector<GraphEdge> edges;
+    int index = indexOf(id);
+    if (index < 0)
+    {
+        return edges;
+    }
+    const auto &row = *baseMatrix[index];
+    for (size_t j = 0; j < row.size(); ++j)
+    {
+        if (static_cast<int>(j) != index && std::isfinite(row[j]))
+        {
+            edges.push_back({id, stationList[j].getId(), row[j]});
+        }
+    }
+    return edges;
+}
+
 std::vector<std::pair<int, int>> GraphNetwork::getClosures() const
 {
     return activeClosures;
@@ -112,366 +266,1844 @@ std::vector<std::pair<int, int>> GraphNetwork::getClosures() const
 
 void GraphNetwork::applyClosures(const std::vector<std::pair<int, int>> &closures)
 {
-    activeClosures = closures;
-    matrix = baseMatrix;
-    double inf = std::numeric_limits<double>::infinity();
-    for (size_t i = 0; i < matrix.size(); ++i)
+    // Solo cambian los tramos cerrados antes o ahora; se anota su peso previo para reparar los resultados en caché
+    std::vector<ArcChange> changes;
+    const std::vector<std::pair<int, int>> *lists[] = {&activeClosures, &closures};
+    for (const auto *list : lists)
     {
-        for (size_t j = 0; j < matrix.size(); ++j)
+        for (const auto &closure : *list)
         {
-            if (i == j)
+            int fromIndex = indexOf(closure.first);
+            int toIndex = indexOf(closure.second);
+            if (fromIndex >= 0 && toIndex >= 0 && fromIndex != toIndex)
             {
-                matrix[i][j] = 0;
+                changes.push_back({std::min(fromIndex, toIndex), std::max(fromIndex, toIndex), (*matrix[fromIndex])[toIndex]});
             }
         }
     }
-    for (const auto &closure : closures)
+    activeClosures = closures;
+    deriveClosures();
+    changes.erase(std::remove_if(changes.begin(), changes.end(),
+                                 [this](const ArcChange &change) { return (*matrix[change.from])[change.to] == change.before; }),
+                  changes.end());
+    touchArcs(std::move(changes));
+}
+
+void GraphNetwork::deriveClosures()
+{
+    // Las filas se comparten con la matriz base; solo se copian las que tienen un tramo cerrado
+    matrix = baseMatrix;
+    adjacency = baseAdjacency;
+    double inf = std::numeric_limits<double>::infinity();
+    for (const auto &closure : activeClosures)
     {
         int fromIndex = indexOf(closure.first);
         int toIndex = indexOf(closure.second);
         if (fromIndex >= 0 && toIndex >= 0)
         {
-            matrix[fromIndex][toIndex] = inf;
-            matrix[toIndex][fromIndex] = inf;
+            writableRow(matrix, fromIndex)[toIndex] = inf;
+            writableRow(matrix, toIndex)[fromIndex] = inf;
+            setArc(adjacency, fromIndex, toIndex, inf);
+            setArc(adjacency, toIndex, fromIndex, inf);
         }
     }
 }
 
 std::vector<int> GraphNetwork::bfs(int startId) const
 {
+    return bfs(startId, QueryOptions()).stations;
+}
+
+TraversalDetail GraphNetwork::bfs(int startId, const QueryOptions &options) const
+{
+    TraversalDetail result;
+    bfs(startId, options, result);
+    return result;
+}
+
+void GraphNetwork::bfs(int startId, const QueryOptions &options, TraversalDetail &result) const
+{
+    result.stations.clear();
+    result.status = QueryStatus::Completed;
     int startIndex = indexOf(startId);
     if (startIndex < 0)
     {
-        return {};
+        return;
     }
-    std::vector<int> visitedOrder;
-    std::vector<bool> visited(matrix.size(), false);
-    std::queue<int> pending;
-    visited[startIndex] = true;
-    pending.push(startIndex);
-    while (!pending.empty())
+    int total = static_cast<int>(matrix.size());
+    QueryWorkspace::Lease workspace = QueryWorkspace::acquire();
+    workspace->prepare(matrix.size());
+    // frontier hace de cola: head avanza en lugar de sacar elementos
+    std::vector<int> &pending = workspace->frontier;
+    workspace->reach(startIndex, 0, -1);
+    pending.push_back(startIndex);
+    for (size_t head = 0; head < pending.size(); ++head)
     {
-        int index = pending.front();
-        pending.pop();
-        visitedOrder.push_back(stationList[index].getId());
-        for (size_t neighbor = 0; neighbor < matrix.size(); ++neighbor)
+        result.status = options.limitStatus(static_cast<int>(result.stations.size()));
+        if (result.status != QueryStatus::Completed)
+        {
+            return;
+        }
+        int index = pending[head];
+        result.stations.push_back(stationList[index].getId());
+        options.report(static_cast<int>(result.stations.size()), total);
+        // La lista de adyacencia va en el mismo orden que las columnas de la matriz, sin los tramos cerrados
+        for (const Arc &arc : *adjacency[index])
         {
-            if (std::isfinite(matrix[index][neighbor]) && !visited[neighbor] && index != static_cast<int>(neighbor))
+            if (!workspace->isReached(arc.target))
             {
-                visited[neighbor] = true;
-                pending.push(static_cast<int>(neighbor));
+                workspace->reach(arc.target, 0, index);
+                pending.push_back(arc.target);
             }
         }
     }
-    return visitedOrder;
 }
 
 std::vector<int> GraphNetwork::dfs(int startId) const
 {
+    return dfs(startId, QueryOptions()).stations;
+}
+
+TraversalDetail GraphNetwork::dfs(int startId, const QueryOptions &options) const
+{
+    TraversalDetail result;
+    dfs(startId, options, result);
+    return result;
+}
+
+void GraphNetwork::dfs(int startId, const QueryOptions &options, TraversalDetail &result) const
+{
+    result.stations.clear();
+    result.status = QueryStatus::Completed;
     int startIndex = indexOf(startId);
     if (startIndex < 0)
     {
-        return {};
+        return;
     }
-    std::vector<int> visitedOrder;
-    std::vector<bool> visited(matrix.size(), false);
-    std::stack<int> pending;
-    pending.push(startIndex);
+    int total = static_cast<int>(matrix.size());
+    QueryWorkspace::Lease workspace = QueryWorkspace::acquire();
+    workspace->prepare(matrix.size());
+    std::vector<int> &pending = workspace->frontier;
+    pending.push_back(startIndex);
     while (!pending.empty())
     {
-        int index = pending.top();
-        pending.pop();
-        if (visited[index])
+        int index = pending.back();
+        pending.pop_back();
+        if (workspace->isSettled(index))
         {
             continue;
         }
-        visited[index] = true;
-        visitedOrder.push_back(stationList[index].getId());
-        for (int neighbor = static_cast<int>(matrix.size()) - 1; neighbor >= 0; --neighbor)
+        result.status = options.limitStatus(static_cast<int>(result.stations.size()));
+        if (result.status != QueryStatus::Completed)
+        {
+            return;
+        }
+        workspace->settle(index);
+        result.stations.push_back(stationList[index].getId());
+        options.report(static_cast<int>(result.stations.size()), total);
+        const auto &row = *matrix[index];
+        for (int neighbor = static_cast<int>(row.size()) - 1; neighbor >= 0; --neighbor)
         {
-            if (std::isfinite(matrix[index][neighbor]) && !visited[neighbor] && index != neighbor)
+            if (std::isfinite(row[neighbor]) && !workspace->isSettled(neighbor) && index != neighbor)
             {
-                pending.push(neighbor);
+                pending.push_back(neighbor);
             }
         }
     }
-    return visitedOrder;
 }
 
-PathDetail GraphNetwork::dijkstra(int startId, int endId) const
+PathDetail GraphNetwork::dijkstra(int startId, int endId, const QueryOptions &options) const
+{
+    PathDetail result;
+    dijkstra(startId, endId, options, result);
+    return result;
+}
+
+void GraphNetwork::dijkstra(int startId, int endId, const QueryOptions &options, PathDetail &result) const
+{
+    dijkstraWith<IndexedDaryHeap<4>>(startId, endId, options, result);
+}
+
+template <typename Queue>
+void GraphNetwork::dijkstraWith(int startId, int endId, const QueryOptions &options, PathDetail &result) const
 {
+    result.stations.clear();
+    result.total = std::numeric_limits<double>::infinity();
+    result.status = QueryStatus::Completed;
     int startIndex = indexOf(startId);
     int endIndex = indexOf(endId);
     if (startIndex < 0 || endIndex < 0)
     {
-        return {{}, std::numeric_limits<double>::infinity()};
+        return;
     }
-    size_t size = matrix.size();
-    std::vector<double> distances(size, std::numeric_limits<double>::infinity());
-    std::vector<int> previous(size, -1);
-    distances[startIndex] = 0;
-    using Node = std::pair<double, int>;
-    std::priority_queue<Node, std::vector<Node>, std::greater<Node>> queue;
-    queue.push({0, startIndex});
+    size_t size = adjacency.size();
+    QueryWorkspace::Lease workspace = QueryWorkspace::acquire();
+    workspace->prepare(size);
+    Queue queue(*workspace);
+    queue.update(startIndex, 0);
+    workspace->reach(startIndex, 0, -1);
+    int settled = 0;
     while (!queue.empty())
     {
-        auto [dist, index] = queue.top();
-        queue.pop();
-        if (dist > distances[index])
+        auto [dist, index] = queue.pop();
+        if (dist > workspace->distance(index))
         {
             continue;
         }
+        result.status = options.limitStatus(settled);
+        if (result.status != QueryStatus::Completed)
+        {
+            break;
+        }
+        options.report(++settled, static_cast<int>(size));
         if (index == endIndex)
         {
             break;
         }
-        for (size_t neighbor = 0; neighbor < size; ++neighbor)
+        for (const Arc &arc : *adjacency[index])
         {
-            double weight = matrix[index][neighbor];
-            if (!std::isfinite(weight) || index == static_cast<int>(neighbor))
+            double tentative = dist + arc.weight;
+            if (tentative < workspace->distance(arc.target))
             {
-                continue;
-            }
-            double tentative = dist + weight;
-            if (tentative < distances[neighbor])
-            {
-                distances[neighbor] = tentative;
-                previous[neighbor] = index;
-                queue.push({tentative, static_cast<int>(neighbor)});
+                queue.update(arc.target, tentative);
+                workspace->reach(arc.target, tentative, index);
             }
         }
     }
-    if (!std::isfinite(distances[endIndex]))
+    // Si se detuvo antes de tiempo, la distancia tentativa al destino es una cota superior con un camino válido
+    if (!workspace->isReached(endIndex))
     {
-        return {{}, std::numeric_limits<double>::infinity()};
+        return;
     }
-    std::vector<int> path;
-    for (int current = endIndex; current != -1; current = previous[current])
+    for (int current = endIndex; current != -1; current = workspace->parent(current))
     {
-        path.push_back(stationList[current].getId());
+        result.stations.push_back(stationList[current].getId());
     }
-    std::reverse(path.begin(), path.end());
-    return {path, distances[endIndex]};
+    std::reverse(result.stations.begin(), result.stations.end());
+    result.total = workspace->distance(endIndex);
 }
 
-PathDetail GraphNetwork::floydWarshall(int startId, int endId) const
+template void GraphNetwork::dijkstraWith<LazyBinaryHeap>(int, int, const QueryOptions &, PathDetail &) const;
+template void GraphNetwork::dijkstraWith<IndexedDaryHeap<2>>(int, int, const QueryOptions &, PathDetail &) const;
+template void GraphNetwork::dijkstraWith<IndexedDaryHeap<4>>(int, int, const QueryOptions &, PathDetail &) const;
+template void GraphNetwork::dijkstraWith<RadixHeap>(int, int, const QueryOptions &, PathDetail &) const;
+
+DistanceTable GraphNetwork::distanceTable(const std::vector<int> &sources, const std::vector<int> &targets, const QueryOptions &options,
+                                          ThreadPool *pool) const
 {
-    int startIndex = indexOf(startId);
-    int endIndex = indexOf(endId);
-    if (startIndex < 0 || endIndex < 0)
+    DistanceTable table;
+    table.sources = sources;
+    table.targets = targets;
+    table.distances.assign(sources.size() * targets.size(), std::numeric_limits<double>::infinity());
+    // targetMark[v] != 0 indica que v es destino; targetCount cuenta destinos distintos para cortar la búsqueda
+    std::vector<int> targetColumns(targets.size(), -1);
+    std::vector<int> targetMark(adjacency.size(), 0);
+    int targetCount = 0;
+    for (size_t column = 0; column < targets.size(); ++column)
     {
-        return {{}, std::numeric_limits<double>::infinity()};
+        int index = indexOf(targets[column]);
+        targetColumns[column] = index;
+        if (index >= 0 && targetMark[index] == 0)
+        {
+            targetMark[index] = 1;
+            ++targetCount;
+        }
     }
-    size_t size = matrix.size();
-    std::vector<std::vector<double>> dist = matrix;
-    std::vector<std::vector<int>> next(size, std::vector<int>(size, -1));
-    for (size_t i = 0; i < size; ++i)
-    {
-        for (size_t j = 0; j < size; ++j)
+    std::mutex statusLock;
+    int completedSources = 0;
+    auto runSources = [&](int begin, int end) {
+        for (int row = begin; row < end; ++row)
         {
-            if (std::isfinite(dist[i][j]) && i != j)
+            int sourceIndex = indexOf(sources[row]);
+            QueryStatus status = QueryStatus::Completed;
+            if (sourceIndex >= 0 && targetCount > 0)
             {
-                next[i][j] = static_cast<int>(j);
+                double *out = table.distances.data() + row * targets.size();
+                status = settleTargets(sourceIndex, targetMark, targetCount, targetColumns, options, out);
             }
+            std::lock_guard<std::mutex> lock(statusLock);
+            if (status != QueryStatus::Completed && table.status == QueryStatus::Completed)
+            {
+                table.status = status;
+            }
+            options.report(++completedSources, static_cast<int>(sources.size()));
         }
-        dist[i][i] = 0;
-        next[i][i] = static_cast<int>(i);
+    };
+    if (pool && pool->size() > 1 && sources.size() > 1)
+    {
+        pool->parallelFor(static_cast<int>(sources.size()), runSources);
     }
-    for (size_t k = 0; k < size; ++k)
+    else
     {
-        for (size_t i = 0; i < size; ++i)
+        runSources(0, static_cast<int>(sources.size()));
+    }
+    return table;
+}
+
+QueryStatus GraphNetwork::settleTargets(int sourceIndex, const std::vector<int> &targetMark, int targetCount,
+                                        const std::vector<int> &targetColumns, const QueryOptions &options, double *row) const
+{
+    QueryWorkspace::Lease workspace = QueryWorkspace::acquire();
+    workspace->prepare(adjacency.size());
+    IndexedDaryHeap<4> queue(*workspace);
+    queue.update(sourceIndex, 0);
+    workspace->reach(sourceIndex, 0, -1);
+    int settled = 0;
+    int remaining = targetCount;
+    QueryStatus status = QueryStatus::Completed;
+    while (!queue.empty() && remaining > 0)
+    {
+        auto [dist, index] = queue.pop();
+        // El límite de asentados es por búsqueda; la cancelación y el plazo son comunes a toda la tabla
+        status = options.limitStatus(settled);
+        if (status != QueryStatus::Completed)
         {
-            for (size_t j = 0; j < size; ++j)
+            break;
+        }
+        ++settled;
+        workspace->settle(index);
+        if (targetMark[index] != 0)
+        {
+            --remaining;
+        }
+        for (const Arc &arc : *adjacency[index])
+        {
+            double tentative = dist + arc.weight;
+            if (tentative < workspace->distance(arc.target))
             {
-                if (!std::isfinite(dist[i][k]) || !std::isfinite(dist[k][j]))
-                {
-                    continue;
-                }
-                double candidate = dist[i][k] + dist[k][j];
-                if (candidate < dist[i][j])
-                {
-                    dist[i][j] = candidate;
-                    next[i][j] = next[i][k];
-                }
+                queue.update(arc.target, tentative);
+                workspace->reach(arc.target, tentative, index);
             }
         }
     }
-    if (next[startIndex][endIndex] == -1)
-    {
-        return {{}, std::numeric_limits<double>::infinity()};
-    }
-    std::vector<int> path;
-    int current = startIndex;
-    path.push_back(stationList[current].getId());
-    while (current != endIndex)
+    // Solo se informan distancias definitivas; un destino sin asentar queda en infinito
+    for (size_t column = 0; column < targetColumns.size(); ++column)
     {
-        current = next[current][endIndex];
-        if (current == -1)
+        int index = targetColumns[column];
+        if (index >= 0 && workspace->isSettled(index))
         {
-            return {{}, std::numeric_limits<double>::infinity()};
+            row[column] = workspace->distance(index);
         }
-        path.push_back(stationList[current].getId());
     }
-    return {path, dist[startIndex][endIndex]};
+    return status;
 }
 
-TreeDetail GraphNetwork::prim() const
+HopTable GraphNetwork::hopCounts(int startId, const QueryOptions &options) const
 {
-    size_t size = matrix.size();
-    if (size == 0)
+    HopTable table = emptyHopTable({startId});
+    int startIndex = indexOf(startId);
+    if (startIndex < 0)
     {
-        return {{}, 0};
+        return table;
     }
-    std::vector<double> key(size, std::numeric_limits<double>::infinity());
-    std::vector<int> parent(size, -1);
-    std::vector<bool> inMst(size, false);
-    key[0] = 0;
-    for (size_t count = 0; count < size - 1; ++count)
+    int total = static_cast<int>(adjacency.size());
+    size_t words = (adjacency.size() + 63) / 64;
+    std::vector<quint64> visited(words, 0);
+    std::vector<quint64> frontier(words, 0);
+    std::vector<quint64> next(words, 0);
+    std::vector<int> queue{startIndex};
+    std::vector<int> nextQueue;
+    auto degree = [this](int index) { return static_cast<long long>(adjacency[index]->size()); };
+    long long unexploredArcs = 0;
+    for (const ArcRow &row : adjacency)
     {
-        double minValue = std::numeric_limits<double>::infinity();
-        int u = -1;
-        for (size_t i = 0; i < size; ++i)
+        unexploredArcs += static_cast<long long>(row->size());
+    }
+    int *hops = table.hops.data();
+    hops[startIndex] = 0;
+    visited[startIndex / 64] |= bitOf(startIndex);
+    unexploredArcs -= degree(startIndex);
+    long long frontierArcs = degree(startIndex);
+    int frontierSize = 1;
+    int reached = 1;
+    bool bottomUp = false;
+    for (int level = 1; frontierSize > 0; ++level)
+    {
+        table.status = options.limitStatus(reached);
+        if (table.status != QueryStatus::Completed)
         {
-            if (!inMst[i] && key[i] < minValue)
+            break;
+        }
+        // La frontera es una lista de arriba hacia abajo y un mapa de bits de abajo hacia arriba; se convierte al cambiar
+        if (!bottomUp && frontierArcs * kBottomUpRatio > unexploredArcs)
+        {
+            bottomUp = true;
+            std::fill(frontier.begin(), frontier.end(), 0);
+            for (int index : queue)
             {
-                minValue = key[i];
-                u = static_cast<int>(i);
+                frontier[index / 64] |= bitOf(index);
             }
         }
-        if (u == -1)
+        else if (bottomUp && frontierSize * kTopDownRatio < total)
         {
-            break;
+            bottomUp = false;
+            queue.clear();
+            for (size_t word = 0; word < words; ++word)
+            {
+                for (quint64 bits = frontier[word]; bits != 0; bits &= bits - 1)
+                {
+                    queue.push_back(static_cast<int>(word * 64 + qCountTrailingZeroBits(bits)));
+                }
+            }
         }
-        inMst[u] = true;
-        for (size_t v = 0; v < size; ++v)
+        int found = 0;
+        frontierArcs = 0;
+        if (bottomUp)
         {
-            double weight = matrix[u][v];
-            if (std::isfinite(weight) && !inMst[v] && weight < key[v] && u != static_cast<int>(v))
+            std::fill(next.begin(), next.end(), 0);
+            for (size_t word = 0; word < words; ++word)
+            {
+                quint64 pending = ~visited[word];
+                if (word + 1 == words && total % 64 != 0)
+                {
+                    pending &= bitOf(total) - 1;
+                }
+                for (; pending != 0; pending &= pending - 1)
+                {
+                    int index = static_cast<int>(word * 64 + qCountTrailingZeroBits(pending));
+                    for (const Arc &arc : *adjacency[index])
+                    {
+                        if (frontier[arc.target / 64] & bitOf(arc.target))
+                        {
+                            next[word] |= bitOf(index);
+                            hops[index] = level;
+                            frontierArcs += degree(index);
+                            ++found;
+                            break;
+                        }
+                    }
+                }
+            }
+            for (size_t word = 0; word < words; ++word)
             {
-                key[v] = weight;
-                parent[v] = u;
+                visited[word] |= next[word];
             }
+            frontier.swap(next);
         }
-    }
-    TreeDetail result;
-    result.total = 0;
-    for (size_t i = 1; i < size; ++i)
-    {
-        if (parent[i] != -1 && std::isfinite(matrix[i][parent[i]]))
+        else
         {
-            result.edges.push_back({stationList[parent[i]].getId(), stationList[i].getId(), matrix[i][parent[i]]});
-            result.total += matrix[i][parent[i]];
+            nextQueue.clear();
+            for (int index : queue)
+            {
+                for (const Arc &arc : *adjacency[index])
+                {
+                    if (!(visited[arc.target / 64] & bitOf(arc.target)))
+                    {
+                        visited[arc.target / 64] |= bitOf(arc.target);
+                        hops[arc.target] = level;
+                        frontierArcs += degree(arc.target);
+                        nextQueue.push_back(arc.target);
+                    }
+                }
+            }
+            found = static_cast<int>(nextQueue.size());
+            queue.swap(nextQueue);
         }
+        unexploredArcs -= frontierArcs;
+        frontierSize = found;
+        reached += found;
+        options.report(reached, total);
     }
-    return result;
+    table.reached[0] = reached;
+    return table;
 }
 
-TreeDetail GraphNetwork::kruskal() const
+HopTable GraphNetwork::hopCounts(const std::vector<int> &sources, const QueryOptions &options, ThreadPool *pool) const
 {
-    size_t size = matrix.size();
-    std::vector<GraphEdge> edges;
-    for (size_t i = 0; i < size; ++i)
-    {
-        for (size_t j = i + 1; j < size; ++j)
+    HopTable table = emptyHopTable(sources);
+    int batches = static_cast<int>((sources.size() + kHopBatch - 1) / kHopBatch);
+    std::mutex statusLock;
+    int completedSources = 0;
+    auto runBatches = [&](int begin, int end) {
+        for (int batch = begin; batch < end; ++batch)
         {
-            if (std::isfinite(matrix[i][j]))
+            int first = batch * kHopBatch;
+            int last = std::min(first + kHopBatch, static_cast<int>(sources.size()));
+            // Cada lote escribe solo sus filas de hops y reached
+            QueryStatus status = hopBatch(table, first, last, options);
+            std::lock_guard<std::mutex> lock(statusLock);
+            if (status != QueryStatus::Completed && table.status == QueryStatus::Completed)
             {
-                edges.push_back({stationList[i].getId(), stationList[j].getId(), matrix[i][j]});
+                table.status = status;
             }
+            completedSources += last - first;
+            options.report(completedSources, static_cast<int>(sources.size()));
         }
+    };
+    if (pool && pool->size() > 1 && batches > 1)
+    {
+        pool->parallelFor(batches, runBatches);
+    }
+    else
+    {
+        runBatches(0, batches);
+    }
+    return table;
+}
+
+HopTable GraphNetwork::emptyHopTable(const std::vector<int> &sources) const
+{
+    HopTable table;
+    table.sources = sources;
+    table.stations.reserve(stationList.size());
+    for (const Station &station : stationList)
+    {
+        table.stations.push_back(station.getId());
     }
-    std::sort(edges.begin(), edges.end(), [](const GraphEdge &a, const GraphEdge &b) { return a.weight < b.weight; });
-    std::vector<int> parent(size);
-    std::vector<int> rank(size, 0);
-    std::iota(parent.begin(), parent.end(), 0);
-    auto findSet = [&](auto self, int v) -> int
+    table.hops.assign(sources.size() * stationList.size(), -1);
+    table.reached.assign(sources.size(), 0);
+    return table;
+}
+
+QueryStatus GraphNetwork::hopBatch(HopTable &table, int first, int last, const QueryOptions &options) const
+{
+    // Bit slot del lote = origen first + slot; seen son los orígenes que ya llegaron a cada estación y visit los que
+    // llegaron en el último nivel
+    constexpr int kWords = kHopBatch / 64;
+    using Bits = std::array<quint64, kWords>;
+    size_t total = adjacency.size();
+    std::vector<Bits> seen(total, Bits{});
+    std::vector<Bits> visit(total, Bits{});
+    std::vector<Bits> next(total, Bits{});
+    Bits everyone{};
+    std::vector<int> active;
+    std::vector<int> nextActive;
+    for (int row = first; row < last; ++row)
     {
-        if (parent[v] == v)
+        int index = indexOf(table.sources[row]);
+        if (index < 0)
         {
-            return v;
+            continue;
         }
-        parent[v] = self(self, parent[v]);
-        return parent[v];
-    };
-    auto unionSet = [&](int a, int b)
+        int slot = row - first;
+        everyone[slot / 64] |= bitOf(slot);
+        if (visit[index] == Bits{})
+        {
+            active.push_back(index);
+        }
+        seen[index][slot / 64] |= bitOf(slot);
+        visit[index][slot / 64] |= bitOf(slot);
+        table.hops[row * total + index] = 0;
+        table.reached[row] = 1;
+    }
+    auto degree = [this](int index) { return static_cast<long long>(adjacency[index]->size()); };
+    // Tramos de las estaciones que aún no vieron todos los orígenes: el costo de un nivel de abajo hacia arriba
+    long long pendingArcs = 0;
+    for (size_t index = 0; index < total; ++index)
     {
-        int rootA = findSet(findSet, a);
-        int rootB = findSet(findSet, b);
-        if (rootA == rootB)
+        if (seen[index] != everyone)
         {
-            return false;
+            pendingArcs += degree(static_cast<int>(index));
+        }
+    }
+    int touched = static_cast<int>(active.size());
+    auto discover = [&](int index, const Bits &found) {
+        if (seen[index] == Bits{})
+        {
+            ++touched;
+        }
+        if (next[index] == Bits{})
+        {
+            nextActive.push_back(index);
         }
-        if (rank[rootA] < rank[rootB])
+        for (int word = 0; word < kWords; ++word)
         {
-            std::swap(rootA, rootB);
+            next[index][word] |= found[word];
+            seen[index][word] |= found[word];
         }
-        parent[rootB] = rootA;
-        if (rank[rootA] == rank[rootB])
+        if (seen[index] == everyone)
         {
-            rank[rootA]++;
+            pendingArcs -= degree(index);
         }
-        return true;
     };
-    TreeDetail result;
-    result.total = 0;
-    for (const auto &edge : edges)
+    for (int level = 1; !active.empty(); ++level)
     {
-        int fromIndex = indexOf(edge.from);
-        int toIndex = indexOf(edge.to);
-        if (unionSet(fromIndex, toIndex))
+        QueryStatus status = options.limitStatus(touched);
+        if (status != QueryStatus::Completed)
+        {
+            return status;
+        }
+        long long activeArcs = 0;
+        for (int index : active)
+        {
+            activeArcs += degree(index);
+        }
+        nextActive.clear();
+        if (activeArcs <= pendingArcs)
+        {
+            // De arriba hacia abajo: cada estación activa empuja sus bits a los vecinos que no los tienen
+            for (int index : active)
+            {
+                for (const Arc &arc : *adjacency[index])
+                {
+                    Bits found;
+                    quint64 any = 0;
+                    for (int word = 0; word < kWords; ++word)
+                    {
+                        found[word] = visit[index][word] & ~seen[arc.target][word];
+                        any |= found[word];
+                    }
+                    if (any != 0)
+                    {
+                        discover(arc.target, found);
+                    }
+                }
+            }
+        }
+        else
+        {
+            // De abajo hacia arriba: cada estación pendiente junta los bits de sus vecinos activos
+            for (size_t index = 0; index < total; ++index)
+            {
+                if (seen[index] == everyone)
+                {
+                    continue;
+                }
+                Bits found{};
+                for (const Arc &arc : *adjacency[index])
+                {
+                    for (int word = 0; word < kWords; ++word)
+                    {
+                        found[word] |= visit[arc.target][word];
+                    }
+                }
+                quint64 any = 0;
+                for (int word = 0; word < kWords; ++word)
+                {
+                    found[word] &= ~seen[index][word];
+                    any |= found[word];
+                }
+                if (any != 0)
+                {
+                    discover(static_cast<int>(index), found);
+                }
+            }
+        }
+        for (int index : nextActive)
+        {
+            for (int word = 0; word < kWords; ++word)
+            {
+                for (quint64 bits = next[index][word]; bits != 0; bits &= bits - 1)
+                {
+                    int row = first + word * 64 + static_cast<int>(qCountTrailingZeroBits(bits));
+                    table.hops[row * total + index] = level;
+                    ++table.reached[row];
+                }
+            }
+        }
+        for (int index : active)
         {
-            result.edges.push_back(edge);
-            result.total += edge.weight;
+            visit[index] = Bits{};
         }
+        visit.swap(next);
+        active.swap(nextActive);
     }
-    return result;
+    return QueryStatus::Completed;
 }
 
-double GraphNetwork::getWeight(int fromId, int toId) const
+std::shared_ptr<const ShortestPathTree> GraphNetwork::shortestPathTree(int sourceId, const QueryOptions &options) const
 {
-    int fromIndex = indexOf(fromId);
-    int toIndex = indexOf(toId);
-    if (fromIndex < 0 || toIndex < 0)
+    int sourceIndex = indexOf(sourceId);
+    if (sourceIndex < 0)
     {
-        return std::numeric_limits<double>::infinity();
+        return nullptr;
     }
-    return matrix[fromIndex][toIndex];
-}
-
-void GraphNetwork::clear()
-{
-    stationList.clear();
-    indexById.clear();
-    baseMatrix.clear();
-    matrix.clear();
-    activeClosures.clear();
-}
-
-void GraphNetwork::scaleStationPositions(double scaleX, double scaleY)
-{
-    if (!std::isfinite(scaleX) || !std::isfinite(scaleY) || scaleX <= 0.0 || scaleY <= 0.0)
+    if (auto cached = treeCache->find(version, sourceId))
     {
-        return;
+        return cached;
     }
-    for (auto &station : stationList)
+    // Se busca el árbol más reciente de una versión registrada; si la reparación agota un límite se calcula desde cero
+    for (auto step = repairLog.rbegin(); step != repairLog.rend(); ++step)
     {
-        if (!station.hasCoordinates())
+        std::shared_ptr<const ShortestPathTree> stale = treeCache->peek(step->version, sourceId);
+        if (!stale)
         {
             continue;
         }
-        QPointF current = station.getPosition();
-        station.setPosition(QPointF(current.x() * scaleX, current.y() * scaleY));
+        std::vector<ArcDelta> deltas;
+        deltasSince(step->version, deltas);
+        if (auto repaired = repairTree(*stale, deltas, options))
+        {
+            treeCache->insert(repaired);
+            treeCache->recordRepair();
+            return repaired;
+        }
+        break;
+    }
+    std::shared_ptr<const ShortestPathTree> tree = searchShortestPathTree(sourceId, options);
+    if (tree->status() == QueryStatus::Completed)
+    {
+        treeCache->insert(tree);
     }
+    return tree;
 }
 
-int GraphNetwork::indexOf(int id) const
+std::shared_ptr<const ShortestPathTree> GraphNetwork::searchShortestPathTree(int sourceId, const QueryOptions &options) const
 {
-    auto it = indexById.find(id);
-    if (it == indexById.end())
+    int sourceIndex = indexOf(sourceId);
+    if (sourceIndex < 0)
     {
-        return -1;
+        return nullptr;
     }
-    return it->second;
+    size_t size = adjacency.size();
+    QueryWorkspace::Lease workspace = QueryWorkspace::acquire();
+    workspace->prepare(size);
+    IndexedDaryHeap<4> queue(*workspace);
+    queue.update(sourceIndex, 0);
+    workspace->reach(sourceIndex, 0, -1);
+    int settled = 0;
+    QueryStatus status = QueryStatus::Completed;
+    while (!queue.empty())
+    {
+        auto [dist, index] = queue.pop();
+        status = options.limitStatus(settled);
+        if (status != QueryStatus::Completed)
+        {
+            break;
+        }
+        options.report(++settled, static_cast<int>(size));
+        workspace->settle(index);
+        for (const Arc &arc : *adjacency[index])
+        {
+            double tentative = dist + arc.weight;
+            if (tentative < workspace->distance(arc.target))
+            {
+                queue.update(arc.target, tentative);
+                workspace->reach(arc.target, tentative, index);
+            }
+        }
+    }
+    // Solo las estaciones asentadas tienen distancia definitiva; en un árbol parcial el resto queda sin alcanzar
+    std::vector<double> distances(size, std::numeric_limits<double>::infinity());
+    std::vector<int> parentIds(size, -1);
+    for (size_t index = 0; index < size; ++index)
+    {
+        int node = static_cast<int>(index);
+        if (workspace->isSettled(node))
+        {
+            distances[index] = workspace->distance(node);
+            int parent = workspace->parent(node);
+            parentIds[index] = parent < 0 ? -1 : stationList[parent].getId();
+        }
+    }
+    return std::make_shared<const ShortestPathTree>(sourceId, version, indexById, std::move(distances), std::move(parentIds), status);
+}
+
+ShortestPathTreeCache &GraphNetwork::pathTreeCache() const
+{
+    return *treeCache;
+}
+
+quint64 GraphNetwork::getVersion() const
+{
+    return version;
+}
+
+std::shared_ptr<const AllPairsTable> GraphNetwork::allPairs(const QueryOptions &options) const
+{
+    // Una consulta ya cancelada o vencida se resuelve como antes, sin tocar la caché
+    if (options.limitStatus(0) != QueryStatus::Completed)
+    {
+        return computeTable(options);
+    }
+    std::shared_ptr<const AllPairsTable> cached = tableCache->latest();
+    if (cached && cached->graphVersion() == version)
+    {
+        return cached;
+    }
+    std::vector<ArcDelta> deltas;
+    if (cached && cached->indexById == indexById && deltasSince(cached->graphVersion(), deltas))
+    {
+        std::shared_ptr<const AllPairsTable> repaired = repairTable(*cached, deltas);
+        tableCache->store(repaired);
+        tableCache->recordRepair();
+        return repaired;
+    }
+    std::shared_ptr<const AllPairsTable> table = computeTable(options);
+    if (table->status() == QueryStatus::Completed)
+    {
+        tableCache->store(table);
+    }
+    return table;
+}
+
+AllPairsCache &GraphNetwork::allPairsCache() const
+{
+    return *tableCache;
+}
+
+PathDetail GraphNetwork::floydWarshall(int startId, int endId, const QueryOptions &options) const
+{
+    if (indexOf(startId) < 0 || indexOf(endId) < 0)
+    {
+        return {{}, std::numeric_limits<double>::infinity()};
+    }
+    return allPairs(options)->route(startId, endId);
+}
+
+PathDetail GraphNetwork::astar(int startId, int endId, const LandmarkTable *landmarks, const QueryOptions &options) const
+{
+    PathDetail result{{}, std::numeric_limits<double>::infinity()};
+    int startIndex = indexOf(startId);
+    int endIndex = indexOf(endId);
+    if (startIndex < 0 || endIndex < 0)
+    {
+        return result;
+    }
+    if (landmarks && landmarks->routesVersion() != routesVersion)
+    {
+        landmarks = nullptr;
+    }
+    // La cota de ALT es consistente: cada estación sale de la cola una sola vez con su distancia definitiva
+    auto bound = [landmarks, endIndex](int index) { return landmarks ? landmarks->lowerBound(index, endIndex) : 0.0; };
+    size_t size = adjacency.size();
+    QueryWorkspace::Lease workspace = QueryWorkspace::acquire();
+    workspace->prepare(size);
+    IndexedDaryHeap<4> queue(*workspace);
+    queue.update(startIndex, bound(startIndex));
+    workspace->reach(startIndex, 0, -1);
+    int settled = 0;
+    while (!queue.empty())
+    {
+        int index = queue.pop().second;
+        result.status = options.limitStatus(settled);
+        if (result.status != QueryStatus::Completed)
+        {
+            break;
+        }
+        options.report(++settled, static_cast<int>(size));
+        workspace->settle(index);
+        if (index == endIndex)
+        {
+            break;
+        }
+        double dist = workspace->distance(index);
+        for (const Arc &arc : *adjacency[index])
+        {
+            double tentative = dist + arc.weight;
+            if (workspace->isSettled(arc.target) || !(tentative < workspace->distance(arc.target)))
+            {
+                continue;
+            }
+            double remaining = bound(arc.target);
+            // Una estación que no se conecta con el destino en la red sin cierres tampoco lo hace con ellos
+            if (std::isinf(remaining))
+            {
+                continue;
+            }
+            queue.update(arc.target, tentative + remaining);
+            workspace->reach(arc.target, tentative, index);
+        }
+    }
+    if (!workspace->isReached(endIndex))
+    {
+        return result;
+    }
+    for (int current = endIndex; current != -1; current = workspace->parent(current))
+    {
+        result.stations.push_back(stationList[current].getId());
+    }
+    std::reverse(result.stations.begin(), result.stations.end());
+    result.total = workspace->distance(endIndex);
+    return result;
+}
+
+std::vector<PathDetail> GraphNetwork::kShortestPaths(int startId, int endId, int k, const QueryOptions &options, ThreadPool *pool) const
+{
+    std::vector<PathDetail> result;
+    int startIndex = indexOf(startId);
+    int endIndex = indexOf(endId);
+    if (startIndex < 0 || endIndex < 0 || k <= 0)
+    {
+        return result;
+    }
+    // prefix[i] es el tiempo desde el origen hasta nodes[i]; deviation, la posición donde el camino se separa de su padre
+    struct Candidate
+    {
+        std::vector<int> nodes;
+        std::vector<double> prefix;
+        int deviation;
+    };
+    auto longer = [](const Candidate &a, const Candidate &b) {
+        return a.prefix.back() != b.prefix.back() ? a.prefix.back() > b.prefix.back() : a.nodes > b.nodes;
+    };
+    QueryStatus status = QueryStatus::Completed;
+    std::vector<Candidate> accepted(1);
+    accepted[0].deviation = 0;
+    if (!spurSearch(startIndex, endIndex, {}, {}, options, accepted[0].nodes, accepted[0].prefix, status))
+    {
+        // Sin camino confirmado, un único detalle vacío conserva el estado si fue un límite el que cortó la búsqueda
+        if (status != QueryStatus::Completed)
+        {
+            result.push_back({{}, std::numeric_limits<double>::infinity(), status});
+        }
+        return result;
+    }
+    std::vector<Candidate> candidates;
+    std::set<std::vector<int>> seen{accepted[0].nodes};
+    options.report(1, k);
+    while (static_cast<int>(accepted.size()) < k)
+    {
+        // Los desvíos anteriores a deviation ya se exploraron desde el padre de este camino (Lawler)
+        const Candidate &last = accepted.back();
+        int spurCount = static_cast<int>(last.nodes.size()) - 1 - last.deviation;
+        std::vector<Candidate> spurs(std::max(0, spurCount));
+        std::vector<QueryStatus> spurStatus(spurs.size(), QueryStatus::Completed);
+        auto runSpurs = [&](int begin, int end) {
+            std::vector<int> blocked;
+            std::vector<int> nodes;
+            std::vector<double> distances;
+            for (int slot = begin; slot < end; ++slot)
+            {
+                int position = last.deviation + slot;
+                // La raíz se reutiliza tal cual del camino aceptado, con sus tiempos; solo se busca el tramo desde el desvío
+                std::vector<int> root(last.nodes.begin(), last.nodes.begin() + position);
+                blocked.clear();
+                for (const Candidate &path : accepted)
+                {
+                    if (static_cast<int>(path.nodes.size()) > position + 1 &&
+                        std::equal(path.nodes.begin(), path.nodes.begin() + position + 1, last.nodes.begin()))
+                    {
+                        blocked.push_back(path.nodes[position + 1]);
+                    }
+                }
+                if (!spurSearch(last.nodes[position], endIndex, root, blocked, options, nodes, distances, spurStatus[slot]))
+                {
+                    continue;
+                }
+                Candidate &spur = spurs[slot];
+                spur.deviation = position;
+                spur.nodes = std::move(root);
+                spur.nodes.insert(spur.nodes.end(), nodes.begin(), nodes.end());
+                spur.prefix.assign(last.prefix.begin(), last.prefix.begin() + position);
+                for (double distance : distances)
+                {
+                    spur.prefix.push_back(last.prefix[position] + distance);
+                }
+            }
+        };
+        if (pool && pool->size() > 1 && spurs.size() > 1)
+        {
+            pool->parallelFor(static_cast<int>(spurs.size()), runSpurs);
+        }
+        else
+        {
+            runSpurs(0, static_cast<int>(spurs.size()));
+        }
+        for (size_t slot = 0; slot < spurs.size(); ++slot)
+        {
+            if (spurStatus[slot] != QueryStatus::Completed && status == QueryStatus::Completed)
+            {
+                status = spurStatus[slot];
+            }
+            if (!spurs[slot].nodes.empty() && seen.insert(spurs[slot].nodes).second)
+            {
+                candidates.push_back(std::move(spurs[slot]));
+                std::push_heap(candidates.begin(), candidates.end(), longer);
+            }
+        }
+        // Con desvíos sin explorar, el mejor candidato podría no ser el siguiente camino
+        if (status != QueryStatus::Completed || candidates.empty())
+        {
+            break;
+        }
+        std::pop_heap(candidates.begin(), candidates.end(), longer);
+        accepted.push_back(std::move(candidates.back()));
+        candidates.pop_back();
+        options.report(static_cast<int>(accepted.size()), k);
+    }
+    result.reserve(accepted.size());
+    for (const Candidate &path : accepted)
+    {
+        PathDetail detail{{}, path.prefix.back(), status};
+        detail.stations.reserve(path.nodes.size());
+        for (int index : path.nodes)
+        {
+            detail.stations.push_back(stationList[index].getId());
+        }
+        result.push_back(std::move(detail));
+    }
+    return result;
+}
+
+bool GraphNetwork::spurSearch(int spurIndex, int endIndex, const std::vector<int> &rootNodes, const std::vector<int> &blockedTargets,
+                              const QueryOptions &options, std::vector<int> &nodes, std::vector<double> &distances,
+                              QueryStatus &status) const
+{
+    nodes.clear();
+    distances.clear();
+    status = QueryStatus::Completed;
+    QueryWorkspace::Lease workspace = QueryWorkspace::acquire();
+    workspace->prepare(adjacency.size());
+    // La máscara no copia la matriz: las estaciones de la raíz se marcan como ya asentadas y nunca se alcanzan
+    for (int index : rootNodes)
+    {
+        workspace->settle(index);
+    }
+    IndexedDaryHeap<4> queue(*workspace);
+    queue.update(spurIndex, 0);
+    workspace->reach(spurIndex, 0, -1);
+    int settled = 0;
+    while (!queue.empty())
+    {
+        int index = queue.pop().second;
+        status = options.limitStatus(settled);
+        if (status != QueryStatus::Completed)
+        {
+            return false;
+        }
+        ++settled;
+        workspace->settle(index);
+        if (index == endIndex)
+        {
+            break;
+        }
+        double dist = workspace->distance(index);
+        for (const Arc &arc : *adjacency[index])
+        {
+            double tentative = dist + arc.weight;
+            if (workspace->isSettled(arc.target) || !(tentative < workspace->distance(arc.target)) ||
+                (index == spurIndex && std::find(blockedTargets.begin(), blockedTargets.end(), arc.target) != blockedTargets.end()))
+            {
+                continue;
+            }
+            queue.update(arc.target, tentative);
+            workspace->reach(arc.target, tentative, index);
+        }
+    }
+    if (!workspace->isSettled(endIndex))
+    {
+        return false;
+    }
+    for (int current = endIndex; current != -1; current = workspace->parent(current))
+    {
+        nodes.push_back(current);
+        distances.push_back(workspace->distance(current));
+    }
+    std::reverse(nodes.begin(), nodes.end());
+    std::reverse(distances.begin(), distances.end());
+    return true;
+}
+
+quint64 GraphNetwork::getRoutesVersion() const
+{
+    return routesVersion;
+}
+
+std::shared_ptr<const AllPairsTable> GraphNetwork::computeTable(const QueryOptions &options) const
+{
+    size_t size = matrix.size();
+    std::vector<double> dist(size * size);
+    std::vector<int> next(size * size, -1);
+    for (size_t i = 0; i < size; ++i)
+    {
+        double *row = &dist[i * size];
+        std::copy(matrix[i]->begin(), matrix[i]->end(), row);
+        for (size_t j = 0; j < size; ++j)
+        {
+            if (std::isfinite(row[j]) && i != j)
+            {
+                next[i * size + j] = static_cast<int>(j);
+            }
+        }
+        row[i] = 0;
+        next[i * size + i] = static_cast<int>(i);
+    }
+    QueryStatus status = QueryStatus::Completed;
+    for (size_t k = 0; k < size; ++k)
+    {
+        status = options.limitStatus(static_cast<int>(k));
+        if (status != QueryStatus::Completed)
+        {
+            break;
+        }
+        options.report(static_cast<int>(k + 1), static_cast<int>(size));
+        const double *rowK = &dist[k * size];
+        for (size_t i = 0; i < size; ++i)
+        {
+            double *row = &dist[i * size];
+            if (!std::isfinite(row[k]))
+            {
+                continue;
+            }
+            for (size_t j = 0; j < size; ++j)
+            {
+                double candidate = row[k] + rowK[j];
+                if (candidate < row[j])
+                {
+                    row[j] = candidate;
+                    next[i * size + j] = next[i * size + k];
+                }
+            }
+        }
+    }
+    std::vector<int> stationIds(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        stationIds[i] = stationList[i].getId();
+    }
+    return std::make_shared<const AllPairsTable>(version, indexById, std::move(stationIds), std::move(dist), std::move(next), status);
+}
+
+std::shared_ptr<const ShortestPathTree> GraphNetwork::repairTree(const ShortestPathTree &tree, const std::vector<ArcDelta> &deltas,
+                                                                 const QueryOptions &options) const
+{
+    size_t size = adjacency.size();
+    if (tree.indexById != indexById || tree.distances.size() != size)
+    {
+        return nullptr;
+    }
+    int sourceIndex = indexOf(tree.sourceId());
+    std::vector<double> distances = tree.distances;
+    std::vector<int> parents(size, -1);
+    for (size_t index = 0; index < size; ++index)
+    {
+        if (static_cast<int>(index) != sourceIndex && std::isfinite(distances[index]))
+        {
+            parents[index] = indexOf(tree.parentIds[index]);
+        }
+    }
+    std::vector<ArcDelta> increased;
+    std::vector<ArcDelta> decreased;
+    for (const ArcDelta &delta : deltas)
+    {
+        (delta.after > delta.before ? increased : decreased).push_back(delta);
+    }
+    QueryWorkspace::Lease workspace = QueryWorkspace::acquire();
+    LazyBinaryHeap queue(*workspace);
+    int settled = 0;
+
+    // Fase 1 (Ramalingam-Reps): un tramo del árbol que se encarece o se cierra desconecta el subárbol que cuelga de él.
+    // Solo esas estaciones se recalculan, con los tramos abaratados todavía en su peso anterior.
+    std::vector<int> roots;
+    for (const ArcDelta &delta : increased)
+    {
+        if (parents[delta.to] == delta.from)
+        {
+            roots.push_back(delta.to);
+        }
+        if (parents[delta.from] == delta.to)
+        {
+            roots.push_back(delta.from);
+        }
+    }
+    if (!roots.empty())
+    {
+        std::vector<int> firstChild(size + 1, 0);
+        for (int parent : parents)
+        {
+            if (parent >= 0)
+            {
+                ++firstChild[parent + 1];
+            }
+        }
+        std::partial_sum(firstChild.begin(), firstChild.end(), firstChild.begin());
+        std::vector<int> children(firstChild.back());
+        std::vector<int> fill(firstChild.begin(), firstChild.end() - 1);
+        for (size_t index = 0; index < size; ++index)
+        {
+            if (parents[index] >= 0)
+            {
+                children[fill[parents[index]]++] = static_cast<int>(index);
+            }
+        }
+        std::vector<char> affected(size, 0);
+        std::vector<int> subtree;
+        while (!roots.empty())
+        {
+            int node = roots.back();
+            roots.pop_back();
+            if (affected[node])
+            {
+                continue;
+            }
+            affected[node] = 1;
+            subtree.push_back(node);
+            roots.insert(roots.end(), children.begin() + firstChild[node], children.begin() + firstChild[node + 1]);
+        }
+        for (int node : subtree)
+        {
+            distances[node] = std::numeric_limits<double>::infinity();
+            parents[node] = -1;
+        }
+        // Cada estación del subárbol arranca con el mejor vecino que quedó fuera de él
+        for (int node : subtree)
+        {
+            for (const Arc &arc : *adjacency[node])
+            {
+                double candidate = distances[arc.target] + arcWeight(node, arc, &decreased);
+                if (!affected[arc.target] && candidate < distances[node])
+                {
+                    distances[node] = candidate;
+                    parents[node] = arc.target;
+                }
+            }
+            if (std::isfinite(distances[node]))
+            {
+                queue.update(node, distances[node]);
+            }
+        }
+        if (!propagateRepair(queue, distances, parents, &decreased, options, settled))
+        {
+            return nullptr;
+        }
+    }
+
+    // Fase 2: los tramos abaratados o reabiertos solo pueden acortar caminos; se propaga desde sus extremos
+    for (const ArcDelta &delta : decreased)
+    {
+        for (auto [from, to] : {std::pair<int, int>(delta.from, delta.to), std::pair<int, int>(delta.to, delta.from)})
+        {
+            double candidate = distances[from] + delta.after;
+            if (candidate < distances[to])
+            {
+                distances[to] = candidate;
+                parents[to] = from;
+                queue.update(to, candidate);
+            }
+        }
+    }
+    if (!propagateRepair(queue, distances, parents, nullptr, options, settled))
+    {
+        return nullptr;
+    }
+    std::vector<int> parentIds(size, -1);
+    for (size_t index = 0; index < size; ++index)
+    {
+        parentIds[index] = parents[index] < 0 ? -1 : stationList[parents[index]].getId();
+    }
+    return std::make_shared<const ShortestPathTree>(tree.sourceId(), version, indexById, std::move(distances), std::move(parentIds),
+                                                    QueryStatus::Completed);
+}
+
+std::shared_ptr<const AllPairsTable> GraphNetwork::repairTable(const AllPairsTable &table, const std::vector<ArcDelta> &deltas) const
+{
+    size_t size = adjacency.size();
+    std::vector<double> dist = table.distances;
+    std::vector<int> next = table.nextHops;
+    std::vector<ArcDelta> increased;
+    std::vector<ArcDelta> decreased;
+    for (const ArcDelta &delta : deltas)
+    {
+        (delta.after > delta.before ? increased : decreased).push_back(delta);
+    }
+
+    // Fase 1: se recalculan con Dijkstra solo las filas con algún tramo encarecido en un camino mínimo
+    if (!increased.empty())
+    {
+        QueryWorkspace::Lease workspace = QueryWorkspace::acquire();
+        std::vector<double> distances(size);
+        std::vector<int> parents(size);
+        std::vector<int> hops(size);
+        std::vector<int> chain;
+        for (size_t source = 0; source < size; ++source)
+        {
+            double *row = &dist[source * size];
+            bool affected = std::any_of(increased.begin(), increased.end(), [row](const ArcDelta &delta) {
+                return tightArc(row[delta.from], row[delta.to], delta.before) || tightArc(row[delta.to], row[delta.from], delta.before);
+            });
+            if (!affected)
+            {
+                continue;
+            }
+            std::fill(distances.begin(), distances.end(), std::numeric_limits<double>::infinity());
+            std::fill(parents.begin(), parents.end(), -1);
+            int origin = static_cast<int>(source);
+            distances[origin] = 0;
+            LazyBinaryHeap queue(*workspace);
+            queue.update(origin, 0);
+            int settled = 0;
+            propagateRepair(queue, distances, parents, &decreased, QueryOptions(), settled);
+            // El primer salto de cada estación es el de su padre, salvo que cuelgue directamente del origen
+            std::fill(hops.begin(), hops.end(), -2);
+            hops[origin] = origin;
+            for (size_t index = 0; index < size; ++index)
+            {
+                if (!std::isfinite(distances[index]))
+                {
+                    hops[index] = -1;
+                }
+            }
+            for (size_t index = 0; index < size; ++index)
+            {
+                int node = static_cast<int>(index);
+                chain.clear();
+                while (hops[node] == -2)
+                {
+                    if (parents[node] == origin)
+                    {
+                        hops[node] = node;
+                        break;
+                    }
+                    chain.push_back(node);
+                    node = parents[node];
+                }
+                for (int waiting : chain)
+                {
+                    hops[waiting] = hops[node];
+                }
+            }
+            std::copy(distances.begin(), distances.end(), row);
+            std::copy(hops.begin(), hops.end(), next.begin() + source * size);
+        }
+    }
+
+    // Fase 2: un tramo abaratado se usa a lo sumo una vez por camino, así que alcanza con las distancias previas a él
+    std::vector<double> toFrom(size);
+    std::vector<double> toTo(size);
+    std::vector<int> hopFrom(size);
+    std::vector<int> hopTo(size);
+    for (const ArcDelta &delta : decreased)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            toFrom[i] = dist[i * size + delta.from];
+            toTo[i] = dist[i * size + delta.to];
+            hopFrom[i] = next[i * size + delta.from];
+            hopTo[i] = next[i * size + delta.to];
+        }
+        std::vector<double> fromRow(dist.begin() + delta.from * size, dist.begin() + (delta.from + 1) * size);
+        std::vector<double> toRow(dist.begin() + delta.to * size, dist.begin() + (delta.to + 1) * size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (!std::isfinite(toFrom[i]) && !std::isfinite(toTo[i]))
+            {
+                continue;
+            }
+            int firstViaFrom = static_cast<int>(i) == delta.from ? delta.to : hopFrom[i];
+            int firstViaTo = static_cast<int>(i) == delta.to ? delta.from : hopTo[i];
+            double *row = &dist[i * size];
+            int *hops = &next[i * size];
+            for (size_t j = 0; j < size; ++j)
+            {
+                double viaFrom = toFrom[i] + delta.after + toRow[j];
+                if (viaFrom < row[j])
+                {
+                    row[j] = viaFrom;
+                    hops[j] = firstViaFrom;
+                }
+                double viaTo = toTo[i] + delta.after + fromRow[j];
+                if (viaTo < row[j])
+                {
+                    row[j] = viaTo;
+                    hops[j] = firstViaTo;
+                }
+            }
+        }
+    }
+    return std::make_shared<const AllPairsTable>(version, indexById, table.stationIds, std::move(dist), std::move(next),
+                                                 QueryStatus::Completed);
+}
+
+bool GraphNetwork::propagateRepair(LazyBinaryHeap &queue, std::vector<double> &distances, std::vector<int> &parents,
+                                   const std::vector<ArcDelta> *restored, const QueryOptions &options, int &settled) const
+{
+    while (!queue.empty())
+    {
+        auto [dist, index] = queue.pop();
+        if (dist > distances[index])
+        {
+            continue;
+        }
+        if (options.limitStatus(settled) != QueryStatus::Completed)
+        {
+            return false;
+        }
+        ++settled;
+        for (const Arc &arc : *adjacency[index])
+        {
+            double tentative = dist + arcWeight(index, arc, restored);
+            if (tentative < distances[arc.target])
+            {
+                distances[arc.target] = tentative;
+                parents[arc.target] = index;
+                queue.update(arc.target, tentative);
+            }
+        }
+    }
+    return true;
+}
+
+double GraphNetwork::arcWeight(int from, const Arc &arc, const std::vector<ArcDelta> *restored)
+{
+    // restored lista tramos que todavía deben pesar lo de antes (inf si no existían)
+    if (restored)
+    {
+        int low = std::min(from, arc.target);
+        int high = std::max(from, arc.target);
+        for (const ArcDelta &delta : *restored)
+        {
+            if (delta.from == low && delta.to == high)
+            {
+                return delta.before;
+            }
+        }
+    }
+    return arc.weight;
+}
+
+TreeDetail GraphNetwork::prim(const QueryOptions &options) const
+{
+    TreeDetail result{{}, 0, QueryStatus::Completed, {}};
+    size_t size = adjacency.size();
+    if (size == 0)
+    {
+        return result;
+    }
+    // Prim con montículo sobre las listas de adyacencia: la clave de cada estación es el tramo más barato hacia el árbol,
+    // guardada como distancia en el espacio de trabajo; asentada = ya incorporada
+    QueryWorkspace::Lease workspace = QueryWorkspace::acquire();
+    workspace->prepare(size);
+    IndexedDaryHeap<4> queue(*workspace);
+    int settled = 0;
+    // Cada estación sin visitar abre un componente nuevo, así una red desconectada da un bosque completo
+    for (size_t root = 0; root < size && result.status == QueryStatus::Completed; ++root)
+    {
+        if (workspace->isSettled(static_cast<int>(root)))
+        {
+            continue;
+        }
+        result.componentTotals.push_back(0);
+        queue.update(static_cast<int>(root), 0);
+        workspace->reach(static_cast<int>(root), 0, -1);
+        while (!queue.empty())
+        {
+            auto [key, index] = queue.pop();
+            result.status = options.limitStatus(settled);
+            if (result.status != QueryStatus::Completed)
+            {
+                break;
+            }
+            options.report(++settled, static_cast<int>(size));
+            workspace->settle(index);
+            int parent = workspace->parent(index);
+            if (parent != -1)
+            {
+                result.edges.push_back({stationList[parent].getId(), stationList[index].getId(), key});
+                result.total += key;
+                result.componentTotals.back() += key;
+            }
+            for (const Arc &arc : *adjacency[index])
+            {
+                if (!workspace->isSettled(arc.target) && arc.weight < workspace->distance(arc.target))
+                {
+                    queue.update(arc.target, arc.weight);
+                    workspace->reach(arc.target, arc.weight, index);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+TreeDetail GraphNetwork::kruskal(const QueryOptions &options, ThreadPool *pool) const
+{
+    std::vector<IndexedEdge> edges = collectEdges();
+    std::vector<IndexedEdge> scratch(pool ? edges.size() : 0);
+    DisjointSets sets(static_cast<int>(adjacency.size()));
+    std::vector<IndexedEdge> chosen;
+    QueryStatus status = QueryStatus::Completed;
+    filterKruskal(edges, scratch, 0, edges.size(), sets, chosen, options, pool, status);
+    return forestDetail(chosen, sets, status);
+}
+
+void GraphNetwork::filterKruskal(std::vector<IndexedEdge> &edges, std::vector<IndexedEdge> &scratch, size_t begin, size_t end,
+                                 DisjointSets &sets, std::vector<IndexedEdge> &chosen, const QueryOptions &options, ThreadPool *pool,
+                                 QueryStatus &status) const
+{
+    size_t size = adjacency.size();
+    if (status != QueryStatus::Completed || begin == end || chosen.size() + 1 >= size)
+    {
+        return;
+    }
+    if (end - begin <= kKruskalBase)
+    {
+        std::sort(edges.begin() + begin, edges.begin() + end, lighter<IndexedEdge>);
+        for (size_t i = begin; i < end; ++i)
+        {
+            status = options.limitStatus(static_cast<int>(chosen.size()));
+            if (status != QueryStatus::Completed)
+            {
+                return;
+            }
+            if (sets.unite(edges[i].from, edges[i].to))
+            {
+                chosen.push_back(edges[i]);
+                options.report(static_cast<int>(chosen.size()), static_cast<int>(size) - 1);
+            }
+        }
+        return;
+    }
+    // Mediana de tres como pivote: con claves distintas ambas mitades quedan no vacías
+    IndexedEdge a = edges[begin];
+    IndexedEdge b = edges[begin + (end - begin) / 2];
+    IndexedEdge c = edges[end - 1];
+    if (lighter(b, a))
+    {
+        std::swap(a, b);
+    }
+    if (lighter(c, b))
+    {
+        b = lighter(c, a) ? a : c;
+    }
+    IndexedEdge pivot = b;
+    size_t middle = splitEdges(edges, scratch, begin, end, [&pivot](const IndexedEdge &edge) { return !lighter(pivot, edge); }, pool);
+    filterKruskal(edges, scratch, begin, middle, sets, chosen, options, pool, status);
+    if (status != QueryStatus::Completed)
+    {
+        return;
+    }
+    // Los tramos pesados que ya unen estaciones del mismo componente no entran nunca: se descartan sin ordenarlos
+    const DisjointSets &current = sets;
+    size_t kept = splitEdges(edges, scratch, middle, end,
+                             [&current](const IndexedEdge &edge) { return current.peek(edge.from) != current.peek(edge.to); }, pool);
+    filterKruskal(edges, scratch, middle, kept, sets, chosen, options, pool, status);
+}
+
+TreeDetail GraphNetwork::boruvka(const QueryOptions &options, ThreadPool *pool) const
+{
+    int size = static_cast<int>(adjacency.size());
+    DisjointSets sets(size);
+    std::vector<int> component(size);
+    std::iota(component.begin(), component.end(), 0);
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<IndexedEdge> vertexBest(size);
+    std::vector<IndexedEdge> componentBest(size);
+    std::vector<IndexedEdge> chosen;
+    QueryStatus status = QueryStatus::Completed;
+    // Cada estación busca su tramo más liviano hacia otro componente; solo lee component, así los hilos no se pisan
+    auto scanStations = [&](int begin, int end) {
+        for (int index = begin; index < end; ++index)
+        {
+            IndexedEdge best{inf, -1, -1};
+            for (const Arc &arc : *adjacency[index])
+            {
+                if (component[arc.target] == component[index])
+                {
+                    continue;
+                }
+                IndexedEdge edge{arc.weight, std::min(index, arc.target), std::max(index, arc.target)};
+                if (best.from < 0 || lighter(edge, best))
+                {
+                    best = edge;
+                }
+            }
+            vertexBest[index] = best;
+        }
+    };
+    bool merged = true;
+    while (merged && chosen.size() + 1 < static_cast<size_t>(size))
+    {
+        if (pool && pool->size() > 1 && size > 1)
+        {
+            pool->parallelFor(size, scanStations);
+        }
+        else
+        {
+            scanStations(0, size);
+        }
+        std::fill(componentBest.begin(), componentBest.end(), IndexedEdge{inf, -1, -1});
+        for (int index = 0; index < size; ++index)
+        {
+            IndexedEdge &best = componentBest[component[index]];
+            if (vertexBest[index].from >= 0 && (best.from < 0 || lighter(vertexBest[index], best)))
+            {
+                best = vertexBest[index];
+            }
+        }
+        // Con un orden total los tramos elegidos no forman ciclos; unite solo descarta el que eligieron ambos lados
+        merged = false;
+        for (int root = 0; root < size && status == QueryStatus::Completed; ++root)
+        {
+            const IndexedEdge &best = componentBest[root];
+            if (best.from < 0)
+            {
+                continue;
+            }
+            status = options.limitStatus(static_cast<int>(chosen.size()));
+            if (status == QueryStatus::Completed && sets.unite(best.from, best.to))
+            {
+                chosen.push_back(best);
+                merged = true;
+                options.report(static_cast<int>(chosen.size()), size - 1);
+            }
+        }
+        if (status != QueryStatus::Completed)
+        {
+            break;
+        }
+        for (int index = 0; index < size; ++index)
+        {
+            component[index] = sets.find(index);
+        }
+    }
+    return forestDetail(chosen, sets, status);
+}
+
+std::shared_ptr<const TreeDetail> GraphNetwork::spanningForest(const QueryOptions &options) const
+{
+    std::lock_guard<std::mutex> lock(forestCache->mutex);
+    if (forestCache->detail && forestCache->version == version)
+    {
+        return forestCache->detail;
+    }
+    // Un bosque de una versión posterior es de otra copia del grafo: se responde sin pisarlo
+    bool newer = forestCache->forest && forestCache->version > version;
+    std::vector<ArcDelta> deltas;
+    if (!newer && forestCache->forest && forestCache->forest->stationCount() == static_cast<int>(adjacency.size()) &&
+        deltasSince(forestCache->version, deltas))
+    {
+        // Primero los tramos que se encarecen, con los que se abaratan todavía en su peso anterior: cada reemplazo es
+        // entonces el tramo más liviano de un corte de esa red intermedia. Después entran los abaratados, que no buscan nada
+        std::vector<ArcDelta> lowered;
+        std::vector<ArcDelta> ordered;
+        for (const ArcDelta &delta : deltas)
+        {
+            (delta.after < delta.before ? lowered : ordered).push_back(delta);
+        }
+        size_t raised = ordered.size();
+        ordered.insert(ordered.end(), lowered.begin(), lowered.end());
+        QueryStatus status = QueryStatus::Completed;
+        for (size_t i = 0; i < ordered.size() && status == QueryStatus::Completed; ++i)
+        {
+            status = options.limitStatus(static_cast<int>(i));
+            if (status == QueryStatus::Completed)
+            {
+                updateForest(*forestCache, ordered[i], i < raised ? &lowered : nullptr);
+            }
+        }
+        if (status == QueryStatus::Completed)
+        {
+            forestCache->updateCount += deltas.size();
+            std::vector<IndexedEdge> chosen;
+            DisjointSets sets(static_cast<int>(adjacency.size()));
+            for (const GraphEdge &edge : forestCache->forest->edges())
+            {
+                chosen.push_back({edge.weight, edge.from, edge.to});
+                sets.unite(edge.from, edge.to);
+            }
+            forestCache->version = version;
+            forestCache->detail = std::make_shared<const TreeDetail>(forestDetail(chosen, sets, status));
+            return forestCache->detail;
+        }
+        // Un corte a mitad de la actualización deja el bosque a medias: se descarta
+        forestCache->forest.reset();
+        forestCache->detail.reset();
+    }
+    auto built = std::make_shared<const TreeDetail>(kruskal(options));
+    if (newer || built->status != QueryStatus::Completed)
+    {
+        return built;
+    }
+    auto forest = std::make_unique<DynamicForest>(static_cast<int>(adjacency.size()));
+    for (const GraphEdge &edge : built->edges)
+    {
+        forest->offer(indexOf(edge.from), indexOf(edge.to), edge.weight);
+    }
+    forestCache->forest = std::move(forest);
+    forestCache->version = version;
+    forestCache->detail = built;
+    ++forestCache->rebuildCount;
+    return built;
+}
+
+SpanningForestCache &GraphNetwork::spanningForestCache() const
+{
+    return *forestCache;
+}
+
+void GraphNetwork::updateForest(SpanningForestCache &cache, const ArcDelta &delta, const std::vector<ArcDelta> *restored) const
+{
+    DynamicForest &forest = *cache.forest;
+    if (delta.from == delta.to)
+    {
+        return;
+    }
+    if (!forest.contains(delta.from, delta.to))
+    {
+        // Un tramo fuera del bosque que se encarece o desaparece no cambia nada
+        if (delta.after < delta.before)
+        {
+            forest.offer(delta.from, delta.to, delta.after);
+        }
+        return;
+    }
+    if (delta.after <= delta.before)
+    {
+        forest.lower(delta.from, delta.to, delta.after);
+        return;
+    }
+    // Un tramo del bosque que se encarece o desaparece sale; el reemplazo es el tramo más liviano entre los dos lados,
+    // que puede ser él mismo con su peso nuevo. Se recorren los vecinos del lado chico: O(suma de sus grados)
+    std::vector<int> side;
+    forest.remove(delta.from, delta.to, side);
+    ++cache.rescanCount;
+    IndexedEdge best{std::numeric_limits<double>::infinity(), -1, -1};
+    for (int station : side)
+    {
+        cache.rescannedArcCount += adjacency[station]->size();
+        for (const Arc &arc : *adjacency[station])
+        {
+            double weight = arcWeight(station, arc, restored);
+            if (forest.inRemovedSide(arc.target) || std::isinf(weight))
+            {
+                continue;
+            }
+            IndexedEdge edge{weight, std::min(station, arc.target), std::max(station, arc.target)};
+            if (best.from < 0 || lighter(edge, best))
+            {
+                best = edge;
+            }
+        }
+    }
+    if (best.from >= 0)
+    {
+        forest.offer(best.from, best.to, best.weight);
+    }
+}
+
+std::vector<GraphNetwork::IndexedEdge> GraphNetwork::collectEdges() const
+{
+    std::vector<IndexedEdge> edges;
+    for (size_t from = 0; from < adjacency.size(); ++from)
+    {
+        const std::vector<Arc> &arcs = *adjacency[from];
+        // Las filas están ordenadas por destino: cada tramo se toma una vez, desde su extremo de índice menor
+        auto first = std::upper_bound(arcs.begin(), arcs.end(), static_cast<int>(from),
+                                      [](int target, const Arc &arc) { return target < arc.target; });
+        for (auto arc = first; arc != arcs.end(); ++arc)
+        {
+            edges.push_back({arc->weight, static_cast<int>(from), arc->target});
+        }
+    }
+    return edges;
+}
+
+TreeDetail GraphNetwork::forestDetail(const std::vector<IndexedEdge> &chosen, DisjointSets &sets, QueryStatus status) const
+{
+    TreeDetail result{{}, 0, status, {}};
+    // Componentes numerados por su primera estación, igual que en prim; las aristas de cada uno quedan juntas
+    std::vector<int> label(adjacency.size(), -1);
+    std::vector<int> componentOf(adjacency.size());
+    for (size_t index = 0; index < adjacency.size(); ++index)
+    {
+        int root = sets.find(static_cast<int>(index));
+        if (label[root] < 0)
+        {
+            label[root] = static_cast<int>(result.componentTotals.size());
+            result.componentTotals.push_back(0);
+        }
+        componentOf[index] = label[root];
+    }
+    // Reparto por componente que conserva el orden de chosen: O(n), sin ordenar
+    std::vector<size_t> start(result.componentTotals.size() + 1, 0);
+    for (const IndexedEdge &edge : chosen)
+    {
+        ++start[componentOf[edge.from] + 1];
+    }
+    std::partial_sum(start.begin(), start.end(), start.begin());
+    result.edges.resize(chosen.size());
+    for (const IndexedEdge &edge : chosen)
+    {
+        result.edges[start[componentOf[edge.from]]++] = {stationList[edge.from].getId(), stationList[edge.to].getId(), edge.weight};
+        result.total += edge.weight;
+        result.componentTotals[componentOf[edge.from]] += edge.weight;
+    }
+    return result;
+}
+
+double GraphNetwork::getWeight(int fromId, int toId) const
+{
+    int fromIndex = indexOf(fromId);
+    int toIndex = indexOf(toId);
+    if (fromIndex < 0 || toIndex < 0)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    return (*matrix[fromIndex])[toIndex];
+}
+
+void GraphNetwork::clear()
+{
+    stationList.clear();
+    indexById = std::make_shared<const std::unordered_map<int, int>>();
+    baseMatrix.clear();
+    matrix.clear();
+    baseAdjacency.clear();
+    adjacency.clear();
+    activeClosures.clear();
+    touch();
+}
+
+void GraphNetwork::scaleStationPositions(double scaleX, double scaleY)
+{
+    if (!std::isfinite(scaleX) || !std::isfinite(scaleY) || scaleX <= 0.0 || scaleY <= 0.0)
+    {
+        return;
+    }
+    for (auto &station : stationList)
+    {
+        if (!station.hasCoordinates())
+        {
+            continue;
+        }
+        QPointF current = station.getPosition();
+        station.setPosition(QPointF(current.x() * scaleX, current.y() * scaleY));
+    }
+}
+
+void GraphNetwork::touch()
+{
+    // Con otras estaciones los índices de los resultados viejos ya no sirven: no se pueden reparar
+    repairLog.clear();
+    version = ++graphVersionCounter;
+    routesVersion = version;
+}
+
+void GraphNetwork::touchArcs(std::vector<ArcChange> changes)
+{
+    repairLog.push_back({version, std::move(changes)});
+    if (repairLog.size() > kMaxRepairSteps)
+    {
+        repairLog.erase(repairLog.begin());
+    }
+    version = ++graphVersionCounter;
+}
+
+bool GraphNetwork::deltasSince(quint64 since, std::vector<ArcDelta> &deltas) const
+{
+    auto first = std::find_if(repairLog.begin(), repairLog.end(), [since](const RepairStep &step) { return step.version == since; });
+    if (first == repairLog.end())
+    {
+        return false;
+    }
+    deltas.clear();
+    for (auto step = first; step != repairLog.end(); ++step)
+    {
+        for (const ArcChange &change : step->changes)
+        {
+            // Vale el peso que tenía el tramo en la versión since, es decir, el del primer cambio registrado
+            auto known = std::find_if(deltas.begin(), deltas.end(),
+                                      [&change](const ArcDelta &delta) { return delta.from == change.from && delta.to == change.to; });
+            if (known == deltas.end())
+            {
+                deltas.push_back({change.from, change.to, change.before, (*matrix[change.from])[change.to]});
+            }
+        }
+    }
+    deltas.erase(std::remove_if(deltas.begin(), deltas.end(), [](const ArcDelta &delta) { return delta.before == delta.after; }),
+                 deltas.end());
+    return true;
+}
+
+int GraphNetwork::indexOf(int id) const
+{
+    auto it = indexById->find(id);
+    if (it == indexById->end())
+    {
+        return -1;
+    }
+    return it->second;
 }
 
 void GraphNetwork::resizeMatrix()
@@ -479,22 +2111,57 @@ void GraphNetwork::resizeMatrix()
     size_t size = stationList.size();
     double inf = std::numeric_limits<double>::infinity();
     baseMatrix.resize(size);
-    matrix.resize(size);
+    baseAdjacency.resize(size);
     for (size_t i = 0; i < size; ++i)
     {
-        baseMatrix[i].resize(size, inf);
-        matrix[i].resize(size, inf);
-        baseMatrix[i][i] = 0;
-        matrix[i][i] = 0;
+        if (!baseMatrix[i])
+        {
+            baseMatrix[i] = std::make_shared<std::vector<double>>();
+        }
+        if (!baseAdjacency[i])
+        {
+            baseAdjacency[i] = std::make_shared<std::vector<Arc>>();
+        }
+        if (baseMatrix[i]->size() != size)
+        {
+            auto &row = writableRow(baseMatrix, i);
+            row.resize(size, inf);
+            row[i] = 0;
+        }
+    }
+}
+
+void GraphNetwork::setArc(std::vector<ArcRow> &rows, int from, int to, double weight)
+{
+    std::vector<Arc> &arcs = writableRow(rows, from);
+    auto position = std::lower_bound(arcs.begin(), arcs.end(), to, [](const Arc &arc, int target) { return arc.target < target; });
+    bool present = position != arcs.end() && position->target == to;
+    if (!std::isfinite(weight))
+    {
+        if (present)
+        {
+            arcs.erase(position);
+        }
+    }
+    else if (present)
+    {
+        position->weight = weight;
+    }
+    else
+    {
+        arcs.insert(position, {to, weight});
     }
 }
 
 void GraphNetwork::rebuildIndices()
 {
-    indexById.clear();
+    auto index = std::make_shared<std::unordered_map<int, int>>();
+    index->reserve(stationList.size());
     for (size_t i = 0; i < stationList.size(); ++i)
     {
-        indexById[stationList[i].getId()] = static_cast<int>(i);
+        (*index)[stationList[i].getId()] = static_cast<int>(i);
     }
-    applyClosures(activeClosures);
+    indexById = std::move(index);
+    deriveClosures();
+    touch();
 }
@@ -1,6 +1,11 @@
 #pragma once
 
 #include "Station.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -12,18 +17,130 @@ struct GraphEdge
     double weight;
 };
 
+enum class QueryStatus
+{
+    Completed,
+    Cancelled,
+    DeadlineExceeded,
+    SettleLimitReached
+};
+
+// Límites de una consulta: al alcanzarse uno, el algoritmo se detiene y devuelve lo calculado hasta ese momento
+struct QueryOptions
+{
+    const std::atomic<bool> *cancelled = nullptr;
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    int maxSettled = 0; // 0 = sin límite
+    std::function<void(int completed, int total)> progress;
+
+    void setTimeBudget(std::chrono::microseconds budget)
+    {
+        deadline = std::chrono::steady_clock::now() + budget;
+    }
+    QueryStatus limitStatus(int settled) const
+    {
+        if (cancelled && cancelled->load(std::memory_order_relaxed))
+        {
+            return QueryStatus::Cancelled;
+        }
+        if (maxSettled > 0 && settled >= maxSettled)
+        {
+            return QueryStatus::SettleLimitReached;
+        }
+        if (deadline != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() >= deadline)
+        {
+            return QueryStatus::DeadlineExceeded;
+        }
+        return QueryStatus::Completed;
+    }
+    void report(int completed, int total) const
+    {
+        if (progress && total > 0 && (completed == total || completed % std::max(1, total / 100) == 0))
+        {
+            progress(completed, total);
+        }
+    }
+};
+
+inline const char *queryStatusName(QueryStatus status)
+{
+    switch (status)
+    {
+    case QueryStatus::Cancelled:
+        return "cancelled";
+    case QueryStatus::DeadlineExceeded:
+        return "deadline_exceeded";
+    case QueryStatus::SettleLimitReached:
+        return "settle_limit";
+    default:
+        return "completed";
+    }
+}
+
 struct PathDetail
 {
     std::vector<int> stations;
     double total;
+    QueryStatus status = QueryStatus::Completed;
 };
 
 struct TreeDetail
 {
     std::vector<GraphEdge> edges;
     double total;
+    QueryStatus status = QueryStatus::Completed;
+    // Bosque: un total por componente conexa, en el orden de su primera estación; una estación aislada suma 0.
+    // Las aristas de cada componente van juntas y en el mismo orden
+    std::vector<double> componentTotals;
 };
 
+struct TraversalDetail
+{
+    std::vector<int> stations;
+    QueryStatus status = QueryStatus::Completed;
+};
+
+// Distancias de cada origen a cada destino en un arreglo plano por filas; inf si no hay camino
+struct DistanceTable
+{
+    std::vector<int> sources;
+    std::vector<int> targets;
+    std::vector<double> distances;
+    QueryStatus status = QueryStatus::Completed;
+
+    double at(size_t sourceIndex, size_t targetIndex) const
+    {
+        return distances[sourceIndex * targets.size() + targetIndex];
+    }
+};
+
+// Saltos (tramos abiertos) de cada origen a cada estación en un arreglo plano por filas; -1 si no se alcanza.
+// Las columnas siguen el orden de getStations()
+struct HopTable
+{
+    std::vector<int> sources;
+    std::vector<int> stations;
+    std::vector<int> hops;
+    std::vector<int> reached; // estaciones alcanzadas por cada origen, él incluido
+    QueryStatus status = QueryStatus::Completed;
+
+    int at(size_t sourceIndex, size_t stationIndex) const
+    {
+        return hops[sourceIndex * stations.size() + stationIndex];
+    }
+};
+
+class ThreadPool;
+class ShortestPathTree;
+class ShortestPathTreeCache;
+class AllPairsTable;
+class AllPairsCache;
+class LazyBinaryHeap;
+class LandmarkTable;
+class DisjointSets;
+class DynamicForest;
+class SpanningForestCache;
+
 class GraphNetwork
 {
 public:
@@ -35,24 +152,148 @@ public:
     bool hasStation(int id) const;
     std::vector<Station> getStations() const;
     std::vector<GraphEdge> getConnections() const;
+    std::vector<GraphEdge> getConnectionsOf(int id) const;
     std::vector<std::pair<int, int>> getClosures() const;
     void applyClosures(const std::vector<std::pair<int, int>> &closures);
     std::vector<int> bfs(int startId) const;
     std::vector<int> dfs(int startId) const;
-    PathDetail dijkstra(int startId, int endId) const;
-    PathDetail floydWarshall(int startId, int endId) const;
-    TreeDetail prim() const;
-    TreeDetail kruskal() const;
+    TraversalDetail bfs(int startId, const QueryOptions &options) const;
+    TraversalDetail dfs(int startId, const QueryOptions &options) const;
+    PathDetail dijkstra(int startId, int endId, const QueryOptions &options = QueryOptions()) const;
+    // Variantes que reutilizan la capacidad de result: sin reservas de memoria en consultas repetidas
+    void bfs(int startId, const QueryOptions &options, TraversalDetail &result) const;
+    void dfs(int startId, const QueryOptions &options, TraversalDetail &result) const;
+    void dijkstra(int startId, int endId, const QueryOptions &options, PathDetail &result) const;
+    // Dijkstra con la cola de prioridad elegida en compilación (ver SearchQueues.h)
+    template <typename Queue>
+    void dijkstraWith(int startId, int endId, const QueryOptions &options, PathDetail &result) const;
+    // Una búsqueda por origen que se detiene al asentar todos los destinos; con pool los orígenes se reparten
+    // entre sus hilos (no llamar desde una tarea del mismo pool, parallelFor espera a que se vacíe)
+    DistanceTable distanceTable(const std::vector<int> &sources, const std::vector<int> &targets,
+                                const QueryOptions &options = QueryOptions(), ThreadPool *pool = nullptr) const;
+    // Árbol de caminos mínimos desde sourceId; se guarda en la caché compartida salvo que se haya cortado por un límite.
+    // Si la caché tiene el árbol de una versión anterior y desde entonces solo cambiaron tramos, se repara ese árbol.
+    std::shared_ptr<const ShortestPathTree> shortestPathTree(int sourceId, const QueryOptions &options = QueryOptions()) const;
+    // La misma búsqueda sin consultar ni llenar la caché, para índices que recorren muchos orígenes una sola vez
+    std::shared_ptr<const ShortestPathTree> searchShortestPathTree(int sourceId, const QueryOptions &options = QueryOptions()) const;
+    ShortestPathTreeCache &pathTreeCache() const;
+    quint64 getVersion() const;
+    // Tabla de Floyd-Warshall de todos los pares; la última completa queda en caché y se repara igual que los árboles
+    std::shared_ptr<const AllPairsTable> allPairs(const QueryOptions &options = QueryOptions()) const;
+    AllPairsCache &allPairsCache() const;
+    PathDetail floydWarshall(int startId, int endId, const QueryOptions &options = QueryOptions()) const;
+    // A* con cotas de landmarks (ALT). Sin tabla, o con una calculada para otras rutas, se comporta como Dijkstra
+    PathDetail astar(int startId, int endId, const LandmarkTable *landmarks, const QueryOptions &options = QueryOptions()) const;
+    // Hasta k caminos sin ciclos de menor a mayor tiempo (Yen). Las búsquedas de desvío de cada camino se reparten en pool
+    // si se da; si un límite corta la búsqueda, se devuelven los caminos ya confirmados y todos llevan ese estado. Si lo
+    // corta antes del primero, el resultado es un único PathDetail sin estaciones con ese estado
+    std::vector<PathDetail> kShortestPaths(int startId, int endId, int k, const QueryOptions &options = QueryOptions(),
+                                           ThreadPool *pool = nullptr) const;
+    // Cambia con las estaciones y las rutas, pero no con los cierres
+    quint64 getRoutesVersion() const;
+    // BFS por niveles con la frontera en un mapa de bits: cambia a recorrido de abajo hacia arriba (cada estación sin
+    // visitar busca un vecino en la frontera) cuando la frontera tiene más tramos que lo que queda por explorar
+    HopTable hopCounts(int startId, const QueryOptions &options = QueryOptions()) const;
+    // BFS de muchos orígenes a la vez: kHopBatch orígenes por lote, un bit por origen, y cada nivel avanza todos los
+    // recorridos del lote con operaciones por palabra. Los lotes se reparten en pool si se da
+    HopTable hopCounts(const std::vector<int> &sources, const QueryOptions &options = QueryOptions(), ThreadPool *pool = nullptr) const;
+    static constexpr int kHopBatch = 256;
+    TreeDetail prim(const QueryOptions &options = QueryOptions()) const;
+    // Filter-Kruskal: parte los tramos por un pivote y descarta los pesados que ya cierran un ciclo antes de ordenarlos.
+    // Los tres algoritmos desempatan por (peso, índice menor, índice mayor), así dan el mismo bosque con o sin pool
+    TreeDetail kruskal(const QueryOptions &options = QueryOptions(), ThreadPool *pool = nullptr) const;
+    // Rondas de Borůvka: cada componente toma su tramo más liviano hacia otro; la búsqueda se reparte en pool
+    TreeDetail boruvka(const QueryOptions &options = QueryOptions(), ThreadPool *pool = nullptr) const;
+    // Bosque mínimo mantenido entre versiones (el mismo de kruskal): se actualiza con los tramos cambiados desde la
+    // última consulta en vez de recalcularse. Si no hay registro desde esa versión, se reconstruye con kruskal.
+    // Altas y abaratamientos cuestan O(log n) amortizado; quitar o encarecer un tramo del bosque reexplora los vecinos
+    // del lado chico del corte (SpanningForestCache::rescannedArcs lo mide), no es una actualización polilogarítmica
+    std::shared_ptr<const TreeDetail> spanningForest(const QueryOptions &options = QueryOptions()) const;
+    SpanningForestCache &spanningForestCache() const;
     double getWeight(int fromId, int toId) const;
     void clear();
     void scaleStationPositions(double scaleX, double scaleY);
 private:
     std::vector<Station> stationList;
-    std::unordered_map<int, int> indexById;
-    std::vector<std::vector<double>> baseMatrix;
-    std::vector<std::vector<double>> matrix;
+    // Índice compartido con los árboles de caminos; se reemplaza entero al cambiar las estaciones
+    std::shared_ptr<const std::unordered_map<int, int>> indexById;
+    using MatrixRow = std::shared_ptr<std::vector<double>>;
+    std::vector<MatrixRow> baseMatrix;
+    std::vector<MatrixRow> matrix;
+    // Listas de adyacencia ordenadas por índice de destino; reflejan baseMatrix y matrix para recorrer solo los vecinos
+    struct Arc
+    {
+        int target;
+        double weight;
+    };
+    using ArcRow = std::shared_ptr<std::vector<Arc>>;
+    std::vector<ArcRow> baseAdjacency;
+    std::vector<ArcRow> adjacency;
     std::vector<std::pair<int, int>> activeClosures;
+    // Cada mutación toma una versión nueva de un contador global, así dos grafos distintos nunca comparten versión
+    quint64 version;
+    quint64 routesVersion;
+    std::shared_ptr<ShortestPathTreeCache> treeCache;
+    std::shared_ptr<AllPairsCache> tableCache;
+    std::shared_ptr<SpanningForestCache> forestCache;
+    // Tramo cambiado por una mutación: índices con from < to y peso en matrix antes del cambio
+    struct ArcChange
+    {
+        int from;
+        int to;
+        double before;
+    };
+    // Cambios hechos al dejar la versión indicada; se vacía cuando cambian las estaciones
+    struct RepairStep
+    {
+        quint64 version;
+        std::vector<ArcChange> changes;
+    };
+    std::vector<RepairStep> repairLog;
+    // Cambio neto de un tramo entre una versión del registro y la actual
+    struct ArcDelta
+    {
+        int from;
+        int to;
+        double before;
+        double after;
+    };
     int indexOf(int id) const;
+    void touch();
+    void touchArcs(std::vector<ArcChange> changes);
+    bool deltasSince(quint64 since, std::vector<ArcDelta> &deltas) const;
+    void deriveClosures();
     void resizeMatrix();
     void rebuildIndices();
+    std::shared_ptr<const ShortestPathTree> repairTree(const ShortestPathTree &tree, const std::vector<ArcDelta> &deltas,
+                                                       const QueryOptions &options) const;
+    std::shared_ptr<const AllPairsTable> repairTable(const AllPairsTable &table, const std::vector<ArcDelta> &deltas) const;
+    std::shared_ptr<const AllPairsTable> computeTable(const QueryOptions &options) const;
+    bool propagateRepair(LazyBinaryHeap &queue, std::vector<double> &distances, std::vector<int> &parents,
+                         const std::vector<ArcDelta> *restored, const QueryOptions &options, int &settled) const;
+    static double arcWeight(int from, const Arc &arc, const std::vector<ArcDelta> *restored);
+    template <typename T>
+    static std::vector<T> &writableRow(std::vector<std::shared_ptr<std::vector<T>>> &rows, size_t index);
+    QueryStatus settleTargets(int sourceIndex, const std::vector<int> &targetMark, int targetCount, const std::vector<int> &targetColumns,
+                              const QueryOptions &options, double *row) const;
+    static void setArc(std::vector<ArcRow> &rows, int from, int to, double weight);
+    // Tramo por índices con from < to, para los árboles de expansión
+    struct IndexedEdge
+    {
+        double weight;
+        int from;
+        int to;
+    };
+    std::vector<IndexedEdge> collectEdges() const;
+    void filterKruskal(std::vector<IndexedEdge> &edges, std::vector<IndexedEdge> &scratch, size_t begin, size_t end, DisjointSets &sets,
+                       std::vector<IndexedEdge> &chosen, const QueryOptions &options, ThreadPool *pool, QueryStatus &status) const;
+    TreeDetail forestDetail(const std::vector<IndexedEdge> &chosen, DisjointSets &sets, QueryStatus status) const;
+    void updateForest(SpanningForestCache &cache, const ArcDelta &delta, const std::vector<ArcDelta> *restored) const;
+    HopTable emptyHopTable(const std::vector<int> &sources) const;
+    // Un lote de hopCounts: los orígenes [first, last) de table.sources
+    QueryStatus hopBatch(HopTable &table, int first, int last, const QueryOptions &options) const;
+    // Dijkstra desde spurIndex que no pasa por rootNodes ni usa los tramos spurIndex -> blockedTargets;
+    // deja en nodes y distances el camino hasta endIndex con la distancia acumulada desde spurIndex
+    bool spurSearch(int spurIndex, int endIndex, const std::vector<int> &rootNodes, const std::vector<int> &blockedTargets,
+                    const QueryOptions &options, std::vector<int> &nodes, std::vector<double> &distances, QueryStatus &status) const;
 };
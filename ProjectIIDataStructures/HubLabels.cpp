@@ -0,0 +1,427 @@
+#include "HubLabels.h"
+#include "LandmarkTable.h"
+#include "QueryWorkspace.h"
+#include "SearchQueues.h"
+#include <QFile>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+namespace
+{
+const char kMagic[4] = {'T', 'H', 'U', 'B'};
+const quint32 kFormatVersion = 1;
+
+template <typename T>
+bool readArray(QFile &file, std::vector<T> &values, size_t count)
+{
+    values.resize(count);
+    qint64 bytes = static_cast<qint64>(count * sizeof(T));
+    return file.read(reinterpret_cast<char *>(values.data()), bytes) == bytes;
+}
+
+template <typename T>
+bool writeArray(QFile &file, const std::vector<T> &values)
+{
+    qint64 bytes = static_cast<qint64>(values.size() * sizeof(T));
+    return file.write(reinterpret_cast<const char *>(values.data()), bytes) == bytes;
+}
+}
+
+HubLabels::HubLabels(quint64 fingerprint, quint64 graphVersion, std::vector<int> stationIds, std::vector<int> hubOrder,
+                     std::vector<quint32> offsets, std::vector<int> hubs, std::vector<double> distances, std::vector<int> parents)
+    : fingerprintValue(fingerprint), version(graphVersion), stationIds(std::move(stationIds)), hubOrder(std::move(hubOrder)),
+      offsets(std::move(offsets)), hubs(std::move(hubs)), distances(std::move(distances)), parents(std::move(parents))
+{
+    indexById.reserve(this->stationIds.size());
+    for (size_t index = 0; index < this->stationIds.size(); ++index)
+    {
+        indexById[this->stationIds[index]] = static_cast<int>(index);
+    }
+}
+
+std::shared_ptr<const HubLabels> HubLabels::build(const GraphNetwork &graph, const QueryOptions &options)
+{
+    std::vector<Station> stations = graph.getStations();
+    int size = static_cast<int>(stations.size());
+    if (size == 0)
+    {
+        return nullptr;
+    }
+    std::unordered_map<int, int> indexById;
+    std::vector<int> stationIds(size);
+    for (int index = 0; index < size; ++index)
+    {
+        stationIds[index] = stations[index].getId();
+        indexById[stationIds[index]] = index;
+    }
+    // Adyacencia CSR con los pesos vigentes: los tramos cerrados no entran
+    std::vector<std::vector<std::pair<int, double>>> neighbours(size);
+    for (const auto &edge : graph.getConnections())
+    {
+        double weight = graph.getWeight(edge.from, edge.to);
+        if (std::isfinite(weight))
+        {
+            neighbours[indexById[edge.from]].push_back({indexById[edge.to], weight});
+            neighbours[indexById[edge.to]].push_back({indexById[edge.from], weight});
+        }
+    }
+    std::vector<int> firstArc(size + 1, 0);
+    for (int index = 0; index < size; ++index)
+    {
+        firstArc[index + 1] = firstArc[index] + static_cast<int>(neighbours[index].size());
+    }
+    std::vector<std::pair<int, double>> arcs;
+    arcs.reserve(firstArc.back());
+    for (auto &list : neighbours)
+    {
+        arcs.insert(arcs.end(), list.begin(), list.end());
+        std::vector<std::pair<int, double>>().swap(list);
+    }
+
+    struct Entry
+    {
+        int hub;
+        double distance;
+        int parent;
+    };
+    const double inf = std::numeric_limits<double>::infinity();
+    // Las búsquedas usan el espacio de trabajo del hilo, como las consultas: prepare reinicia distancias y padres en O(1)
+    QueryWorkspace::Lease workspace = QueryWorkspace::acquire();
+
+    // Orden de los hubs: cuántos caminos pasan por cada estación en árboles de unas pocas raíces repartidas,
+    // desempatando por grado. El grado solo sirve en redes con trasbordos marcados; en una cuadrícula todos empatan
+    // y las etiquetas crecen casi hasta n.
+    std::vector<double> score(size, 0);
+    std::vector<double> descendants(size, 0);
+    const int samples = std::min(size, kOrderSamples);
+    for (int sample = 0; sample < samples; ++sample)
+    {
+        int root = static_cast<int>(static_cast<qint64>(sample) * size / samples);
+        workspace->prepare(size);
+        // frontier guarda el orden en que se asientan las estaciones
+        std::vector<int> &settled = workspace->frontier;
+        IndexedDaryHeap<4> queue(*workspace);
+        queue.update(root, 0);
+        workspace->reach(root, 0, -1);
+        while (!queue.empty())
+        {
+            auto [dist, node] = queue.pop();
+            workspace->settle(node);
+            settled.push_back(node);
+            for (int arc = firstArc[node]; arc < firstArc[node + 1]; ++arc)
+            {
+                int target = arcs[arc].first;
+                double candidate = dist + arcs[arc].second;
+                if (candidate < workspace->distance(target))
+                {
+                    queue.update(target, candidate);
+                    workspace->reach(target, candidate, node);
+                }
+            }
+        }
+        // Tamaño de cada subárbol, de las hojas hacia la raíz
+        for (int node : settled)
+        {
+            descendants[node] = 0;
+        }
+        for (auto it = settled.rbegin(); it != settled.rend(); ++it)
+        {
+            descendants[*it] += 1;
+            score[*it] += descendants[*it];
+            int parent = workspace->parent(*it);
+            if (parent >= 0)
+            {
+                descendants[parent] += descendants[*it];
+            }
+        }
+    }
+    std::vector<int> hubOrder(size);
+    std::iota(hubOrder.begin(), hubOrder.end(), 0);
+    std::stable_sort(hubOrder.begin(), hubOrder.end(), [&](int a, int b) {
+        if (score[a] != score[b])
+        {
+            return score[a] > score[b];
+        }
+        return firstArc[a + 1] - firstArc[a] > firstArc[b + 1] - firstArc[b];
+    });
+
+    std::vector<std::vector<Entry>> labels(size);
+    std::vector<double> rootLabel(size, inf); // distancias del hub actual a los hubs de su propia etiqueta, por rango
+    for (int rank = 0; rank < size; ++rank)
+    {
+        if (options.limitStatus(rank) != QueryStatus::Completed)
+        {
+            return nullptr;
+        }
+        options.report(rank + 1, size);
+        int root = hubOrder[rank];
+        for (const Entry &entry : labels[root])
+        {
+            rootLabel[entry.hub] = entry.distance;
+        }
+        // Dijkstra podado: una estación que las etiquetas ya cubren con una distancia igual o menor no se expande
+        workspace->prepare(size);
+        IndexedDaryHeap<4> queue(*workspace);
+        queue.update(root, 0);
+        workspace->reach(root, 0, -1);
+        while (!queue.empty())
+        {
+            auto [dist, node] = queue.pop();
+            workspace->settle(node);
+            bool covered = false;
+            for (const Entry &entry : labels[node])
+            {
+                if (rootLabel[entry.hub] + entry.distance <= dist)
+                {
+                    covered = true;
+                    break;
+                }
+            }
+            if (covered)
+            {
+                continue;
+            }
+            labels[node].push_back({rank, dist, workspace->parent(node)});
+            for (int arc = firstArc[node]; arc < firstArc[node + 1]; ++arc)
+            {
+                int target = arcs[arc].first;
+                double candidate = dist + arcs[arc].second;
+                if (candidate < workspace->distance(target))
+                {
+                    queue.update(target, candidate);
+                    workspace->reach(target, candidate, node);
+                }
+            }
+        }
+        for (const Entry &entry : labels[root])
+        {
+            rootLabel[entry.hub] = inf;
+        }
+    }
+
+    std::vector<quint32> offsets(size + 1, 0);
+    for (int index = 0; index < size; ++index)
+    {
+        offsets[index + 1] = offsets[index] + static_cast<quint32>(labels[index].size());
+    }
+    std::vector<int> hubs;
+    std::vector<double> distances;
+    std::vector<int> parents;
+    hubs.reserve(offsets.back());
+    distances.reserve(offsets.back());
+    parents.reserve(offsets.back());
+    for (auto &label : labels)
+    {
+        for (const Entry &entry : label)
+        {
+            hubs.push_back(entry.hub);
+            distances.push_back(entry.distance);
+            parents.push_back(entry.parent);
+        }
+        std::vector<Entry>().swap(label);
+    }
+    return std::make_shared<const HubLabels>(fingerprint(graph), graph.getVersion(), std::move(stationIds), std::move(hubOrder),
+                                             std::move(offsets), std::move(hubs), std::move(distances), std::move(parents));
+}
+
+quint64 HubLabels::fingerprint(const GraphNetwork &graph)
+{
+    quint64 hash = LandmarkTable::fingerprint(graph);
+    for (const auto &closure : graph.getClosures())
+    {
+        quint64 value = (static_cast<quint64>(static_cast<quint32>(closure.first)) << 32) | static_cast<quint32>(closure.second);
+        hash = (hash ^ value) * 1099511628211ull;
+    }
+    return hash;
+}
+
+std::shared_ptr<const HubLabels> HubLabels::load(const QString &path, const GraphNetwork &graph)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return nullptr;
+    }
+    char magic[4];
+    quint32 format = 0;
+    quint64 storedFingerprint = 0;
+    quint32 stations = 0;
+    quint32 entries = 0;
+    bool valid = file.read(magic, sizeof(magic)) == sizeof(magic) && std::memcmp(magic, kMagic, sizeof(magic)) == 0 &&
+                 file.read(reinterpret_cast<char *>(&format), sizeof(format)) == sizeof(format) && format == kFormatVersion &&
+                 file.read(reinterpret_cast<char *>(&storedFingerprint), sizeof(storedFingerprint)) == sizeof(storedFingerprint) &&
+                 file.read(reinterpret_cast<char *>(&stations), sizeof(stations)) == sizeof(stations) &&
+                 file.read(reinterpret_cast<char *>(&entries), sizeof(entries)) == sizeof(entries);
+    if (!valid || stations == 0 || stations != graph.getStations().size() || storedFingerprint != fingerprint(graph))
+    {
+        return nullptr;
+    }
+    std::vector<int> stationIds;
+    std::vector<int> hubOrder;
+    std::vector<quint32> offsets;
+    std::vector<int> hubs;
+    std::vector<double> distances;
+    std::vector<int> parents;
+    if (!readArray(file, stationIds, stations) || !readArray(file, hubOrder, stations) || !readArray(file, offsets, stations + 1) ||
+        offsets.back() != entries || !readArray(file, hubs, entries) || !readArray(file, distances, entries) ||
+        !readArray(file, parents, entries))
+    {
+        return nullptr;
+    }
+    return std::make_shared<const HubLabels>(storedFingerprint, graph.getVersion(), std::move(stationIds), std::move(hubOrder),
+                                             std::move(offsets), std::move(hubs), std::move(distances), std::move(parents));
+}
+
+bool HubLabels::save(const QString &path) const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+    quint32 format = kFormatVersion;
+    quint32 stations = static_cast<quint32>(stationIds.size());
+    quint32 entries = static_cast<quint32>(hubs.size());
+    file.write(kMagic, sizeof(kMagic));
+    file.write(reinterpret_cast<const char *>(&format), sizeof(format));
+    file.write(reinterpret_cast<const char *>(&fingerprintValue), sizeof(fingerprintValue));
+    file.write(reinterpret_cast<const char *>(&stations), sizeof(stations));
+    file.write(reinterpret_cast<const char *>(&entries), sizeof(entries));
+    bool written = writeArray(file, stationIds) && writeArray(file, hubOrder) && writeArray(file, offsets) && writeArray(file, hubs) &&
+                   writeArray(file, distances) && writeArray(file, parents);
+    file.close();
+    return written;
+}
+
+quint64 HubLabels::graphVersion() const
+{
+    return version;
+}
+
+double HubLabels::distance(int fromId, int toId) const
+{
+    int from = indexOf(fromId);
+    int to = indexOf(toId);
+    if (from < 0 || to < 0)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    return meet(from, to).first;
+}
+
+PathDetail HubLabels::route(int fromId, int toId) const
+{
+    int from = indexOf(fromId);
+    int to = indexOf(toId);
+    if (from < 0 || to < 0)
+    {
+        return {{}, std::numeric_limits<double>::infinity()};
+    }
+    auto [total, rank] = meet(from, to);
+    if (rank < 0)
+    {
+        return {{}, total};
+    }
+    // Origen -> hub siguiendo los padres de la etiqueta de from, luego hub -> destino con los de to invertidos
+    std::vector<int> path;
+    appendPath(from, rank, path);
+    std::vector<int> tail;
+    appendPath(to, rank, tail);
+    path.insert(path.end(), tail.rbegin() + 1, tail.rend());
+    return {path, total};
+}
+
+int HubLabels::stationCount() const
+{
+    return static_cast<int>(stationIds.size());
+}
+
+qint64 HubLabels::labelEntries() const
+{
+    return static_cast<qint64>(hubs.size());
+}
+
+int HubLabels::maxLabelSize() const
+{
+    quint32 largest = 0;
+    for (size_t index = 0; index + 1 < offsets.size(); ++index)
+    {
+        largest = std::max(largest, offsets[index + 1] - offsets[index]);
+    }
+    return static_cast<int>(largest);
+}
+
+qint64 HubLabels::memoryBytes() const
+{
+    return static_cast<qint64>(sizeof(*this) + (stationIds.capacity() + hubOrder.capacity() + hubs.capacity() + parents.capacity()) * sizeof(int) +
+                               offsets.capacity() * sizeof(quint32) + distances.capacity() * sizeof(double) +
+                               indexById.size() * (sizeof(std::pair<const int, int>) + 2 * sizeof(void *)));
+}
+
+QString HubLabels::memoryReport() const
+{
+    double stations = static_cast<double>(stationIds.size());
+    double labelMb = memoryBytes() / (1024.0 * 1024.0);
+    // AllPairsTable guarda un double y un int por par
+    double tableMb = stations * stations * (sizeof(double) + sizeof(int)) / (1024.0 * 1024.0);
+    return QString("Etiquetas de hubs: %1 estaciones, %2 entradas (promedio %3, máximo %4), %5 MB; tabla de todos los pares: %6 MB")
+        .arg(stationIds.size())
+        .arg(labelEntries())
+        .arg(stations > 0 ? labelEntries() / stations : 0.0, 0, 'f', 1)
+        .arg(maxLabelSize())
+        .arg(labelMb, 0, 'f', 2)
+        .arg(tableMb, 0, 'f', 2);
+}
+
+int HubLabels::indexOf(int stationId) const
+{
+    auto it = indexById.find(stationId);
+    return it == indexById.end() ? -1 : it->second;
+}
+
+std::pair<double, int> HubLabels::meet(int from, int to) const
+{
+    std::pair<double, int> best{std::numeric_limits<double>::infinity(), -1};
+    quint32 a = offsets[from];
+    quint32 aEnd = offsets[from + 1];
+    quint32 b = offsets[to];
+    quint32 bEnd = offsets[to + 1];
+    while (a < aEnd && b < bEnd)
+    {
+        if (hubs[a] < hubs[b])
+        {
+            ++a;
+        }
+        else if (hubs[a] > hubs[b])
+        {
+            ++b;
+        }
+        else
+        {
+            double candidate = distances[a] + distances[b];
+            if (candidate < best.first)
+            {
+                best = {candidate, hubs[a]};
+            }
+            ++a;
+            ++b;
+        }
+    }
+    return best;
+}
+
+void HubLabels::appendPath(int index, int rank, std::vector<int> &path) const
+{
+    // Cada estación etiquetada por un hub tiene a su padre de esa búsqueda etiquetado por el mismo hub
+    for (int current = index; current != -1;)
+    {
+        path.push_back(stationIds[current]);
+        auto begin = hubs.begin() + offsets[current];
+        auto end = hubs.begin() + offsets[current + 1];
+        auto entry = std::lower_bound(begin, end, rank);
+        current = parents[entry - hubs.begin()];
+    }
+}
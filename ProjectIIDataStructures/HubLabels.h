@@ -0,0 +1,51 @@
+#pragma once
+
+#include "GraphNetwork.h"
+#include <QString>
+#include <QtGlobal>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Etiquetado por hubs (pruned landmark labeling): cada estación guarda sus hubs ordenados por rango con la distancia
+// a cada uno, y la distancia entre dos estaciones es el mínimo sobre los hubs comunes, una mezcla de dos listas cortas.
+// Es exacto para la red con los cierres vigentes al construirlo; cualquier cambio de versión exige reconstruir.
+class HubLabels
+{
+public:
+    // Raíces de muestra para ordenar los hubs
+    static constexpr int kOrderSamples = 16;
+
+    HubLabels(quint64 fingerprint, quint64 graphVersion, std::vector<int> stationIds, std::vector<int> hubOrder,
+              std::vector<quint32> offsets, std::vector<int> hubs, std::vector<double> distances, std::vector<int> parents);
+    // nullptr si la red no tiene estaciones o si options cortó la construcción
+    static std::shared_ptr<const HubLabels> build(const GraphNetwork &graph, const QueryOptions &options = QueryOptions());
+    // Resumen de estaciones, rutas y cierres
+    static quint64 fingerprint(const GraphNetwork &graph);
+    static std::shared_ptr<const HubLabels> load(const QString &path, const GraphNetwork &graph);
+    bool save(const QString &path) const;
+    quint64 graphVersion() const;
+    double distance(int fromId, int toId) const;
+    PathDetail route(int fromId, int toId) const;
+    int stationCount() const;
+    qint64 labelEntries() const;
+    int maxLabelSize() const;
+    qint64 memoryBytes() const;
+    // Tamaño de las etiquetas frente a la tabla de todos los pares (AllPairsTable) de la misma red
+    QString memoryReport() const;
+private:
+    quint64 fingerprintValue;
+    quint64 version;
+    std::vector<int> stationIds;
+    std::vector<int> hubOrder; // rango -> índice de estación
+    // La etiqueta de la estación i ocupa [offsets[i], offsets[i + 1]) en los tres arreglos siguientes
+    std::vector<quint32> offsets;
+    std::vector<int> hubs;          // rango del hub, creciente dentro de cada etiqueta
+    std::vector<double> distances;  // distancia al hub
+    std::vector<int> parents;       // estación anterior en el camino desde el hub, -1 en el propio hub
+    std::unordered_map<int, int> indexById;
+    int indexOf(int stationId) const;
+    // Hub común de menor distancia entre dos estaciones: {distancia, rango}, o {inf, -1}
+    std::pair<double, int> meet(int from, int to) const;
+    void appendPath(int index, int rank, std::vector<int> &path) const;
+};
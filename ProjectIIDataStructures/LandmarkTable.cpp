@@ -0,0 +1,334 @@
+#include "LandmarkTable.h"
+#include "ShortestPathTree.h"
+#include <QFile>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+
+namespace
+{
+// Cabecera del archivo: firma, versión del formato, huella de la red, estaciones y landmarks.
+// Los números se guardan en el orden de bytes de la máquina; el archivo es una caché, no un formato de intercambio.
+const char kMagic[4] = {'T', 'L', 'M', 'K'};
+const quint32 kFormatVersion = 1;
+
+quint64 mix(quint64 hash, quint64 value)
+{
+    // FNV-1a sobre los 8 bytes del valor
+    for (int byte = 0; byte < 8; ++byte)
+    {
+        hash ^= (value >> (byte * 8)) & 0xff;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Estación de mayor distancia al landmark más cercano; las que ningún landmark alcanza van primero
+int farthestCandidate(const std::vector<double> &nearest, const std::vector<char> &chosen)
+{
+    int best = -1;
+    for (size_t index = 0; index < nearest.size(); ++index)
+    {
+        if (!chosen[index] && (best < 0 || nearest[index] > nearest[best]))
+        {
+            best = static_cast<int>(index);
+        }
+    }
+    return best;
+}
+}
+
+LandmarkTable::LandmarkTable(quint64 fingerprint, quint64 routesVersion, std::vector<int> landmarkIds, std::vector<double> distances)
+    : fingerprintValue(fingerprint), routesVersionValue(routesVersion), landmarks(std::move(landmarkIds)), distances(std::move(distances))
+{
+}
+
+std::shared_ptr<const LandmarkTable> LandmarkTable::build(const GraphNetwork &graph, int count, LandmarkSelection selection,
+                                                          const QueryOptions &options)
+{
+    std::vector<Station> stations = graph.getStations();
+    int size = static_cast<int>(stations.size());
+    count = std::min(count, size);
+    if (count <= 0)
+    {
+        return nullptr;
+    }
+    GraphNetwork open = graph;
+    open.applyClosures({});
+    std::unordered_map<int, int> indexById;
+    for (int index = 0; index < size; ++index)
+    {
+        indexById[stations[index].getId()] = index;
+    }
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<int> landmarkIds;
+    std::vector<double> table(static_cast<size_t>(size) * count, inf);
+    std::vector<char> chosen(size, 0);
+    std::vector<double> nearest(size, inf);
+
+    auto treeFrom = [&](int index) -> std::shared_ptr<const ShortestPathTree> {
+        // Sin caché: estos árboles sobre la red abierta desplazarían de la caché compartida los de las consultas
+        auto tree = open.searchShortestPathTree(stations[index].getId(), options);
+        return tree && tree->status() == QueryStatus::Completed ? tree : nullptr;
+    };
+    // Cota con los landmarks elegidos hasta ahora, igual que lowerBound
+    auto boundBetween = [&](int from, int to) {
+        double bound = 0;
+        for (size_t slot = 0; slot < landmarkIds.size(); ++slot)
+        {
+            double a = table[from * static_cast<size_t>(count) + slot];
+            double b = table[to * static_cast<size_t>(count) + slot];
+            if (!std::isinf(a) || !std::isinf(b))
+            {
+                bound = std::max(bound, std::fabs(a - b));
+            }
+        }
+        return bound;
+    };
+
+    // El primer landmark es la estación más lejana de la primera; así cae en el borde de la red
+    auto seed = treeFrom(0);
+    if (!seed)
+    {
+        return nullptr;
+    }
+    for (int index = 0; index < size; ++index)
+    {
+        double distance = seed->distanceTo(stations[index].getId());
+        nearest[index] = std::isinf(distance) ? -1 : distance;
+    }
+    int next = farthestCandidate(nearest, chosen);
+    std::fill(nearest.begin(), nearest.end(), inf);
+    while (true)
+    {
+        auto tree = treeFrom(next);
+        if (!tree)
+        {
+            return nullptr;
+        }
+        size_t slot = landmarkIds.size();
+        landmarkIds.push_back(stations[next].getId());
+        chosen[next] = 1;
+        for (int index = 0; index < size; ++index)
+        {
+            double distance = tree->distanceTo(stations[index].getId());
+            table[index * static_cast<size_t>(count) + slot] = distance;
+            nearest[index] = std::min(nearest[index], distance);
+        }
+        if (static_cast<int>(landmarkIds.size()) == count)
+        {
+            break;
+        }
+        next = farthestCandidate(nearest, chosen);
+        if (selection == LandmarkSelection::Farthest || std::isinf(nearest[next]))
+        {
+            continue;
+        }
+
+        // Avoid: en el árbol de caminos de una raíz lejana, cada estación pesa lo que le falta a su cota actual.
+        // Se baja desde el subárbol más pesado sin landmarks hasta una hoja, que pasa a ser el nuevo landmark.
+        int root = next;
+        auto rootTree = treeFrom(root);
+        if (!rootTree)
+        {
+            return nullptr;
+        }
+        std::vector<int> parents(size, -1);
+        std::vector<double> weight(size, 0);
+        for (int index = 0; index < size; ++index)
+        {
+            int id = stations[index].getId();
+            if (index != root && rootTree->reaches(id))
+            {
+                parents[index] = indexById[rootTree->parentOf(id)];
+                weight[index] = rootTree->distanceTo(id) - boundBetween(root, index);
+            }
+        }
+        std::vector<int> firstChild(size + 1, 0);
+        for (int parent : parents)
+        {
+            if (parent >= 0)
+            {
+                ++firstChild[parent + 1];
+            }
+        }
+        for (int index = 0; index < size; ++index)
+        {
+            firstChild[index + 1] += firstChild[index];
+        }
+        std::vector<int> children(firstChild.back());
+        std::vector<int> fill(firstChild.begin(), firstChild.end() - 1);
+        for (int index = 0; index < size; ++index)
+        {
+            if (parents[index] >= 0)
+            {
+                children[fill[parents[index]]++] = index;
+            }
+        }
+        // Postorden iterativo: el peso de un subárbol es la suma de sus estaciones, o 0 si contiene un landmark
+        std::vector<double> subtree(weight);
+        std::vector<char> hasLandmark(chosen);
+        std::vector<int> order{root};
+        for (size_t position = 0; position < order.size(); ++position)
+        {
+            int node = order[position];
+            order.insert(order.end(), children.begin() + firstChild[node], children.begin() + firstChild[node + 1]);
+        }
+        for (auto it = order.rbegin(); it != order.rend(); ++it)
+        {
+            int node = *it;
+            if (hasLandmark[node])
+            {
+                subtree[node] = 0;
+            }
+            if (parents[node] >= 0)
+            {
+                subtree[parents[node]] += subtree[node];
+                hasLandmark[parents[node]] = hasLandmark[parents[node]] || hasLandmark[node];
+            }
+        }
+        int heaviest = *std::max_element(order.begin(), order.end(), [&subtree](int a, int b) { return subtree[a] < subtree[b]; });
+        if (subtree[heaviest] <= 0)
+        {
+            continue;
+        }
+        int leaf = heaviest;
+        while (true)
+        {
+            int best = -1;
+            for (int child = firstChild[leaf]; child < firstChild[leaf + 1]; ++child)
+            {
+                int node = children[child];
+                if (subtree[node] > 0 && (best < 0 || subtree[node] > subtree[best]))
+                {
+                    best = node;
+                }
+            }
+            if (best < 0)
+            {
+                break;
+            }
+            leaf = best;
+        }
+        next = leaf;
+    }
+    return std::make_shared<const LandmarkTable>(fingerprint(graph), graph.getRoutesVersion(), std::move(landmarkIds), std::move(table));
+}
+
+quint64 LandmarkTable::fingerprint(const GraphNetwork &graph)
+{
+    quint64 hash = 14695981039346656037ull;
+    std::vector<Station> stations = graph.getStations();
+    hash = mix(hash, stations.size());
+    for (const auto &station : stations)
+    {
+        hash = mix(hash, static_cast<quint32>(station.getId()));
+    }
+    for (const auto &edge : graph.getConnections())
+    {
+        quint64 bits;
+        std::memcpy(&bits, &edge.weight, sizeof(bits));
+        hash = mix(hash, (static_cast<quint64>(static_cast<quint32>(edge.from)) << 32) | static_cast<quint32>(edge.to));
+        hash = mix(hash, bits);
+    }
+    return hash;
+}
+
+std::shared_ptr<const LandmarkTable> LandmarkTable::load(const QString &path, const GraphNetwork &graph)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return nullptr;
+    }
+    char magic[4];
+    quint32 format = 0;
+    quint64 storedFingerprint = 0;
+    quint32 stations = 0;
+    quint32 count = 0;
+    bool valid = file.read(magic, sizeof(magic)) == sizeof(magic) && std::memcmp(magic, kMagic, sizeof(magic)) == 0 &&
+                 file.read(reinterpret_cast<char *>(&format), sizeof(format)) == sizeof(format) && format == kFormatVersion &&
+                 file.read(reinterpret_cast<char *>(&storedFingerprint), sizeof(storedFingerprint)) == sizeof(storedFingerprint) &&
+                 file.read(reinterpret_cast<char *>(&stations), sizeof(stations)) == sizeof(stations) &&
+                 file.read(reinterpret_cast<char *>(&count), sizeof(count)) == sizeof(count);
+    if (!valid || stations != graph.getStations().size() || count == 0 || count > stations || storedFingerprint != fingerprint(graph))
+    {
+        return nullptr;
+    }
+    std::vector<int> landmarkIds(count);
+    std::vector<double> distances(static_cast<size_t>(stations) * count);
+    qint64 idBytes = static_cast<qint64>(landmarkIds.size() * sizeof(int));
+    qint64 distanceBytes = static_cast<qint64>(distances.size() * sizeof(double));
+    if (file.read(reinterpret_cast<char *>(landmarkIds.data()), idBytes) != idBytes ||
+        file.read(reinterpret_cast<char *>(distances.data()), distanceBytes) != distanceBytes)
+    {
+        return nullptr;
+    }
+    return std::make_shared<const LandmarkTable>(storedFingerprint, graph.getRoutesVersion(), std::move(landmarkIds), std::move(distances));
+}
+
+bool LandmarkTable::save(const QString &path) const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+    quint32 format = kFormatVersion;
+    quint32 stations = static_cast<quint32>(stationCount());
+    quint32 count = static_cast<quint32>(landmarks.size());
+    file.write(kMagic, sizeof(kMagic));
+    file.write(reinterpret_cast<const char *>(&format), sizeof(format));
+    file.write(reinterpret_cast<const char *>(&fingerprintValue), sizeof(fingerprintValue));
+    file.write(reinterpret_cast<const char *>(&stations), sizeof(stations));
+    file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    file.write(reinterpret_cast<const char *>(landmarks.data()), static_cast<qint64>(landmarks.size() * sizeof(int)));
+    qint64 distanceBytes = static_cast<qint64>(distances.size() * sizeof(double));
+    bool written = file.write(reinterpret_cast<const char *>(distances.data()), distanceBytes) == distanceBytes;
+    file.close();
+    return written;
+}
+
+quint64 LandmarkTable::graphFingerprint() const
+{
+    return fingerprintValue;
+}
+
+quint64 LandmarkTable::routesVersion() const
+{
+    return routesVersionValue;
+}
+
+const std::vector<int> &LandmarkTable::landmarkIds() const
+{
+    return landmarks;
+}
+
+int LandmarkTable::stationCount() const
+{
+    return landmarks.empty() ? 0 : static_cast<int>(distances.size() / landmarks.size());
+}
+
+double LandmarkTable::lowerBound(int fromIndex, int toIndex) const
+{
+    size_t count = landmarks.size();
+    const double *from = &distances[fromIndex * count];
+    const double *to = &distances[toIndex * count];
+    double bound = 0;
+    for (size_t slot = 0; slot < count; ++slot)
+    {
+        // Un landmark que no alcanza a ninguna de las dos no aporta; si alcanza a una sola, no hay camino entre ellas
+        if (!std::isinf(from[slot]) || !std::isinf(to[slot]))
+        {
+            bound = std::max(bound, std::fabs(from[slot] - to[slot]));
+        }
+    }
+    return bound;
+}
+
+qint64 LandmarkTable::memoryBytes() const
+{
+    return static_cast<qint64>(sizeof(*this) + landmarks.capacity() * sizeof(int) + distances.capacity() * sizeof(double));
+}
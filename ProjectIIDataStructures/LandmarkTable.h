@@ -0,0 +1,46 @@
+#pragma once
+
+#include "GraphNetwork.h"
+#include <QString>
+#include <QtGlobal>
+#include <memory>
+#include <vector>
+
+enum class LandmarkSelection
+{
+    Farthest, // cada landmark es la estación más lejana de los ya elegidos
+    Avoid     // Goldberg-Werneck: se evitan las zonas que los landmarks actuales ya acotan bien
+};
+
+// Distancias desde k estaciones de referencia (landmarks) a todas las demás, para las cotas de A* (ALT).
+// Se calculan sobre la red sin cierres: un cierre solo alarga caminos, así que las cotas siguen valiendo
+// hasta que cambian las rutas o las estaciones (ver GraphNetwork::getRoutesVersion).
+class LandmarkTable
+{
+public:
+    static constexpr int kDefaultLandmarks = 8;
+
+    LandmarkTable(quint64 fingerprint, quint64 routesVersion, std::vector<int> landmarkIds, std::vector<double> distances);
+    // nullptr si la red no tiene estaciones o si options cortó el cálculo
+    static std::shared_ptr<const LandmarkTable> build(const GraphNetwork &graph, int count = kDefaultLandmarks,
+                                                      LandmarkSelection selection = LandmarkSelection::Avoid,
+                                                      const QueryOptions &options = QueryOptions());
+    // Resumen de estaciones y rutas (sin cierres); decide si una tabla guardada sirve para la red cargada
+    static quint64 fingerprint(const GraphNetwork &graph);
+    // nullptr si el archivo no existe, está dañado o corresponde a otra red
+    static std::shared_ptr<const LandmarkTable> load(const QString &path, const GraphNetwork &graph);
+    bool save(const QString &path) const;
+    quint64 graphFingerprint() const;
+    quint64 routesVersion() const;
+    const std::vector<int> &landmarkIds() const;
+    int stationCount() const;
+    // Cota inferior del tiempo entre las estaciones de índices fromIndex y toIndex; inf si no están conectadas
+    double lowerBound(int fromIndex, int toIndex) const;
+    qint64 memoryBytes() const;
+private:
+    quint64 fingerprintValue;
+    quint64 routesVersionValue;
+    std::vector<int> landmarks;
+    // Por estación, sus distancias a cada landmark contiguas: la cota lee dos bloques de k valores
+    std::vector<double> distances;
+};
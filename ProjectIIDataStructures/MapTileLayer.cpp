@@ -0,0 +1,246 @@
+#include "MapTileLayer.h"
+#include <QBuffer>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <algorithm>
+#include <cmath>
+
+MapTilePyramid::MapTilePyramid()
+{
+}
+
+MapTilePyramid::MapTilePyramid(const QImage &source, int cacheLimitKb)
+{
+    tileCache.setMaxCost(cacheLimitKb);
+    baseSize = source.size();
+    build(source);
+}
+
+MapTilePyramid::MapTilePyramid(const QImage &source, const QSize &sceneSize, int cacheLimitKb)
+{
+    // Permite una vista previa de baja resolución que ocupa el tamaño completo del mapa en la escena
+    tileCache.setMaxCost(cacheLimitKb);
+    baseSize = sceneSize.isValid() ? sceneSize : source.size();
+    build(source);
+}
+
+void MapTilePyramid::build(const QImage &source)
+{
+    if (source.isNull() || baseSize.isEmpty())
+    {
+        return;
+    }
+    QImage current = source.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    while (true)
+    {
+        Level level;
+        level.size = current.size();
+        level.columns = (level.size.width() + kTileSize - 1) / kTileSize;
+        level.rows = (level.size.height() + kTileSize - 1) / kTileSize;
+        level.tiles.reserve(static_cast<size_t>(level.columns) * static_cast<size_t>(level.rows));
+        for (int row = 0; row < level.rows; ++row)
+        {
+            for (int column = 0; column < level.columns; ++column)
+            {
+                int width = std::min(kTileSize, level.size.width() - column * kTileSize);
+                int height = std::min(kTileSize, level.size.height() - row * kTileSize);
+                QByteArray encoded;
+                QBuffer buffer(&encoded);
+                buffer.open(QIODevice::WriteOnly);
+                current.copy(column * kTileSize, row * kTileSize, width, height).save(&buffer, "PNG");
+                level.tiles.push_back(std::move(encoded));
+            }
+        }
+        levels.push_back(std::move(level));
+        if (current.width() <= kTileSize && current.height() <= kTileSize)
+        {
+            break;
+        }
+        // Cada nivel de la pirámide tiene la mitad de resolución que el anterior
+        QSize half((current.width() + 1) / 2, (current.height() + 1) / 2);
+        current = current.scaled(half, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    }
+}
+
+bool MapTilePyramid::isNull() const
+{
+    return levels.empty();
+}
+
+QSize MapTilePyramid::size() const
+{
+    return baseSize;
+}
+
+int MapTilePyramid::levelCount() const
+{
+    return static_cast<int>(levels.size());
+}
+
+int MapTilePyramid::levelForScale(qreal scale) const
+{
+    if (levels.empty() || !std::isfinite(scale) || scale <= 0.0)
+    {
+        return 0;
+    }
+    qreal resolution = static_cast<qreal>(levels.front().size.width()) / static_cast<qreal>(baseSize.width());
+    if (scale >= resolution)
+    {
+        return 0;
+    }
+    int level = static_cast<int>(std::floor(std::log2(resolution / scale)));
+    return std::clamp(level, 0, static_cast<int>(levels.size()) - 1);
+}
+
+QSize MapTilePyramid::levelSize(int level) const
+{
+    if (level < 0 || level >= static_cast<int>(levels.size()))
+    {
+        return QSize();
+    }
+    return levels[level].size;
+}
+
+int MapTilePyramid::columns(int level) const
+{
+    if (level < 0 || level >= static_cast<int>(levels.size()))
+    {
+        return 0;
+    }
+    return levels[level].columns;
+}
+
+int MapTilePyramid::rows(int level) const
+{
+    if (level < 0 || level >= static_cast<int>(levels.size()))
+    {
+        return 0;
+    }
+    return levels[level].rows;
+}
+
+QRectF MapTilePyramid::tileSceneRect(int level, int column, int row) const
+{
+    if (level < 0 || level >= static_cast<int>(levels.size()))
+    {
+        return QRectF();
+    }
+    const Level &data = levels[level];
+    qreal scaleX = static_cast<qreal>(baseSize.width()) / static_cast<qreal>(data.size.width());
+    qreal scaleY = static_cast<qreal>(baseSize.height()) / static_cast<qreal>(data.size.height());
+    qreal width = std::min(kTileSize, data.size.width() - column * kTileSize);
+    qreal height = std::min(kTileSize, data.size.height() - row * kTileSize);
+    return QRectF(column * kTileSize * scaleX, row * kTileSize * scaleY, width * scaleX, height * scaleY);
+}
+
+QPixmap MapTilePyramid::tile(int level, int column, int row)
+{
+    if (level < 0 || level >= static_cast<int>(levels.size()))
+    {
+        return QPixmap();
+    }
+    const Level &data = levels[level];
+    if (column < 0 || row < 0 || column >= data.columns || row >= data.rows)
+    {
+        return QPixmap();
+    }
+    quint64 key = tileKey(level, column, row);
+    if (QPixmap *cached = tileCache.object(key))
+    {
+        return *cached;
+    }
+    QImage image = QImage::fromData(data.tiles[static_cast<size_t>(row) * data.columns + column], "PNG");
+    if (image.isNull())
+    {
+        return QPixmap();
+    }
+    auto *pixmap = new QPixmap(QPixmap::fromImage(image));
+    QPixmap result = *pixmap;
+    int cost = std::max(1, static_cast<int>(image.sizeInBytes() / 1024));
+    tileCache.insert(key, pixmap, cost);
+    return result;
+}
+
+void MapTilePyramid::setCacheLimit(int kilobytes)
+{
+    tileCache.setMaxCost(kilobytes);
+}
+
+qint64 MapTilePyramid::memoryBytes() const
+{
+    qint64 total = 0;
+    for (const auto &level : levels)
+    {
+        for (const auto &encoded : level.tiles)
+        {
+            total += encoded.size();
+        }
+    }
+    return total;
+}
+
+quint64 MapTilePyramid::tileKey(int level, int column, int row)
+{
+    return (static_cast<quint64>(level) << 48) | (static_cast<quint64>(column & 0xFFFFFF) << 24) | static_cast<quint64>(row & 0xFFFFFF);
+}
+
+MapTileLayer::MapTileLayer(std::shared_ptr<MapTilePyramid> pyramid, QGraphicsItem *parent)
+    : QGraphicsItem(parent), pyramid(std::move(pyramid))
+{
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption, true);
+    setAcceptedMouseButtons(Qt::NoButton);
+}
+
+void MapTileLayer::setPyramid(std::shared_ptr<MapTilePyramid> replacement)
+{
+    prepareGeometryChange();
+    pyramid = std::move(replacement);
+    update();
+}
+
+QRectF MapTileLayer::boundingRect() const
+{
+    if (!pyramid || pyramid->isNull())
+    {
+        return QRectF();
+    }
+    return QRectF(QPointF(0.0, 0.0), QSizeF(pyramid->size()));
+}
+
+void MapTileLayer::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(widget);
+    if (!pyramid || pyramid->isNull())
+    {
+        return;
+    }
+    QRectF exposed = option->exposedRect.isNull() ? boundingRect() : option->exposedRect.intersected(boundingRect());
+    if (exposed.isEmpty())
+    {
+        return;
+    }
+    // Solo se pintan los mosaicos visibles del nivel que corresponde al zoom actual
+    qreal scale = QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+    int level = pyramid->levelForScale(scale);
+    QSize levelSize = pyramid->levelSize(level);
+    QSize baseSize = pyramid->size();
+    qreal tileWidth = MapTilePyramid::kTileSize * static_cast<qreal>(baseSize.width()) / levelSize.width();
+    qreal tileHeight = MapTilePyramid::kTileSize * static_cast<qreal>(baseSize.height()) / levelSize.height();
+    int firstColumn = std::max(0, static_cast<int>(std::floor(exposed.left() / tileWidth)));
+    int lastColumn = std::min(pyramid->columns(level) - 1, static_cast<int>(std::floor(exposed.right() / tileWidth)));
+    int firstRow = std::max(0, static_cast<int>(std::floor(exposed.top() / tileHeight)));
+    int lastRow = std::min(pyramid->rows(level) - 1, static_cast<int>(std::floor(exposed.bottom() / tileHeight)));
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
+    for (int row = firstRow; row <= lastRow; ++row)
+    {
+        for (int column = firstColumn; column <= lastColumn; ++column)
+        {
+            QPixmap tilePixmap = pyramid->tile(level, column, row);
+            if (tilePixmap.isNull())
+            {
+                continue;
+            }
+            painter->drawPixmap(pyramid->tileSceneRect(level, column, row), tilePixmap, QRectF(tilePixmap.rect()));
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QByteArray>
+#include <QCache>
+#include <QGraphicsItem>
+#include <QImage>
+#include <QPixmap>
+#include <QRectF>
+#include <QSize>
+#include <memory>
+#include <vector>
+
+// Los mosaicos de todos los niveles se guardan comprimidos en PNG; solo los que se pintan se decodifican, y esos
+// pixmaps son los que limita la caché. Así la memoria es la del mapa comprimido más el tope de la caché
+class MapTilePyramid
+{
+public:
+    static constexpr int kTileSize = 256;
+    static constexpr int kDefaultCacheKb = 96 * 1024;
+
+    MapTilePyramid();
+    explicit MapTilePyramid(const QImage &source, int cacheLimitKb = kDefaultCacheKb);
+    MapTilePyramid(const QImage &source, const QSize &sceneSize, int cacheLimitKb = kDefaultCacheKb);
+    bool isNull() const;
+    QSize size() const;
+    int levelCount() const;
+    int levelForScale(qreal scale) const;
+    QSize levelSize(int level) const;
+    int columns(int level) const;
+    int rows(int level) const;
+    QRectF tileSceneRect(int level, int column, int row) const;
+    QPixmap tile(int level, int column, int row);
+    void setCacheLimit(int kilobytes);
+    // Bytes de los mosaicos comprimidos, sin contar la caché de pixmaps
+    qint64 memoryBytes() const;
+private:
+    struct Level
+    {
+        QSize size;
+        int columns;
+        int rows;
+        std::vector<QByteArray> tiles;
+    };
+    QSize baseSize;
+    std::vector<Level> levels;
+    QCache<quint64, QPixmap> tileCache;
+    void build(const QImage &source);
+    static quint64 tileKey(int level, int column, int row);
+};
+
+class MapTileLayer : public QGraphicsItem
+{
+public:
+    explicit MapTileLayer(std::shared_ptr<MapTilePyramid> pyramid, QGraphicsItem *parent = nullptr);
+    void setPyramid(std::shared_ptr<MapTilePyramid> replacement);
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
+private:
+    std::shared_ptr<MapTilePyramid> pyramid;
+};
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "GraphNetwork.h"
+#include "StationTree.h"
+#include <QtGlobal>
+#include <memory>
+
+// Versión inmutable de la red; se puede leer desde cualquier hilo sin bloqueo
+struct NetworkSnapshot
+{
+    std::shared_ptr<const StationTree> tree;
+    std::shared_ptr<const GraphNetwork> graph;
+    quint64 version = 0;
+};
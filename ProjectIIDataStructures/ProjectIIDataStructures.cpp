@@ -1,20 +1,26 @@
 #include "ProjectIIDataStructures.h"
+#include "EdgeLayerItem.h"
+#include "StationSearchModel.h"
 #include <QBrush>
+#include <QBuffer>
 #include <QColor>
 #include <QComboBox>
+#include <QCompleter>
 #include <QCoreApplication>
 #include <QDir>
 #include <QFile>
 #include <QFileDialog>
 #include <QFont>
+#include <QFutureWatcher>
 #include <QGraphicsEllipseItem>
 #include <QGraphicsRectItem>
-#include <QGraphicsPixmapItem>
 #include <QGraphicsItem>
 #include <QGraphicsPathItem>
 #include <QGraphicsTextItem>
 #include <QGraphicsView>
 #include <QHeaderView>
+#include <QImage>
+#include <QImageReader>
 #include <QInputDialog>
 #include <QLineEdit>
 #include <QMessageBox>
@@ -25,6 +31,8 @@
 #include <QPainterPath>
 #include <QPen>
 #include <QPixmap>
+#include <QProgressBar>
+#include <QPromise>
 #include <QSize>
 #include <QSignalBlocker>
 #include <QTransform>
@@ -32,6 +40,7 @@
 #include <QRadialGradient>
 #include <QSizeF>
 #include <QStringList>
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtMath>
 #include <algorithm>
 #include <set>
@@ -42,13 +51,20 @@
 namespace
 {
 constexpr int kStationItemRole = 1;
+constexpr int kMapPreviewSide = 1024;
 }
 
 ProjectIIDataStructures::ProjectIIDataStructures(QWidget *parent)
     : QMainWindow(parent),
       stationIdValidator(new QIntValidator(1, 999999, this)),
       graphScene(new QGraphicsScene(this)),
-      mapPixmapItem(nullptr)
+      stationModel(new StationTableModel(manager, this)),
+      routeModel(new RouteTableModel(manager, this)),
+      stationListModel(new StationListModel(manager, this)),
+      mapTileLayer(nullptr),
+      mapLoadGeneration(0),
+      mapLoadPending(false),
+      algorithmGeneration(0)
 {
     ui.setupUi(this);
     ui.graphView->setScene(graphScene);
@@ -66,6 +82,10 @@ ProjectIIDataStructures::ProjectIIDataStructures(QWidget *parent)
 
 ProjectIIDataStructures::~ProjectIIDataStructures()
 {
+    if (algorithmCancel)
+    {
+        *algorithmCancel = true;
+    }
 }
 
 void ProjectIIDataStructures::closeEvent(QCloseEvent *event)
@@ -76,8 +96,18 @@ void ProjectIIDataStructures::closeEvent(QCloseEvent *event)
 
 void ProjectIIDataStructures::setupUiBehavior()
 {
+    ui.stationTable->setModel(stationModel);
+    ui.routeTable->setModel(routeModel);
     ui.stationTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
     ui.routeTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    // Filas de alto fijo para que la vista no mida cada fila con tablas grandes
+    ui.stationTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    ui.routeTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    attachStationSearch(ui.routeOriginCombo);
+    attachStationSearch(ui.routeDestinationCombo);
+    attachStationSearch(ui.traversalStartCombo);
+    attachStationSearch(ui.shortestStartCombo);
+    attachStationSearch(ui.shortestEndCombo);
     ui.routeTimeSpin->setDecimals(2);
     ui.routeTimeSpin->setMinimum(0.10);
     ui.routeTimeSpin->setSingleStep(0.50);
@@ -100,7 +130,7 @@ void ProjectIIDataStructures::setupUiBehavior()
             displayMessage("Estación registrada con éxito.");
             ui.stationIdEdit->clear();
             ui.stationNameEdit->clear();
-            refreshAll();
+            applyStationAdded(id);
         }
         else
         {
@@ -117,7 +147,7 @@ void ProjectIIDataStructures::setupUiBehavior()
         if (manager.removeStation(id))
         {
             displayMessage("Estación eliminada correctamente.");
-            refreshAll();
+            applyStationRemoved(id);
         }
         else
         {
@@ -167,7 +197,9 @@ void ProjectIIDataStructures::setupUiBehavior()
                 message = "Ruta registrada exitosamente.";
             }
             displayMessage(message);
-            refreshRoutes();
+            routeModel->routeAdded(selection.first, selection.second);
+            highlightedTreeEdges.clear();
+            refreshGraphVisualization();
             refreshClosures();
             updateRouteTimeSuggestion();
         }
@@ -180,17 +212,10 @@ void ProjectIIDataStructures::setupUiBehavior()
         auto selection = selectedRoute();
         if (selection.first <= 0 || selection.second <= 0)
         {
-            if (ui.routeTable->currentRow() >= 0)
+            QModelIndex current = ui.routeTable->currentIndex();
+            if (current.isValid())
             {
-                int row = ui.routeTable->currentRow();
-                bool okFrom = false;
-                bool okTo = false;
-                int fromId = ui.routeTable->item(row, 0)->data(Qt::UserRole).toInt(&okFrom);
-                int toId = ui.routeTable->item(row, 1)->data(Qt::UserRole).toInt(&okTo);
-                if (okFrom && okTo)
-                {
-                    selection = {fromId, toId};
-                }
+                selection = routeModel->routeAt(current.row());
             }
         }
         if (selection.first <= 0 || selection.second <= 0)
@@ -201,7 +226,9 @@ void ProjectIIDataStructures::setupUiBehavior()
         if (manager.removeRoute(selection.first, selection.second))
         {
             displayMessage("Ruta eliminada correctamente.");
-            refreshRoutes();
+            routeModel->routeRemoved(selection.first, selection.second);
+            highlightedTreeEdges.clear();
+            refreshGraphVisualization();
             refreshClosures();
         }
         else
@@ -221,40 +248,7 @@ void ProjectIIDataStructures::setupUiBehavior()
         {
             return;
         }
-        QPixmap pixmap(filePath);
-        if (pixmap.isNull())
-        {
-            displayError("No se pudo cargar la imagen seleccionada.");
-            return;
-        }
-        QSize originalSize = pixmap.size();
-        if (!applyMapPixmap(pixmap, true))
-        {
-            displayError("No se pudo preparar el mapa seleccionado.");
-            return;
-        }
-        if (!persistMapPixmap(loadedMapPixmap))
-        {
-            displayError("No se pudo guardar la imagen seleccionada como mapa.");
-            return;
-        }
-        QSize scaledSize = loadedMapPixmap.size();
-        QString detail = QString(" (%1×%2 px)")
-                              .arg(QString::number(scaledSize.width()),
-                                   QString::number(scaledSize.height()));
-        if (scaledSize != originalSize)
-        {
-            detail = QString(" (%1×%2 px, ajustado desde %3×%4 px)")
-                         .arg(QString::number(scaledSize.width()),
-                              QString::number(scaledSize.height()),
-                              QString::number(originalSize.width()),
-                              QString::number(originalSize.height()));
-        }
-        displayMessage(QString("Mapa de fondo actualizado y almacenado%1.").arg(detail));
-        
-        // Regenerar rutas automáticas después de cargar un nuevo mapa
-        manager.regenerateAllAutomaticRoutes(3);
-        refreshAll();
+        startMapLoad(filePath, true);
     });
     connect(ui.clearMapButton, &QPushButton::clicked, this, [this]() {
         if (!mapIsActive())
@@ -274,26 +268,21 @@ void ProjectIIDataStructures::setupUiBehavior()
             displayError("Seleccione una estación de inicio.");
             return;
         }
-        std::vector<int> result;
-        if (ui.traversalCombo->currentText() == "BFS")
-        {
-            result = manager.runBfs(startId);
-        }
-        else
-        {
-            result = manager.runDfs(startId);
-        }
-        if (result.empty())
-        {
-            ui.resultText->setText("No hay recorrido disponible.");
-            displayError("No fue posible realizar el recorrido.");
-        }
-        else
-        {
-            QString text = QString("Recorrido %1:\n%2").arg(ui.traversalCombo->currentText(), joinStations(result));
-            ui.resultText->setText(text);
-            displayMessage("Recorrido generado con éxito.");
-        }
+        QString name = ui.traversalCombo->currentText();
+        startAlgorithm(name, [startId, name](const NetworkSnapshot &snapshot, const QueryOptions &options) {
+            TraversalDetail detail = name == "BFS" ? snapshot.graph->bfs(startId, options) : snapshot.graph->dfs(startId, options);
+            AlgorithmOutcome outcome;
+            outcome.status = detail.status;
+            if (detail.stations.empty())
+            {
+                outcome.text = "No hay recorrido disponible.";
+                outcome.error = "No fue posible realizar el recorrido.";
+                return outcome;
+            }
+            outcome.text = QString("Recorrido %1:\n%2").arg(name, joinStations(*snapshot.tree, detail.stations));
+            outcome.message = "Recorrido generado con éxito.";
+            return outcome;
+        });
     });
     connect(ui.runShortestButton, &QPushButton::clicked, this, [this]() {
         int startId = ui.shortestStartCombo->currentData().toInt();
@@ -303,60 +292,39 @@ void ProjectIIDataStructures::setupUiBehavior()
             displayError("Seleccione estaciones válidas.");
             return;
         }
-        PathDetail detail;
-        if (ui.shortestCombo->currentText() == "Dijkstra")
-        {
-            detail = manager.runDijkstra(startId, endId);
-        }
-        else
-        {
-            detail = manager.runFloyd(startId, endId);
-        }
-        if (detail.stations.empty() || !std::isfinite(detail.total))
-        {
-            ui.resultText->setText("No se encontró un camino disponible.");
-            displayError("No existe una ruta válida entre las estaciones seleccionadas.");
-        }
-        else
-        {
-            QString text = QString("Ruta óptima (%1 minutos):\n%2").arg(QString::number(detail.total, 'f', 2), joinStations(detail.stations));
-            ui.resultText->setText(text);
-            displayMessage("Ruta calculada correctamente.");
-        }
+        QString name = ui.shortestCombo->currentText();
+        startAlgorithm(name, [startId, endId, name](const NetworkSnapshot &snapshot, const QueryOptions &options) {
+            PathDetail detail = name == "Dijkstra" ? snapshot.graph->dijkstra(startId, endId, options) : snapshot.graph->floydWarshall(startId, endId, options);
+            AlgorithmOutcome outcome;
+            outcome.status = detail.status;
+            if (detail.stations.empty() || !std::isfinite(detail.total))
+            {
+                outcome.text = "No se encontró un camino disponible.";
+                outcome.error = "No existe una ruta válida entre las estaciones seleccionadas.";
+                return outcome;
+            }
+            outcome.text = QString("Ruta óptima (%1 minutos):\n%2").arg(QString::number(detail.total, 'f', 2), joinStations(*snapshot.tree, detail.stations));
+            outcome.message = "Ruta calculada correctamente.";
+            return outcome;
+        });
     });
     connect(ui.runPrimButton, &QPushButton::clicked, this, [this]() {
-        TreeDetail detail = manager.runPrim();
-        if (detail.edges.empty())
-        {
-            ui.resultText->setText("No se pudo construir un árbol de expansión.");
-            displayError("No hay conexiones suficientes para generar el árbol.");
-            return;
-        }
-        QStringList lines;
-        lines << QString("Árbol mínimo Prim (%1 minutos):").arg(QString::number(detail.total, 'f', 2));
-        for (const auto &edge : detail.edges)
-        {
-            lines << QString("%1 ⇄ %2 : %3").arg(QString::number(edge.from), QString::number(edge.to), QString::number(edge.weight, 'f', 2));
-        }
-        ui.resultText->setText(lines.join('\n'));
-        displayMessage("Árbol mínimo Prim generado.");
+        startAlgorithm("Prim", [](const NetworkSnapshot &snapshot, const QueryOptions &options) {
+            return describeTree("Prim", snapshot.graph->prim(options));
+        });
     });
     connect(ui.runKruskalButton, &QPushButton::clicked, this, [this]() {
-        TreeDetail detail = manager.runKruskal();
-        if (detail.edges.empty())
-        {
-            ui.resultText->setText("No se pudo construir un árbol de expansión.");
-            displayError("No hay conexiones suficientes para generar el árbol.");
-            return;
-        }
-        QStringList lines;
-        lines << QString("Árbol mínimo Kruskal (%1 minutos):").arg(QString::number(detail.total, 'f', 2));
-        for (const auto &edge : detail.edges)
+        startAlgorithm("Kruskal", [](const NetworkSnapshot &snapshot, const QueryOptions &options) {
+            return describeTree("Kruskal", snapshot.graph->kruskal(options));
+        });
+    });
+    connect(ui.cancelAlgorithmButton, &QPushButton::clicked, this, [this]() {
+        if (algorithmCancel)
         {
-            lines << QString("%1 ⇄ %2 : %3").arg(QString::number(edge.from), QString::number(edge.to), QString::number(edge.weight, 'f', 2));
+            *algorithmCancel = true;
+            ui.cancelAlgorithmButton->setEnabled(false);
+            displayMessage("Cancelando el algoritmo en curso...");
         }
-        ui.resultText->setText(lines.join('\n'));
-        displayMessage("Árbol mínimo Kruskal generado.");
     });
     connect(ui.showStationsButton, &QPushButton::clicked, this, [this]() {
         QString report = manager.buildStationsReport();
@@ -387,40 +355,15 @@ void ProjectIIDataStructures::setupUiBehavior()
 
 void ProjectIIDataStructures::refreshStations()
 {
-    auto stations = manager.getStations();
-    ui.stationTable->setRowCount(static_cast<int>(stations.size()));
-    int row = 0;
-    for (const auto &station : stations)
-    {
-        auto idItem = new QTableWidgetItem(QString::number(station.getId()));
-        idItem->setData(Qt::UserRole, station.getId());
-        auto nameItem = new QTableWidgetItem(station.getName());
-        ui.stationTable->setItem(row, 0, idItem);
-        ui.stationTable->setItem(row, 1, nameItem);
-        row++;
-    }
+    stationModel->reload();
+    highlightedTreeEdges.clear();
     refreshGraphVisualization();
 }
 
 void ProjectIIDataStructures::refreshRoutes()
 {
-    auto routes = manager.getRoutes();
-    ui.routeTable->setRowCount(static_cast<int>(routes.size()));
-    int row = 0;
-    for (const auto &route : routes)
-    {
-        auto originItem = new QTableWidgetItem(QString::number(route.from));
-        originItem->setData(Qt::UserRole, route.from);
-        originItem->setText(QString::number(route.from) + " - " + manager.getStationName(route.from));
-        auto destinationItem = new QTableWidgetItem(QString::number(route.to));
-        destinationItem->setData(Qt::UserRole, route.to);
-        destinationItem->setText(QString::number(route.to) + " - " + manager.getStationName(route.to));
-        auto timeItem = new QTableWidgetItem(QString::number(route.weight, 'f', 2));
-        ui.routeTable->setItem(row, 0, originItem);
-        ui.routeTable->setItem(row, 1, destinationItem);
-        ui.routeTable->setItem(row, 2, timeItem);
-        row++;
-    }
+    routeModel->reload();
+    highlightedTreeEdges.clear();
     refreshGraphVisualization();
 }
 
@@ -439,26 +382,47 @@ void ProjectIIDataStructures::refreshClosures()
         QString text = QString("%1 ⇄ %2").arg(QString::number(closure.first), QString::number(closure.second));
         ui.closuresList->addItem(text);
     }
+    highlightedTreeEdges.clear();
+    refreshGraphVisualization();
+}
+
+void ProjectIIDataStructures::highlightTree(const TreeDetail &detail)
+{
+    highlightedTreeEdges.clear();
+    for (const auto &edge : detail.edges)
+    {
+        highlightedTreeEdges.insert({std::min(edge.from, edge.to), std::max(edge.from, edge.to)});
+    }
     refreshGraphVisualization();
 }
 
 void ProjectIIDataStructures::refreshCombos()
 {
-    auto stations = manager.getStations();
-    auto fillCombo = [](QComboBox *combo, const std::vector<Station> &stationList) {
-        combo->clear();
-        combo->addItem("Seleccione", 0);
-        for (const auto &station : stationList)
+    stationListModel->reload();
+    updateRouteTimeSuggestion();
+}
+
+void ProjectIIDataStructures::attachStationSearch(QComboBox *combo)
+{
+    // Todos los combos comparten el mismo modelo; cada uno filtra con su propio completador
+    combo->setEditable(true);
+    combo->setInsertPolicy(QComboBox::NoInsert);
+    combo->setModel(stationListModel);
+    auto *searchModel = new StationSearchModel(*stationListModel, combo);
+    auto *completer = new QCompleter(searchModel, combo);
+    completer->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    combo->lineEdit()->setCompleter(completer);
+    connect(combo->lineEdit(), &QLineEdit::textEdited, combo, [searchModel, completer](const QString &text) {
+        searchModel->setQuery(text);
+        completer->complete();
+    });
+    connect(completer, static_cast<void (QCompleter::*)(const QModelIndex &)>(&QCompleter::activated), combo, [this, combo, searchModel](const QModelIndex &index) {
+        int row = stationListModel->rowForStation(searchModel->stationIdAt(index.row()));
+        if (row > 0)
         {
-            combo->addItem(QString::number(station.getId()) + " - " + station.getName(), station.getId());
+            combo->setCurrentIndex(row);
         }
-    };
-    fillCombo(ui.routeOriginCombo, stations);
-    fillCombo(ui.routeDestinationCombo, stations);
-    fillCombo(ui.traversalStartCombo, stations);
-    fillCombo(ui.shortestStartCombo, stations);
-    fillCombo(ui.shortestEndCombo, stations);
-    updateRouteTimeSuggestion();
+    });
 }
 
 void ProjectIIDataStructures::refreshAll()
@@ -469,6 +433,28 @@ void ProjectIIDataStructures::refreshAll()
     refreshCombos();
 }
 
+void ProjectIIDataStructures::applyStationAdded(int stationId)
+{
+    // Solo se insertan las filas nuevas en lugar de reconstruir las tablas completas
+    stationModel->stationAdded(stationId);
+    routeModel->syncStationRoutes(stationId);
+    stationListModel->stationAdded(stationId);
+    highlightedTreeEdges.clear();
+    refreshGraphVisualization();
+    updateRouteTimeSuggestion();
+}
+
+void ProjectIIDataStructures::applyStationRemoved(int stationId)
+{
+    stationModel->stationRemoved(stationId);
+    routeModel->stationRemoved(stationId);
+    stationListModel->stationRemoved(stationId);
+    highlightedTreeEdges.clear();
+    refreshGraphVisualization();
+    refreshClosures();
+    updateRouteTimeSuggestion();
+}
+
 void ProjectIIDataStructures::refreshGraphVisualization()
 {
     if (!graphScene || !ui.graphView)
@@ -477,7 +463,7 @@ void ProjectIIDataStructures::refreshGraphVisualization()
     }
     bool hasMap = mapIsActive();
     graphScene->clear();
-    mapPixmapItem = nullptr;
+    mapTileLayer = nullptr;
     if (hasMap)
     {
         addMapItemToScene();
@@ -566,16 +552,17 @@ void ProjectIIDataStructures::refreshGraphVisualization()
     const QColor nodeFill(59, 130, 246); // Azul moderno (Blue-500)
     const QColor nodeHoverFill(96, 165, 250); // Azul más claro para hover
     const QColor nodeBorder(30, 64, 175); // Azul oscuro (Blue-800)
-    const QColor edgeColor(99, 102, 241); // Índigo moderno (Indigo-500)
-    const QColor edgeLabelBg(255, 255, 255, 230); // Fondo más opaco
-    const QColor closedColor(239, 68, 68); // Rojo moderno (Red-500)
-    const QColor closureLabelBg(239, 68, 68, 140); // Rojo semitransparente
     
     // Fuentes mejoradas con mejor legibilidad - texto un poco más grande
     const QFont edgeFont("Segoe UI", 10, QFont::Bold); // Aumentado de 9 a 10
     const QFont nodeFont("Segoe UI", 11, QFont::Bold); // Aumentado de 10 a 11
 
-    // Dibujar aristas primero con mejor estilo
+    // Todas las aristas viven en una sola capa con búfer contiguo e índice espacial propio
+    auto *edgeLayer = new EdgeLayerItem();
+    edgeLayer->setLabelFont(edgeFont);
+    edgeLayer->setZValue(0);
+    edgeLayer->reserve(routes.size(), routes.size() * 4);
+    std::vector<QPointF> pathPoints;
     for (const auto &edge : routes)
     {
         auto fromIt = positions.find(edge.from);
@@ -587,19 +574,17 @@ void ProjectIIDataStructures::refreshGraphVisualization()
         QPointF fromPoint = fromIt->second;
         QPointF toPoint = toIt->second;
         std::pair<int, int> normalizedPair = {std::min(edge.from, edge.to), std::max(edge.from, edge.to)};
-        bool isClosed = closureSet.find(normalizedPair) != closureSet.end();
-
-        // Líneas más gruesas y con mejor estilo
-        QPen pen(isClosed ? closedColor : edgeColor, isClosed ? 4.5 : 3.5);
-        if (isClosed)
+        EdgeLayerItem::EdgeStyle style = EdgeLayerItem::EdgeStyle::Open;
+        if (closureSet.find(normalizedPair) != closureSet.end())
         {
-            pen.setStyle(Qt::DashLine);
-            pen.setDashPattern({8.0, 4.0}); // Patrón de guiones personalizado
+            style = EdgeLayerItem::EdgeStyle::Closed;
         }
-        pen.setCapStyle(Qt::RoundCap);
-        pen.setJoinStyle(Qt::RoundJoin);
-        
-        std::vector<QPointF> pathPoints;
+        else if (highlightedTreeEdges.find(normalizedPair) != highlightedTreeEdges.end())
+        {
+            style = EdgeLayerItem::EdgeStyle::Mst;
+        }
+
+        pathPoints.clear();
         pathPoints.push_back(fromPoint);
 
         if (hasMap && mapSceneRect.contains(fromPoint) && mapSceneRect.contains(toPoint))
@@ -676,89 +661,9 @@ void ProjectIIDataStructures::refreshGraphVisualization()
         }
 
         pathPoints.push_back(toPoint);
-
-        QPainterPath path(pathPoints.front());
-        for (size_t i = 1; i < pathPoints.size(); ++i)
-        {
-            path.lineTo(pathPoints[i]);
-        }
-
-        auto *pathItem = graphScene->addPath(path, pen);
-        pathItem->setZValue(0);
-
-        // Calcular punto medio para la etiqueta
-        std::vector<double> segmentLengths;
-        segmentLengths.reserve(pathPoints.size() - 1);
-        double totalLength = 0.0;
-        for (size_t i = 1; i < pathPoints.size(); ++i)
-        {
-            double len = QLineF(pathPoints[i - 1], pathPoints[i]).length();
-            segmentLengths.push_back(len);
-            totalLength += len;
-        }
-
-        QPointF mid = fromPoint;
-        QPointF direction(1.0, 0.0);
-        if (totalLength > 0.0)
-        {
-            double half = totalLength / 2.0;
-            double accumulated = 0.0;
-            for (size_t i = 0; i < segmentLengths.size(); ++i)
-            {
-                double len = segmentLengths[i];
-                if (accumulated + len >= half)
-                {
-                    double ratio = (half - accumulated) / len;
-                    QPointF startPoint = pathPoints[i];
-                    QPointF endPoint = pathPoints[i + 1];
-                    mid = startPoint + (endPoint - startPoint) * ratio;
-                    direction = endPoint - startPoint;
-                    break;
-                }
-                accumulated += len;
-            }
-        }
-        if (qFuzzyIsNull(direction.x()) && qFuzzyIsNull(direction.y()))
-        {
-            direction = toPoint - fromPoint;
-        }
-        double length = std::hypot(direction.x(), direction.y());
-        QPointF offset(0.0, 0.0);
-        if (length > 0.0)
-        {
-            QPointF normal(-direction.y() / length, direction.x() / length);
-            double offsetDistance = 22.0;
-            offset = normal * offsetDistance;
-        }
-        
-        QString weightText = QString::number(edge.weight, 'f', 1) + " min";
-        if (isClosed)
-        {
-            weightText = "✖ " + QString::number(edge.weight, 'f', 1) + " min";
-        }
-        auto *weightItem = graphScene->addText(weightText, edgeFont);
-        QRectF textRect = weightItem->boundingRect();
-        QPointF labelPos = mid + offset - QPointF(textRect.width() / 2.0, textRect.height() / 2.0);
-        
-        // Fondo con sombra y bordes redondeados mejorados
-        QRectF bgRect(labelPos - QPointF(8.0, 5.0), textRect.size() + QSizeF(16.0, 10.0));
-        QColor backgroundColor = isClosed ? closureLabelBg : edgeLabelBg;
-
-        QPainterPath labelBgPath;
-        labelBgPath.addRoundedRect(bgRect, 6.0, 6.0);
-        
-        // Sombra sutil para el fondo
-        auto *labelShadow = graphScene->addPath(labelBgPath, QPen(Qt::NoPen), QBrush(QColor(0, 0, 0, 30)));
-        labelShadow->setPos(2.0, 2.0);
-        labelShadow->setZValue(0.7);
-        
-        auto *labelBackground = graphScene->addPath(labelBgPath, QPen(QColor(200, 200, 200, 100), 0.5), QBrush(backgroundColor));
-        labelBackground->setZValue(0.8);
-        
-        weightItem->setDefaultTextColor(isClosed ? QColor(255, 255, 255) : QColor(30, 41, 59));
-        weightItem->setPos(labelPos);
-        weightItem->setZValue(1.2);
+        edgeLayer->addEdge(edge.from, edge.to, edge.weight, style, pathPoints);
     }
+    graphScene->addItem(edgeLayer);
 
     // Dibujar nodos con efectos mejorados
     for (const auto &station : stations)
@@ -863,13 +768,10 @@ void ProjectIIDataStructures::displayError(const QString &text)
 
 int ProjectIIDataStructures::selectedStationId() const
 {
-    if (ui.stationTable->currentRow() >= 0)
+    QModelIndex current = ui.stationTable->currentIndex();
+    if (current.isValid())
     {
-        auto item = ui.stationTable->item(ui.stationTable->currentRow(), 0);
-        if (item)
-        {
-            return item->data(Qt::UserRole).toInt();
-        }
+        return stationModel->stationIdAt(current.row());
     }
     bool ok = false;
     int id = ui.stationIdEdit->text().toInt(&ok);
@@ -883,7 +785,7 @@ std::pair<int, int> ProjectIIDataStructures::selectedRoute() const
     return {origin, destination};
 }
 
-QString ProjectIIDataStructures::joinStations(const std::vector<int> &ids) const
+QString ProjectIIDataStructures::joinStations(const StationTree &tree, const std::vector<int> &ids)
 {
     if (ids.empty())
     {
@@ -892,19 +794,116 @@ QString ProjectIIDataStructures::joinStations(const std::vector<int> &ids) const
     QStringList parts;
     for (int id : ids)
     {
-        QString name = manager.getStationName(id);
-        if (name.isEmpty())
+        const Station *station = tree.lookup(id);
+        if (!station || station->getName().isEmpty())
         {
             parts << QString::number(id);
         }
         else
         {
-            parts << QString::number(id) + " - " + name;
+            parts << QString::number(id) + " - " + station->getName();
         }
     }
     return parts.join(" → ");
 }
 
+ProjectIIDataStructures::AlgorithmOutcome ProjectIIDataStructures::describeTree(const QString &name, const TreeDetail &detail)
+{
+    AlgorithmOutcome outcome;
+    outcome.status = detail.status;
+    if (detail.edges.empty())
+    {
+        outcome.text = "No se pudo construir un árbol de expansión.";
+        outcome.error = "No hay conexiones suficientes para generar el árbol.";
+        return outcome;
+    }
+    QStringList lines;
+    lines << QString("Árbol mínimo %1 (%2 minutos):").arg(name, QString::number(detail.total, 'f', 2));
+    if (detail.componentTotals.size() > 1)
+    {
+        // Con la red partida (por ejemplo, por cierres) el resultado es un bosque: un árbol por componente
+        lines << QString("La red tiene %1 componentes sin conexión entre sí:").arg(detail.componentTotals.size());
+        for (size_t component = 0; component < detail.componentTotals.size(); ++component)
+        {
+            lines << QString("  Componente %1: %2 minutos").arg(component + 1).arg(QString::number(detail.componentTotals[component], 'f', 2));
+        }
+    }
+    for (const auto &edge : detail.edges)
+    {
+        lines << QString("%1 ⇄ %2 : %3").arg(QString::number(edge.from), QString::number(edge.to), QString::number(edge.weight, 'f', 2));
+    }
+    outcome.text = lines.join('\n');
+    outcome.message = QString("Árbol mínimo %1 generado.").arg(name);
+    outcome.tree = detail;
+    outcome.hasTree = true;
+    return outcome;
+}
+
+void ProjectIIDataStructures::startAlgorithm(const QString &name, AlgorithmTask task)
+{
+    // El cálculo trabaja sobre una instantánea inmutable; la interfaz sigue respondiendo y puede cancelarlo
+    int generation = ++algorithmGeneration;
+    auto cancelled = std::make_shared<std::atomic<bool>>(false);
+    algorithmCancel = cancelled;
+    std::shared_ptr<const NetworkSnapshot> snapshot = manager.snapshot();
+    setAlgorithmRunning(true);
+    ui.resultText->setText(QString("Ejecutando %1...").arg(name));
+    auto *watcher = new QFutureWatcher<AlgorithmOutcome>(this);
+    connect(watcher, &QFutureWatcher<AlgorithmOutcome>::progressValueChanged, this, [this, generation](int value) {
+        if (generation == algorithmGeneration)
+        {
+            ui.algorithmProgress->setValue(value);
+        }
+    });
+    connect(watcher, &QFutureWatcher<AlgorithmOutcome>::finished, this, [this, watcher, generation]() {
+        watcher->deleteLater();
+        if (generation != algorithmGeneration)
+        {
+            return;
+        }
+        AlgorithmOutcome outcome = watcher->result();
+        algorithmCancel.reset();
+        setAlgorithmRunning(false);
+        if (outcome.status == QueryStatus::Cancelled)
+        {
+            ui.algorithmProgress->setValue(0);
+            ui.resultText->setText("Ejecución cancelada.");
+            displayMessage("Se canceló el algoritmo.");
+            return;
+        }
+        ui.resultText->setText(outcome.text);
+        if (!outcome.error.isEmpty())
+        {
+            displayError(outcome.error);
+            return;
+        }
+        if (outcome.hasTree)
+        {
+            highlightTree(outcome.tree);
+        }
+        displayMessage(outcome.message);
+    });
+    watcher->setFuture(QtConcurrent::run([snapshot, cancelled, task](QPromise<AlgorithmOutcome> &promise) {
+        promise.setProgressRange(0, 100);
+        QueryOptions options;
+        options.cancelled = cancelled.get();
+        options.progress = [&promise](int completed, int total) {
+            promise.setProgressValue(static_cast<int>(100LL * completed / total));
+        };
+        promise.addResult(task(*snapshot, options));
+    }));
+}
+
+void ProjectIIDataStructures::setAlgorithmRunning(bool running)
+{
+    ui.runTraversalButton->setEnabled(!running);
+    ui.runShortestButton->setEnabled(!running);
+    ui.runPrimButton->setEnabled(!running);
+    ui.runKruskalButton->setEnabled(!running);
+    ui.cancelAlgorithmButton->setEnabled(running);
+    ui.algorithmProgress->setValue(running ? 0 : ui.algorithmProgress->maximum());
+}
+
 void ProjectIIDataStructures::initializeMapStorage()
 {
     QString baseDir = manager.dataDirectory();
@@ -936,26 +935,140 @@ void ProjectIIDataStructures::loadPersistedMap()
     {
         return;
     }
-    QPixmap pixmap(mapStoredFile);
-    if (pixmap.isNull())
+    startMapLoad(mapStoredFile, false);
+}
+
+void ProjectIIDataStructures::startMapLoad(const QString &filePath, bool userSelected)
+{
+    // La decodificación y la pirámide de mosaicos se preparan fuera del hilo de la interfaz:
+    // primero una vista previa reducida y después los mosaicos a resolución completa
+    int generation = ++mapLoadGeneration;
+    mapLoadPending = true;
+    if (userSelected)
+    {
+        displayMessage("Cargando mapa de fondo...");
+    }
+    auto previewShown = std::make_shared<bool>(false);
+
+    QImageReader probe(filePath);
+    QSize probedSize = probe.size();
+    if (probedSize.isValid() && std::max(probedSize.width(), probedSize.height()) > kMapPreviewSide)
     {
-        return;
+        auto *previewWatcher = new QFutureWatcher<MapLoadResult>(this);
+        connect(previewWatcher, &QFutureWatcher<MapLoadResult>::finished, this, [this, previewWatcher, generation, userSelected, previewShown]() {
+            MapLoadResult result = previewWatcher->result();
+            previewWatcher->deleteLater();
+            if (generation != mapLoadGeneration || !mapLoadPending)
+            {
+                return;
+            }
+            if (applyMapPyramid(result.pyramid, result.originalSize, userSelected))
+            {
+                *previewShown = true;
+            }
+        });
+        previewWatcher->setFuture(QtConcurrent::run([filePath]() { return decodeMapPreview(filePath); }));
     }
-    QSize originalSize = pixmap.size();
-    if (!applyMapPixmap(pixmap, false))
+
+    auto *fullWatcher = new QFutureWatcher<MapLoadResult>(this);
+    connect(fullWatcher, &QFutureWatcher<MapLoadResult>::finished, this, [this, fullWatcher, generation, userSelected, previewShown]() {
+        MapLoadResult result = fullWatcher->result();
+        fullWatcher->deleteLater();
+        if (generation != mapLoadGeneration)
+        {
+            return;
+        }
+        mapLoadPending = false;
+        // Se guarda solo aquí, tras comprobar la generación: una carga más nueva o un borrado del mapa no se pisan
+        bool persisted = !result.encoded.isEmpty() && writeMapImage(result.encoded);
+        if (!applyMapPyramid(result.pyramid, result.originalSize, userSelected && !*previewShown))
+        {
+            if (userSelected)
+            {
+                displayError("No se pudo cargar la imagen seleccionada.");
+            }
+            return;
+        }
+        if (userSelected)
+        {
+            if (!persisted)
+            {
+                displayError("No se pudo guardar la imagen seleccionada como mapa.");
+            }
+            else
+            {
+                QSize scaledSize = result.processedSize;
+                QSize originalSize = result.originalSize;
+                QString detail = QString(" (%1×%2 px)")
+                                      .arg(QString::number(scaledSize.width()),
+                                           QString::number(scaledSize.height()));
+                if (scaledSize != originalSize)
+                {
+                    detail = QString(" (%1×%2 px, ajustado desde %3×%4 px)")
+                                 .arg(QString::number(scaledSize.width()),
+                                      QString::number(scaledSize.height()),
+                                      QString::number(originalSize.width()),
+                                      QString::number(originalSize.height()));
+                }
+                displayMessage(QString("Mapa de fondo actualizado y almacenado%1.").arg(detail));
+            }
+        }
+
+        // Regenerar rutas automáticas después de cargar el mapa
+        manager.regenerateAllAutomaticRoutes(3);
+        refreshAll();
+    });
+    fullWatcher->setFuture(QtConcurrent::run([filePath, userSelected]() { return decodeMapPyramid(filePath, userSelected); }));
+}
+
+ProjectIIDataStructures::MapLoadResult ProjectIIDataStructures::decodeMapPreview(const QString &filePath)
+{
+    MapLoadResult result;
+    QImageReader reader(filePath);
+    QSize originalSize = reader.size();
+    if (!originalSize.isValid())
     {
-        return;
+        return result;
     }
-    if (loadedMapPixmap.size() != originalSize)
+    reader.setScaledSize(originalSize.scaled(kMapPreviewSide, kMapPreviewSide, Qt::KeepAspectRatio));
+    QImage preview = reader.read();
+    if (preview.isNull())
     {
-        persistMapPixmap(loadedMapPixmap);
+        return result;
     }
-    
-    // Regenerar rutas automáticas después de cargar el mapa
-    manager.regenerateAllAutomaticRoutes(3);
+    result.originalSize = originalSize;
+    result.processedSize = originalSize;
+    result.pyramid = std::make_shared<MapTilePyramid>(preview, originalSize);
+    return result;
+}
+
+ProjectIIDataStructures::MapLoadResult ProjectIIDataStructures::decodeMapPyramid(const QString &filePath, bool alwaysPersist)
+{
+    MapLoadResult result;
+    QImageReader reader(filePath);
+    QImage image = reader.read();
+    if (image.isNull())
+    {
+        return result;
+    }
+    result.originalSize = image.size();
+    QImage processed = prepareMapImage(image);
+    result.processedSize = processed.size();
+    if (alwaysPersist || processed.size() != image.size())
+    {
+        // La compresión se hace aquí; el hilo de la interfaz solo escribe los bytes
+        QBuffer buffer(&result.encoded);
+        buffer.open(QIODevice::WriteOnly);
+        if (!processed.save(&buffer, "PNG"))
+        {
+            result.encoded.clear();
+        }
+    }
+    result.pyramid = std::make_shared<MapTilePyramid>(processed);
+    return result;
 }
 
-bool ProjectIIDataStructures::persistMapPixmap(const QPixmap &pixmap)
+bool ProjectIIDataStructures::writeMapImage(const QByteArray &encoded)
 {
     if (mapStoredFile.isEmpty())
     {
@@ -973,18 +1086,17 @@ bool ProjectIIDataStructures::persistMapPixmap(const QPixmap &pixmap)
     {
         return false;
     }
-    return pixmap.save(mapStoredFile, "PNG");
+    QFile file(mapStoredFile);
+    return file.open(QIODevice::WriteOnly) && file.write(encoded) == encoded.size();
 }
 
-bool ProjectIIDataStructures::applyMapPixmap(const QPixmap &pixmap, bool forceFit)
+bool ProjectIIDataStructures::applyMapPyramid(std::shared_ptr<MapTilePyramid> pyramid, const QSize &originalSize, bool forceFit)
 {
-    if (pixmap.isNull())
+    if (!pyramid || pyramid->isNull())
     {
         return false;
     }
-    QSize originalSize = pixmap.size();
-    QPixmap processed = prepareMapPixmap(pixmap);
-    QSize processedSize = processed.size();
+    QSize processedSize = pyramid->size();
     if (processedSize.isEmpty())
     {
         return false;
@@ -995,7 +1107,14 @@ bool ProjectIIDataStructures::applyMapPixmap(const QPixmap &pixmap, bool forceFi
         double scaleY = static_cast<double>(processedSize.height()) / static_cast<double>(originalSize.height());
         manager.scaleStationPositions(scaleX, scaleY);
     }
-    loadedMapPixmap = processed;
+    bool sameArea = mapTileLayer && mapPyramid && mapPyramid->size() == processedSize;
+    mapPyramid = std::move(pyramid);
+    if (sameArea)
+    {
+        // Reemplazo progresivo: la vista previa se sustituye sin reconstruir la escena
+        mapTileLayer->setPyramid(mapPyramid);
+        return true;
+    }
     
     // Expandir el rectángulo de la escena para dar más espacio visual alrededor del mapa
     // Reducir el margen extra para mayor zoom inicial
@@ -1023,33 +1142,35 @@ bool ProjectIIDataStructures::applyMapPixmap(const QPixmap &pixmap, bool forceFi
     return true;
 }
 
-QPixmap ProjectIIDataStructures::prepareMapPixmap(const QPixmap &pixmap) const
+QImage ProjectIIDataStructures::prepareMapImage(const QImage &image)
 {
-    if (!ui.graphView || pixmap.isNull())
+    if (image.isNull())
     {
-        return pixmap;
+        return image;
     }
-    // Preserve the original pixel dimensions so the map keeps its native
-    // resolution and appears crisp inside the scene.
-    return pixmap;
+    // Preserve the original pixel dimensions; the tile pyramid provides the
+    // lower resolutions used when the view is zoomed out.
+    return image;
 }
 
 void ProjectIIDataStructures::clearStoredMap()
 {
+    ++mapLoadGeneration;
+    mapLoadPending = false;
     if (!mapStoredFile.isEmpty() && QFile::exists(mapStoredFile))
     {
         QFile::remove(mapStoredFile);
     }
-    loadedMapPixmap = QPixmap();
+    mapPyramid.reset();
     mapSceneRect = QRectF();
-    if (mapPixmapItem)
+    if (mapTileLayer)
     {
         if (graphScene)
         {
-            graphScene->removeItem(mapPixmapItem);
+            graphScene->removeItem(mapTileLayer);
         }
-        delete mapPixmapItem;
-        mapPixmapItem = nullptr;
+        delete mapTileLayer;
+        mapTileLayer = nullptr;
     }
     if (ui.graphView)
     {
@@ -1068,20 +1189,19 @@ void ProjectIIDataStructures::clearStoredMap()
 
 void ProjectIIDataStructures::addMapItemToScene()
 {
-    if (!graphScene || loadedMapPixmap.isNull())
+    if (!graphScene || !mapPyramid || mapPyramid->isNull())
     {
         return;
     }
-    mapPixmapItem = graphScene->addPixmap(loadedMapPixmap);
-    mapPixmapItem->setZValue(-1000.0);
-    mapPixmapItem->setPos(0.0, 0.0);
-    mapPixmapItem->setTransformationMode(Qt::SmoothTransformation);
-    mapPixmapItem->setCacheMode(QGraphicsItem::ItemCoordinateCache);
+    mapTileLayer = new MapTileLayer(mapPyramid);
+    mapTileLayer->setZValue(-1000.0);
+    mapTileLayer->setPos(0.0, 0.0);
+    graphScene->addItem(mapTileLayer);
 }
 
 bool ProjectIIDataStructures::mapIsActive() const
 {
-    return !loadedMapPixmap.isNull();
+    return mapPyramid && !mapPyramid->isNull();
 }
 
 bool ProjectIIDataStructures::pointWithinMap(const QPointF &point) const
@@ -1142,7 +1262,7 @@ void ProjectIIDataStructures::promptAddStationAt(const QPointF &scenePos)
     if (manager.addStation(id, name, std::optional<QPointF>(scenePos)))
     {
         displayMessage(QString("Estación %1 - %2 agregada correctamente en el mapa.").arg(id).arg(name));
-        refreshAll();
+        applyStationAdded(id);
     }
     else
     {
@@ -1210,7 +1330,7 @@ void ProjectIIDataStructures::handleStationRemovalRequest(int stationId)
     if (manager.removeStation(stationId))
     {
         displayMessage(QString("Estación %1 eliminada correctamente.").arg(stationId));
-        refreshAll();
+        applyStationRemoved(stationId);
     }
     else
     {
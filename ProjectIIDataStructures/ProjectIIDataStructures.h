@@ -1,17 +1,28 @@
 #pragma once
 
 #include "InteractiveGraphicsView.h"
+#include "MapTileLayer.h"
+#include "NetworkSnapshot.h"
+#include "RouteTableModel.h"
+#include "StationListModel.h"
+#include "StationTableModel.h"
 #include "TransitManager.h"
 #include "ui_ProjectIIDataStructures.h"
+#include <QByteArray>
 #include <QCloseEvent>
+#include <QComboBox>
 #include <QEvent>
-#include <QGraphicsPixmapItem>
+#include <QSize>
 #include <QGraphicsScene>
+#include <QImage>
 #include <QIntValidator>
-#include <QPixmap>
 #include <QPointF>
 #include <QString>
 #include <QtWidgets/QMainWindow>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <set>
 #include <utility>
 #include <vector>
 
@@ -32,34 +43,70 @@ private:
     TransitManager manager;
     QIntValidator *stationIdValidator;
     QGraphicsScene *graphScene;
+    StationTableModel *stationModel;
+    RouteTableModel *routeModel;
+    StationListModel *stationListModel;
     QString mapStorageDirectory;
     QString mapStoredFile;
-    QPixmap loadedMapPixmap;
-    QGraphicsPixmapItem *mapPixmapItem;
+    struct MapLoadResult
+    {
+        std::shared_ptr<MapTilePyramid> pyramid;
+        QSize originalSize;
+        QSize processedSize;
+        // PNG a guardar como mapa; se escribe en el hilo de la interfaz y solo si la carga sigue vigente
+        QByteArray encoded;
+    };
+    std::shared_ptr<MapTilePyramid> mapPyramid;
+    MapTileLayer *mapTileLayer;
+    int mapLoadGeneration;
+    bool mapLoadPending;
     QRectF mapSceneRect;
+    std::set<std::pair<int, int>> highlightedTreeEdges;
+    struct AlgorithmOutcome
+    {
+        QueryStatus status = QueryStatus::Completed;
+        QString text;
+        QString message;
+        QString error;
+        bool hasTree = false;
+        TreeDetail tree;
+    };
+    using AlgorithmTask = std::function<AlgorithmOutcome(const NetworkSnapshot &, const QueryOptions &)>;
+    int algorithmGeneration;
+    std::shared_ptr<std::atomic<bool>> algorithmCancel;
     void setupUiBehavior();
+    void attachStationSearch(QComboBox *combo);
     void refreshStations();
     void refreshRoutes();
     void refreshClosures();
     void refreshCombos();
     void refreshAll();
+    void applyStationAdded(int stationId);
+    void applyStationRemoved(int stationId);
     void refreshGraphVisualization();
+    void highlightTree(const TreeDetail &detail);
     void displayMessage(const QString &text);
     void displayError(const QString &text);
     int selectedStationId() const;
     std::pair<int, int> selectedRoute() const;
-    QString joinStations(const std::vector<int> &ids) const;
+    static QString joinStations(const StationTree &tree, const std::vector<int> &ids);
+    static AlgorithmOutcome describeTree(const QString &name, const TreeDetail &detail);
+    void startAlgorithm(const QString &name, AlgorithmTask task);
+    void setAlgorithmRunning(bool running);
     void initializeMapStorage();
     void loadPersistedMap();
-    bool persistMapPixmap(const QPixmap &pixmap);
-    bool applyMapPixmap(const QPixmap &pixmap, bool forceFit);
+    void startMapLoad(const QString &filePath, bool userSelected);
+    static MapLoadResult decodeMapPreview(const QString &filePath);
+    static MapLoadResult decodeMapPyramid(const QString &filePath, bool alwaysPersist);
+    bool writeMapImage(const QByteArray &encoded);
+    bool applyMapPyramid(std::shared_ptr<MapTilePyramid> pyramid, const QSize &originalSize, bool forceFit);
     void clearStoredMap();
     void addMapItemToScene();
     bool mapIsActive() const;
     bool pointWithinMap(const QPointF &point) const;
     void promptAddStationAt(const QPointF &scenePos);
     void handleStationRemovalRequest(int stationId);
-    QPixmap prepareMapPixmap(const QPixmap &pixmap) const;
+    static QImage prepareMapImage(const QImage &image);
     void updateRouteTimeSuggestion();
     std::vector<QPointF> calculateStreetPath(const QPointF &from, const QPointF &to) const;
     double calculateManhattanDistance(const QPointF &from, const QPointF &to) const;
@@ -0,0 +1,73 @@
+#include "QueryWorkspace.h"
+#include <algorithm>
+
+namespace
+{
+// Cada hilo guarda sus espacios libres; una búsqueda anidada en el mismo hilo toma otro distinto
+thread_local std::vector<std::unique_ptr<QueryWorkspace>> idleWorkspaces;
+}
+
+QueryWorkspace::Lease::Lease(std::unique_ptr<QueryWorkspace> workspace)
+    : workspace(std::move(workspace))
+{
+}
+
+QueryWorkspace::Lease::Lease(Lease &&other) noexcept
+    : workspace(std::move(other.workspace))
+{
+}
+
+QueryWorkspace::Lease::~Lease()
+{
+    if (workspace)
+    {
+        idleWorkspaces.push_back(std::move(workspace));
+    }
+}
+
+QueryWorkspace &QueryWorkspace::Lease::operator*() const
+{
+    return *workspace;
+}
+
+QueryWorkspace *QueryWorkspace::Lease::operator->() const
+{
+    return workspace.get();
+}
+
+QueryWorkspace::QueryWorkspace()
+    : generation(0)
+{
+}
+
+QueryWorkspace::Lease QueryWorkspace::acquire()
+{
+    if (idleWorkspaces.empty())
+    {
+        return Lease(std::make_unique<QueryWorkspace>());
+    }
+    std::unique_ptr<QueryWorkspace> workspace = std::move(idleWorkspaces.back());
+    idleWorkspaces.pop_back();
+    return Lease(std::move(workspace));
+}
+
+void QueryWorkspace::prepare(size_t nodes)
+{
+    if (reachedStamp.size() < nodes)
+    {
+        reachedStamp.resize(nodes, 0);
+        settledStamp.resize(nodes, 0);
+        distances.resize(nodes);
+        parents.resize(nodes);
+        positions.resize(nodes);
+    }
+    // Al desbordarse el contador hay que limpiar las marcas para no confundir generaciones viejas
+    if (++generation == 0)
+    {
+        std::fill(reachedStamp.begin(), reachedStamp.end(), 0);
+        std::fill(settledStamp.begin(), settledStamp.end(), 0);
+        generation = 1;
+    }
+    heap.clear();
+    frontier.clear();
+}
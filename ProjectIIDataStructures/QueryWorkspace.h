@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QtGlobal>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Memoria de trabajo reutilizable para búsquedas: los arreglos llevan una marca de generación,
+// así reiniciarlos entre consultas es O(1) y no se vuelve a reservar memoria en régimen estable
+class QueryWorkspace
+{
+public:
+    // Préstamo de un espacio del grupo del hilo actual; se devuelve al destruirse
+    class Lease
+    {
+    public:
+        explicit Lease(std::unique_ptr<QueryWorkspace> workspace);
+        Lease(Lease &&other) noexcept;
+        Lease(const Lease &) = delete;
+        Lease &operator=(const Lease &) = delete;
+        Lease &operator=(Lease &&) = delete;
+        ~Lease();
+        QueryWorkspace &operator*() const;
+        QueryWorkspace *operator->() const;
+    private:
+        std::unique_ptr<QueryWorkspace> workspace;
+    };
+
+    QueryWorkspace();
+    static Lease acquire();
+    void prepare(size_t nodes);
+    double distance(int node) const
+    {
+        return reachedStamp[node] == generation ? distances[node] : std::numeric_limits<double>::infinity();
+    }
+    int parent(int node) const
+    {
+        return reachedStamp[node] == generation ? parents[node] : -1;
+    }
+    bool isReached(int node) const
+    {
+        return reachedStamp[node] == generation;
+    }
+    void reach(int node, double distance, int parent)
+    {
+        reachedStamp[node] = generation;
+        distances[node] = distance;
+        parents[node] = parent;
+    }
+    bool isSettled(int node) const
+    {
+        return settledStamp[node] == generation;
+    }
+    void settle(int node)
+    {
+        settledStamp[node] = generation;
+    }
+
+    // Contenedores auxiliares; prepare los vacía pero conserva su capacidad
+    std::vector<std::pair<double, int>> heap;
+    std::vector<int> frontier;
+    // Usados por las colas de SearchQueues.h: posición de cada nodo en el montículo y cubos del montículo radix
+    std::vector<int> positions;
+    std::vector<std::vector<std::pair<quint64, int>>> buckets;
+private:
+    quint32 generation;
+    std::vector<quint32> reachedStamp;
+    std::vector<quint32> settledStamp;
+    std::vector<double> distances;
+    std::vector<int> parents;
+};
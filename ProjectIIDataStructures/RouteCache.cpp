@@ -0,0 +1,98 @@
+#include "RouteCache.h"
+#include <algorithm>
+
+RouteCache::RouteCache(int cacheLimitKb)
+    : routes(static_cast<qsizetype>(cacheLimitKb) * 1024), hitCount(0), missCount(0)
+{
+}
+
+PathDetail RouteCache::route(const GraphNetwork &graph, int startId, int endId, RouteAlgorithm algorithm, const LandmarkTable *landmarks)
+{
+    RouteCacheKey key{startId, endId, algorithm, graph.getVersion()};
+    PathDetail detail;
+    if (find(key, detail))
+    {
+        return detail;
+    }
+    // El cálculo se hace fuera del candado; dos hilos que fallen a la vez calculan la misma ruta y guardan una
+    switch (algorithm)
+    {
+    case RouteAlgorithm::FloydWarshall:
+        detail = graph.floydWarshall(startId, endId);
+        break;
+    case RouteAlgorithm::Alt:
+        detail = graph.astar(startId, endId, landmarks);
+        break;
+    default:
+        detail = graph.dijkstra(startId, endId);
+        break;
+    }
+    insert(key, detail);
+    return detail;
+}
+
+bool RouteCache::find(const RouteCacheKey &key, PathDetail &result)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (PathDetail *cached = routes.object(key))
+    {
+        ++hitCount;
+        result = *cached;
+        return true;
+    }
+    ++missCount;
+    return false;
+}
+
+void RouteCache::insert(const RouteCacheKey &key, const PathDetail &detail)
+{
+    // Un resultado cortado por un límite depende del presupuesto de esa consulta, no solo de la red
+    if (detail.status != QueryStatus::Completed)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    routes.insert(key, new PathDetail(detail), costOf(detail));
+}
+
+void RouteCache::setCacheLimit(int kilobytes)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    routes.setMaxCost(static_cast<qsizetype>(kilobytes) * 1024);
+}
+
+void RouteCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    routes.clear();
+}
+
+quint64 RouteCache::hits() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return hitCount;
+}
+
+quint64 RouteCache::misses() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return missCount;
+}
+
+int RouteCache::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return static_cast<int>(routes.size());
+}
+
+qint64 RouteCache::memoryBytes() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return routes.totalCost();
+}
+
+qint64 RouteCache::costOf(const PathDetail &detail)
+{
+    // Entrada de QCache (clave, nodo de la lista LRU) más el camino guardado
+    return static_cast<qint64>(sizeof(RouteCacheKey) + sizeof(PathDetail) + 4 * sizeof(void *) + detail.stations.capacity() * sizeof(int));
+}
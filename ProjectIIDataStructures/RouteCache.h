@@ -0,0 +1,58 @@
+#pragma once
+
+#include "GraphNetwork.h"
+#include <QCache>
+#include <QHash>
+#include <QtGlobal>
+#include <mutex>
+
+enum class RouteAlgorithm
+{
+    Dijkstra,
+    FloydWarshall,
+    Alt
+};
+
+struct RouteCacheKey
+{
+    int start;
+    int end;
+    RouteAlgorithm algorithm;
+    quint64 graphVersion;
+
+    bool operator==(const RouteCacheKey &other) const
+    {
+        return start == other.start && end == other.end && algorithm == other.algorithm && graphVersion == other.graphVersion;
+    }
+};
+
+inline size_t qHash(const RouteCacheKey &key, size_t seed = 0)
+{
+    return qHashMulti(seed, key.start, key.end, static_cast<int>(key.algorithm), key.graphVersion);
+}
+
+// Caché LRU de rutas resueltas, segura entre hilos y limitada por memoria.
+// La versión del grafo cambia con cualquier edición de rutas o cierres, así que una entrada vieja nunca se vuelve a usar.
+class RouteCache
+{
+public:
+    static constexpr int kDefaultCacheKb = 16 * 1024;
+
+    explicit RouteCache(int cacheLimitKb = kDefaultCacheKb);
+    // Devuelve la ruta en caché o la calcula sobre graph y la guarda; landmarks solo se usa con Alt
+    PathDetail route(const GraphNetwork &graph, int startId, int endId, RouteAlgorithm algorithm, const LandmarkTable *landmarks = nullptr);
+    bool find(const RouteCacheKey &key, PathDetail &result);
+    void insert(const RouteCacheKey &key, const PathDetail &detail);
+    void setCacheLimit(int kilobytes);
+    void clear();
+    quint64 hits() const;
+    quint64 misses() const;
+    int size() const;
+    qint64 memoryBytes() const;
+private:
+    mutable std::mutex mutex;
+    QCache<RouteCacheKey, PathDetail> routes;
+    quint64 hitCount;
+    quint64 missCount;
+    static qint64 costOf(const PathDetail &detail);
+};
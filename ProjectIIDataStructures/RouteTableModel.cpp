@@ -0,0 +1,268 @@
+#include "RouteTableModel.h"
+#include <algorithm>
+#include <unordered_set>
+
+RouteTableModel::RouteTableModel(const TransitManager &transitManager, QObject *parent)
+    : QAbstractTableModel(parent), manager(transitManager)
+{
+}
+
+int RouteTableModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+    {
+        return 0;
+    }
+    return static_cast<int>(routes.size());
+}
+
+int RouteTableModel::columnCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+    {
+        return 0;
+    }
+    return 3;
+}
+
+QVariant RouteTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= static_cast<int>(routes.size()))
+    {
+        return QVariant();
+    }
+    const GraphEdge &route = routes[index.row()];
+    if (role == Qt::UserRole)
+    {
+        switch (index.column())
+        {
+        case 0:
+            return route.from;
+        case 1:
+            return route.to;
+        default:
+            return route.weight;
+        }
+    }
+    if (role != Qt::DisplayRole)
+    {
+        return QVariant();
+    }
+    switch (index.column())
+    {
+    case 0:
+        return stationLabel(route.from);
+    case 1:
+        return stationLabel(route.to);
+    default:
+        return QString::number(route.weight, 'f', 2);
+    }
+}
+
+QVariant RouteTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal)
+    {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    switch (section)
+    {
+    case 0:
+        return QString("Origen");
+    case 1:
+        return QString("Destino");
+    default:
+        return QString("Tiempo (min)");
+    }
+}
+
+void RouteTableModel::reload()
+{
+    beginResetModel();
+    routes = manager.getRoutes();
+    rowByRoute.clear();
+    neighboursOf.clear();
+    rowByRoute.reserve(routes.size());
+    for (size_t row = 0; row < routes.size(); ++row)
+    {
+        const GraphEdge &route = routes[row];
+        rowByRoute[routeKey(route.from, route.to)] = static_cast<int>(row);
+        neighboursOf[route.from].push_back(route.to);
+        neighboursOf[route.to].push_back(route.from);
+    }
+    endResetModel();
+}
+
+void RouteTableModel::routeAdded(int fromId, int toId)
+{
+    auto connections = manager.getRoutesOf(fromId);
+    auto it = std::find_if(connections.begin(), connections.end(), [toId](const GraphEdge &edge) { return edge.to == toId; });
+    if (it == connections.end())
+    {
+        return;
+    }
+    upsertRoute(*it);
+}
+
+void RouteTableModel::routeRemoved(int fromId, int toId)
+{
+    int row = rowForRoute(fromId, toId);
+    if (row < 0)
+    {
+        return;
+    }
+    removeRoutes({row});
+}
+
+void RouteTableModel::stationRemoved(int stationId)
+{
+    auto it = neighboursOf.find(stationId);
+    if (it == neighboursOf.end())
+    {
+        return;
+    }
+    std::vector<int> rows;
+    for (int other : it->second)
+    {
+        rows.push_back(rowForRoute(stationId, other));
+    }
+    removeRoutes(std::move(rows));
+}
+
+void RouteTableModel::syncStationRoutes(int stationId)
+{
+    auto current = manager.getRoutesOf(stationId);
+    std::unordered_set<int> neighbors;
+    for (const auto &edge : current)
+    {
+        neighbors.insert(edge.to);
+    }
+    std::vector<int> stale;
+    auto it = neighboursOf.find(stationId);
+    if (it != neighboursOf.end())
+    {
+        for (int other : it->second)
+        {
+            if (neighbors.find(other) == neighbors.end())
+            {
+                stale.push_back(rowForRoute(stationId, other));
+            }
+        }
+    }
+    removeRoutes(std::move(stale));
+    for (const auto &edge : current)
+    {
+        upsertRoute(edge);
+    }
+}
+
+std::pair<int, int> RouteTableModel::routeAt(int row) const
+{
+    if (row < 0 || row >= static_cast<int>(routes.size()))
+    {
+        return {-1, -1};
+    }
+    return {routes[row].from, routes[row].to};
+}
+
+quint64 RouteTableModel::routeKey(int fromId, int toId)
+{
+    if (fromId > toId)
+    {
+        std::swap(fromId, toId);
+    }
+    return (static_cast<quint64>(static_cast<quint32>(fromId)) << 32) | static_cast<quint32>(toId);
+}
+
+int RouteTableModel::rowForRoute(int fromId, int toId) const
+{
+    auto it = rowByRoute.find(routeKey(fromId, toId));
+    return it == rowByRoute.end() ? -1 : it->second;
+}
+
+void RouteTableModel::removeRoutes(std::vector<int> rows)
+{
+    if (rows.empty())
+    {
+        return;
+    }
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    for (int row : rows)
+    {
+        const GraphEdge &route = routes[row];
+        rowByRoute.erase(routeKey(route.from, route.to));
+        forgetNeighbour(route.from, route.to);
+        forgetNeighbour(route.to, route.from);
+    }
+    // Los huecos por debajo de keep se llenan con las filas conservadas del final; después se quita la cola de una vez,
+    // así el costo y las señales dependen de las filas quitadas y no del tamaño de la tabla
+    int keep = static_cast<int>(routes.size() - rows.size());
+    int source = static_cast<int>(routes.size()) - 1;
+    for (int hole : rows)
+    {
+        if (hole >= keep)
+        {
+            break;
+        }
+        while (std::binary_search(rows.begin(), rows.end(), source))
+        {
+            --source;
+        }
+        routes[hole] = routes[source];
+        rowByRoute[routeKey(routes[hole].from, routes[hole].to)] = hole;
+        emit dataChanged(index(hole, 0), index(hole, 2));
+        --source;
+    }
+    beginRemoveRows(QModelIndex(), keep, static_cast<int>(routes.size()) - 1);
+    routes.resize(keep);
+    endRemoveRows();
+}
+
+void RouteTableModel::forgetNeighbour(int stationId, int otherId)
+{
+    auto it = neighboursOf.find(stationId);
+    if (it == neighboursOf.end())
+    {
+        return;
+    }
+    std::vector<int> &list = it->second;
+    auto position = std::find(list.begin(), list.end(), otherId);
+    if (position != list.end())
+    {
+        *position = list.back();
+        list.pop_back();
+    }
+    if (list.empty())
+    {
+        neighboursOf.erase(it);
+    }
+}
+
+void RouteTableModel::upsertRoute(const GraphEdge &route)
+{
+    int row = rowForRoute(route.from, route.to);
+    if (row >= 0)
+    {
+        routes[row].weight = route.weight;
+        emit dataChanged(index(row, 2), index(row, 2));
+        return;
+    }
+    int newRow = static_cast<int>(routes.size());
+    beginInsertRows(QModelIndex(), newRow, newRow);
+    routes.push_back(route);
+    rowByRoute[routeKey(route.from, route.to)] = newRow;
+    neighboursOf[route.from].push_back(route.to);
+    neighboursOf[route.to].push_back(route.from);
+    endInsertRows();
+}
+
+QString RouteTableModel::stationLabel(int stationId) const
+{
+    const Station *station = manager.findStation(stationId);
+    if (!station)
+    {
+        return QString::number(stationId);
+    }
+    return QString::number(stationId) + " - " + station->getName();
+}
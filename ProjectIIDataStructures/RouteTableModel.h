@@ -0,0 +1,39 @@
+#pragma once
+
+#include "TransitManager.h"
+#include <QAbstractTableModel>
+#include <QtGlobal>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class RouteTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit RouteTableModel(const TransitManager &transitManager, QObject *parent = nullptr);
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    void reload();
+    void routeAdded(int fromId, int toId);
+    void routeRemoved(int fromId, int toId);
+    void stationRemoved(int stationId);
+    void syncStationRoutes(int stationId);
+    std::pair<int, int> routeAt(int row) const;
+
+private:
+    const TransitManager &manager;
+    std::vector<GraphEdge> routes;
+    // Fila de cada ruta por su par (menor, mayor) y vecinos de cada estación en la tabla: ninguna edición recorre routes
+    std::unordered_map<quint64, int> rowByRoute;
+    std::unordered_map<int, std::vector<int>> neighboursOf;
+    static quint64 routeKey(int fromId, int toId);
+    int rowForRoute(int fromId, int toId) const;
+    void removeRoutes(std::vector<int> rows);
+    void forgetNeighbour(int stationId, int otherId);
+    void upsertRoute(const GraphEdge &route);
+    QString stationLabel(int stationId) const;
+};
@@ -0,0 +1,211 @@
+#pragma once
+
+#include "QueryWorkspace.h"
+#include <QtAlgorithms>
+#include <QtGlobal>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Colas de prioridad para GraphNetwork::dijkstraWith. Todas trabajan sobre la memoria del QueryWorkspace
+// y ofrecen la misma interfaz: empty(), update(nodo, clave) y pop() -> (clave, nodo).
+// update debe llamarse antes de workspace.reach(nodo, ...) para que la cola sepa si el nodo ya estaba.
+
+// Montículo binario con borrado perezoso: cada mejora inserta un duplicado y los obsoletos se descartan al salir
+class LazyBinaryHeap
+{
+public:
+    explicit LazyBinaryHeap(QueryWorkspace &workspace)
+        : entries(workspace.heap)
+    {
+        entries.clear();
+    }
+    bool empty() const
+    {
+        return entries.empty();
+    }
+    void update(int node, double key)
+    {
+        entries.push_back({key, node});
+        std::push_heap(entries.begin(), entries.end(), std::greater<std::pair<double, int>>());
+    }
+    std::pair<double, int> pop()
+    {
+        std::pop_heap(entries.begin(), entries.end(), std::greater<std::pair<double, int>>());
+        std::pair<double, int> top = entries.back();
+        entries.pop_back();
+        return top;
+    }
+private:
+    std::vector<std::pair<double, int>> &entries;
+};
+
+// Montículo d-ario indexado: cada nodo aparece una sola vez y una mejora es un decrease-key
+template <int Arity>
+class IndexedDaryHeap
+{
+    static_assert(Arity >= 2, "el montículo necesita al menos dos hijos por nodo");
+public:
+    explicit IndexedDaryHeap(QueryWorkspace &workspace)
+        : workspace(workspace), slots(workspace.heap), positions(workspace.positions)
+    {
+        slots.clear();
+    }
+    bool empty() const
+    {
+        return slots.empty();
+    }
+    void update(int node, double key)
+    {
+        // positions solo es válido para nodos alcanzados en esta búsqueda; -1 indica que ya salió de la cola
+        if (workspace.isReached(node) && positions[node] >= 0)
+        {
+            size_t index = static_cast<size_t>(positions[node]);
+            slots[index].first = key;
+            siftUp(index);
+            return;
+        }
+        slots.push_back({key, node});
+        siftUp(slots.size() - 1);
+    }
+    std::pair<double, int> pop()
+    {
+        std::pair<double, int> top = slots.front();
+        positions[top.second] = -1;
+        std::pair<double, int> last = slots.back();
+        slots.pop_back();
+        if (!slots.empty())
+        {
+            slots[0] = last;
+            siftDown(0);
+        }
+        return top;
+    }
+private:
+    QueryWorkspace &workspace;
+    std::vector<std::pair<double, int>> &slots;
+    std::vector<int> &positions;
+
+    void place(size_t index, const std::pair<double, int> &item)
+    {
+        slots[index] = item;
+        positions[item.second] = static_cast<int>(index);
+    }
+    void siftUp(size_t index)
+    {
+        std::pair<double, int> item = slots[index];
+        while (index > 0)
+        {
+            size_t parent = (index - 1) / Arity;
+            if (!(item < slots[parent]))
+            {
+                break;
+            }
+            place(index, slots[parent]);
+            index = parent;
+        }
+        place(index, item);
+    }
+    void siftDown(size_t index)
+    {
+        std::pair<double, int> item = slots[index];
+        size_t count = slots.size();
+        while (true)
+        {
+            size_t first = index * Arity + 1;
+            if (first >= count)
+            {
+                break;
+            }
+            size_t best = first;
+            size_t end = std::min(first + Arity, count);
+            for (size_t child = first + 1; child < end; ++child)
+            {
+                if (slots[child] < slots[best])
+                {
+                    best = child;
+                }
+            }
+            if (!(slots[best] < item))
+            {
+                break;
+            }
+            place(index, slots[best]);
+            index = best;
+        }
+        place(index, item);
+    }
+};
+
+// Montículo radix (monótono): las claves extraídas nunca decrecen, como en Dijkstra con pesos no negativos.
+// Para doubles no negativos el orden de los bits IEEE-754 coincide con el numérico, así que los tiempos
+// se usan sin cuantizar; tiempos enteros o redondeados a una resolución fija son un caso particular.
+class RadixHeap
+{
+public:
+    explicit RadixHeap(QueryWorkspace &workspace)
+        : buckets(workspace.buckets), last(0), count(0)
+    {
+        buckets.resize(65);
+        for (auto &bucket : buckets)
+        {
+            bucket.clear();
+        }
+    }
+    bool empty() const
+    {
+        return count == 0;
+    }
+    void update(int node, double key)
+    {
+        quint64 bits = encode(key);
+        buckets[bucketOf(bits)].push_back({bits, node});
+        ++count;
+    }
+    std::pair<double, int> pop()
+    {
+        if (buckets[0].empty())
+        {
+            size_t index = 1;
+            while (buckets[index].empty())
+            {
+                ++index;
+            }
+            // La nueva referencia es el mínimo del primer cubo no vacío; sus elementos bajan a cubos menores
+            auto &source = buckets[index];
+            last = std::min_element(source.begin(), source.end())->first;
+            for (const auto &entry : source)
+            {
+                buckets[bucketOf(entry.first)].push_back(entry);
+            }
+            source.clear();
+        }
+        std::pair<quint64, int> entry = buckets[0].back();
+        buckets[0].pop_back();
+        --count;
+        return {decode(entry.first), entry.second};
+    }
+private:
+    std::vector<std::vector<std::pair<quint64, int>>> &buckets;
+    quint64 last;
+    size_t count;
+
+    size_t bucketOf(quint64 bits) const
+    {
+        return bits == last ? 0 : 64 - qCountLeadingZeroBits(bits ^ last);
+    }
+    static quint64 encode(double value)
+    {
+        quint64 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+    static double decode(quint64 bits)
+    {
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+};
@@ -0,0 +1,160 @@
+#include "ShortestPathTree.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+ShortestPathTree::ShortestPathTree(int sourceId, quint64 graphVersion, std::shared_ptr<const std::unordered_map<int, int>> index,
+                                   std::vector<double> distances, std::vector<int> parentIds, QueryStatus status)
+    : source(sourceId), version(graphVersion), treeStatus(status), indexById(std::move(index)), distances(std::move(distances)),
+      parentIds(std::move(parentIds))
+{
+}
+
+int ShortestPathTree::sourceId() const
+{
+    return source;
+}
+
+quint64 ShortestPathTree::graphVersion() const
+{
+    return version;
+}
+
+QueryStatus ShortestPathTree::status() const
+{
+    return treeStatus;
+}
+
+bool ShortestPathTree::reaches(int stationId) const
+{
+    return std::isfinite(distanceTo(stationId));
+}
+
+double ShortestPathTree::distanceTo(int stationId) const
+{
+    int index = indexOf(stationId);
+    return index < 0 ? std::numeric_limits<double>::infinity() : distances[index];
+}
+
+int ShortestPathTree::parentOf(int stationId) const
+{
+    int index = indexOf(stationId);
+    return index < 0 ? -1 : parentIds[index];
+}
+
+std::vector<int> ShortestPathTree::pathTo(int stationId) const
+{
+    std::vector<int> path;
+    if (!reaches(stationId))
+    {
+        return path;
+    }
+    for (int current = stationId; current != -1; current = parentIds[indexOf(current)])
+    {
+        path.push_back(current);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+PathDetail ShortestPathTree::routeTo(int stationId) const
+{
+    return {pathTo(stationId), distanceTo(stationId), treeStatus};
+}
+
+qint64 ShortestPathTree::memoryBytes() const
+{
+    return static_cast<qint64>(sizeof(*this) + distances.capacity() * sizeof(double) + parentIds.capacity() * sizeof(int));
+}
+
+int ShortestPathTree::indexOf(int stationId) const
+{
+    auto it = indexById->find(stationId);
+    return it == indexById->end() ? -1 : it->second;
+}
+
+ShortestPathTreeCache::ShortestPathTreeCache(int cacheLimitKb)
+    : trees(static_cast<qsizetype>(cacheLimitKb) * 1024), hitCount(0), missCount(0), repairCount(0)
+{
+}
+
+std::shared_ptr<const ShortestPathTree> ShortestPathTreeCache::find(quint64 graphVersion, int sourceId)
+{
+    std::shared_ptr<const ShortestPathTree> tree = peek(graphVersion, sourceId);
+    std::lock_guard<std::mutex> lock(mutex);
+    ++(tree ? hitCount : missCount);
+    return tree;
+}
+
+std::shared_ptr<const ShortestPathTree> ShortestPathTreeCache::peek(quint64 graphVersion, int sourceId)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_ptr<const ShortestPathTree> *cached = trees.object(treeKey(graphVersion, sourceId));
+    // La clave empaqueta solo 32 bits de la versión; se confirma la versión completa del árbol
+    if (cached && (*cached)->graphVersion() == graphVersion && (*cached)->sourceId() == sourceId)
+    {
+        return *cached;
+    }
+    return nullptr;
+}
+
+void ShortestPathTreeCache::insert(const std::shared_ptr<const ShortestPathTree> &tree)
+{
+    // Se cobra en bytes, como en RouteCache, para que los dos límites y sus memoryBytes se puedan comparar
+    qint64 cost = tree->memoryBytes();
+    std::lock_guard<std::mutex> lock(mutex);
+    trees.insert(treeKey(tree->graphVersion(), tree->sourceId()), new std::shared_ptr<const ShortestPathTree>(tree), cost);
+}
+
+void ShortestPathTreeCache::recordRepair()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    ++repairCount;
+}
+
+void ShortestPathTreeCache::setCacheLimit(int kilobytes)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    trees.setMaxCost(static_cast<qsizetype>(kilobytes) * 1024);
+}
+
+void ShortestPathTreeCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    trees.clear();
+}
+
+quint64 ShortestPathTreeCache::hits() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return hitCount;
+}
+
+quint64 ShortestPathTreeCache::misses() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return missCount;
+}
+
+quint64 ShortestPathTreeCache::repairs() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return repairCount;
+}
+
+int ShortestPathTreeCache::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return static_cast<int>(trees.size());
+}
+
+qint64 ShortestPathTreeCache::memoryBytes() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return trees.totalCost();
+}
+
+quint64 ShortestPathTreeCache::treeKey(quint64 graphVersion, int sourceId)
+{
+    return (graphVersion << 32) | static_cast<quint32>(sourceId);
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "GraphNetwork.h"
+#include <QCache>
+#include <QtGlobal>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Distancias y padres desde un origen a todas las estaciones; cada consulta cuesta O(largo del camino)
+class ShortestPathTree
+{
+public:
+    ShortestPathTree(int sourceId, quint64 graphVersion, std::shared_ptr<const std::unordered_map<int, int>> index,
+                     std::vector<double> distances, std::vector<int> parentIds, QueryStatus status);
+    int sourceId() const;
+    quint64 graphVersion() const;
+    QueryStatus status() const;
+    bool reaches(int stationId) const;
+    double distanceTo(int stationId) const;
+    // Estación anterior en el camino desde el origen; -1 para el origen o si no se alcanza
+    int parentOf(int stationId) const;
+    std::vector<int> pathTo(int stationId) const;
+    PathDetail routeTo(int stationId) const;
+    qint64 memoryBytes() const;
+private:
+    // GraphNetwork repara árboles viejos a partir de sus arreglos
+    friend class GraphNetwork;
+    int source;
+    quint64 version;
+    QueryStatus treeStatus;
+    std::shared_ptr<const std::unordered_map<int, int>> indexById;
+    std::vector<double> distances;
+    std::vector<int> parentIds;
+    int indexOf(int stationId) const;
+};
+
+// Caché LRU de árboles por (versión del grafo, origen), limitada por memoria como la de mosaicos del mapa.
+// Se comparte entre las copias de un GraphNetwork; una mutación cambia la versión y los árboles viejos dejan de coincidir.
+class ShortestPathTreeCache
+{
+public:
+    static constexpr int kDefaultCacheKb = 64 * 1024;
+
+    explicit ShortestPathTreeCache(int cacheLimitKb = kDefaultCacheKb);
+    std::shared_ptr<const ShortestPathTree> find(quint64 graphVersion, int sourceId);
+    // Como find, pero sin contar aciertos ni fallos: se usa al buscar árboles de versiones anteriores para repararlos
+    std::shared_ptr<const ShortestPathTree> peek(quint64 graphVersion, int sourceId);
+    void insert(const std::shared_ptr<const ShortestPathTree> &tree);
+    void recordRepair();
+    void setCacheLimit(int kilobytes);
+    void clear();
+    quint64 hits() const;
+    quint64 misses() const;
+    quint64 repairs() const;
+    int size() const;
+    qint64 memoryBytes() const;
+private:
+    mutable std::mutex mutex;
+    QCache<quint64, std::shared_ptr<const ShortestPathTree>> trees;
+    quint64 hitCount;
+    quint64 missCount;
+    quint64 repairCount;
+    static quint64 treeKey(quint64 graphVersion, int sourceId);
+};
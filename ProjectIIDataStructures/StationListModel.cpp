@@ -0,0 +1,120 @@
+#include "StationListModel.h"
+#include <algorithm>
+
+namespace
+{
+bool entryBefore(const std::pair<int, QString> &entry, int stationId)
+{
+    return entry.first < stationId;
+}
+}
+
+StationListModel::StationListModel(const TransitManager &transitManager, QObject *parent)
+    : QAbstractListModel(parent), manager(transitManager)
+{
+}
+
+int StationListModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+    {
+        return 0;
+    }
+    // La fila 0 es la opción "Seleccione"
+    return static_cast<int>(entries.size()) + 1;
+}
+
+QVariant StationListModel::data(const QModelIndex &modelIndex, int role) const
+{
+    if (!modelIndex.isValid() || modelIndex.row() < 0 || modelIndex.row() > static_cast<int>(entries.size()))
+    {
+        return QVariant();
+    }
+    int row = modelIndex.row();
+    if (role == Qt::UserRole)
+    {
+        return row == 0 ? 0 : entries[row - 1].first;
+    }
+    if (role == Qt::DisplayRole || role == Qt::EditRole)
+    {
+        return row == 0 ? QString("Seleccione") : entries[row - 1].second;
+    }
+    return QVariant();
+}
+
+void StationListModel::reload()
+{
+    beginResetModel();
+    entries.clear();
+    auto stations = manager.getStations();
+    entries.reserve(stations.size());
+    std::vector<std::pair<int, QString>> names;
+    names.reserve(stations.size());
+    for (const auto &station : stations)
+    {
+        entries.emplace_back(station.getId(), formatLabel(station.getId(), station.getName()));
+        names.emplace_back(station.getId(), station.getName());
+    }
+    index.rebuild(names);
+    endResetModel();
+}
+
+void StationListModel::stationAdded(int stationId)
+{
+    const Station *station = manager.findStation(stationId);
+    if (!station)
+    {
+        return;
+    }
+    auto it = std::lower_bound(entries.begin(), entries.end(), stationId, entryBefore);
+    int row = static_cast<int>(it - entries.begin()) + 1;
+    index.insert(stationId, station->getName());
+    if (it != entries.end() && it->first == stationId)
+    {
+        it->second = formatLabel(stationId, station->getName());
+        emit dataChanged(createIndex(row, 0), createIndex(row, 0));
+        return;
+    }
+    beginInsertRows(QModelIndex(), row, row);
+    entries.insert(it, {stationId, formatLabel(stationId, station->getName())});
+    endInsertRows();
+}
+
+void StationListModel::stationRemoved(int stationId)
+{
+    int row = rowForStation(stationId);
+    if (row <= 0)
+    {
+        return;
+    }
+    index.remove(stationId);
+    beginRemoveRows(QModelIndex(), row, row);
+    entries.erase(entries.begin() + (row - 1));
+    endRemoveRows();
+}
+
+int StationListModel::rowForStation(int stationId) const
+{
+    auto it = std::lower_bound(entries.begin(), entries.end(), stationId, entryBefore);
+    if (it == entries.end() || it->first != stationId)
+    {
+        return -1;
+    }
+    return static_cast<int>(it - entries.begin()) + 1;
+}
+
+QString StationListModel::stationLabel(int stationId) const
+{
+    int row = rowForStation(stationId);
+    return row > 0 ? entries[row - 1].second : QString();
+}
+
+const StationNameIndex &StationListModel::nameIndex() const
+{
+    return index;
+}
+
+QString StationListModel::formatLabel(int stationId, const QString &name)
+{
+    return QString::number(stationId) + " - " + name;
+}
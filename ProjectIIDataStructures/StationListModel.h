@@ -0,0 +1,30 @@
+#pragma once
+
+#include "StationNameIndex.h"
+#include "TransitManager.h"
+#include <QAbstractListModel>
+#include <QString>
+#include <utility>
+#include <vector>
+
+class StationListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit StationListModel(const TransitManager &transitManager, QObject *parent = nullptr);
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    void reload();
+    void stationAdded(int stationId);
+    void stationRemoved(int stationId);
+    int rowForStation(int stationId) const;
+    QString stationLabel(int stationId) const;
+    const StationNameIndex &nameIndex() const;
+
+private:
+    const TransitManager &manager;
+    std::vector<std::pair<int, QString>> entries;
+    StationNameIndex index;
+    static QString formatLabel(int stationId, const QString &name);
+};
@@ -0,0 +1,195 @@
+#include "StationNameIndex.h"
+#include <algorithm>
+
+void StationNameIndex::clear()
+{
+    sortedNames.clear();
+    trigrams.clear();
+    keyById.clear();
+}
+
+void StationNameIndex::rebuild(const std::vector<std::pair<int, QString>> &stations)
+{
+    clear();
+    // Por id, así cada lista de trigramas queda ordenada solo con agregar al final
+    std::vector<std::pair<int, QString>> byId(stations);
+    std::stable_sort(byId.begin(), byId.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+    sortedNames.reserve(byId.size());
+    keyById.reserve(byId.size());
+    for (size_t i = 0; i < byId.size(); ++i)
+    {
+        int stationId = byId[i].first;
+        // Con ids repetidos vale el último nombre, como con insert
+        if (i + 1 < byId.size() && byId[i + 1].first == stationId)
+        {
+            continue;
+        }
+        QString key = normalize(byId[i].second);
+        keyById[stationId] = key;
+        sortedNames.emplace_back(key, stationId);
+        for (quint64 gram : trigramsOf(key))
+        {
+            trigrams[gram].push_back(stationId);
+        }
+    }
+    std::sort(sortedNames.begin(), sortedNames.end());
+}
+
+void StationNameIndex::insert(int stationId, const QString &name)
+{
+    remove(stationId);
+    QString key = normalize(name);
+    keyById[stationId] = key;
+    std::pair<QString, int> entry(key, stationId);
+    sortedNames.insert(std::lower_bound(sortedNames.begin(), sortedNames.end(), entry), entry);
+    for (quint64 gram : trigramsOf(key))
+    {
+        auto &ids = trigrams[gram];
+        auto it = std::lower_bound(ids.begin(), ids.end(), stationId);
+        if (it == ids.end() || *it != stationId)
+        {
+            ids.insert(it, stationId);
+        }
+    }
+}
+
+void StationNameIndex::remove(int stationId)
+{
+    auto found = keyById.find(stationId);
+    if (found == keyById.end())
+    {
+        return;
+    }
+    QString key = found->second;
+    keyById.erase(found);
+    std::pair<QString, int> entry(key, stationId);
+    auto position = std::lower_bound(sortedNames.begin(), sortedNames.end(), entry);
+    if (position != sortedNames.end() && *position == entry)
+    {
+        sortedNames.erase(position);
+    }
+    for (quint64 gram : trigramsOf(key))
+    {
+        auto list = trigrams.find(gram);
+        if (list == trigrams.end())
+        {
+            continue;
+        }
+        auto &ids = list->second;
+        auto it = std::lower_bound(ids.begin(), ids.end(), stationId);
+        if (it != ids.end() && *it == stationId)
+        {
+            ids.erase(it);
+        }
+        if (ids.empty())
+        {
+            trigrams.erase(list);
+        }
+    }
+}
+
+std::vector<int> StationNameIndex::search(const QString &query, int limit) const
+{
+    std::vector<int> result;
+    QString key = normalize(query);
+    if (key.isEmpty() || limit <= 0)
+    {
+        return result;
+    }
+    bool isNumber = false;
+    int numericId = key.toInt(&isNumber);
+    if (isNumber && keyById.count(numericId))
+    {
+        result.push_back(numericId);
+    }
+    // Primero los nombres que empiezan con el texto, ubicados por búsqueda binaria
+    auto it = std::lower_bound(sortedNames.begin(), sortedNames.end(), std::pair<QString, int>(key, 0));
+    for (; it != sortedNames.end() && it->first.startsWith(key); ++it)
+    {
+        if (static_cast<int>(result.size()) >= limit)
+        {
+            return result;
+        }
+        if (it->second != numericId || !isNumber)
+        {
+            result.push_back(it->second);
+        }
+    }
+    if (key.size() < 3)
+    {
+        return result;
+    }
+    // Luego los que contienen el texto: se intersectan las listas de trigramas empezando por la más corta
+    std::vector<const std::vector<int> *> lists;
+    for (quint64 gram : trigramsOf(key))
+    {
+        auto list = trigrams.find(gram);
+        if (list == trigrams.end())
+        {
+            return result;
+        }
+        lists.push_back(&list->second);
+    }
+    std::sort(lists.begin(), lists.end(), [](const std::vector<int> *a, const std::vector<int> *b) {
+        return a->size() < b->size();
+    });
+    for (int candidate : *lists.front())
+    {
+        if (static_cast<int>(result.size()) >= limit)
+        {
+            break;
+        }
+        bool inAll = std::all_of(lists.begin() + 1, lists.end(), [candidate](const std::vector<int> *ids) {
+            return std::binary_search(ids->begin(), ids->end(), candidate);
+        });
+        if (!inAll)
+        {
+            continue;
+        }
+        const QString &name = keyById.at(candidate);
+        if (name.startsWith(key) || !name.contains(key) || (isNumber && candidate == numericId))
+        {
+            continue;
+        }
+        result.push_back(candidate);
+    }
+    return result;
+}
+
+int StationNameIndex::size() const
+{
+    return static_cast<int>(keyById.size());
+}
+
+QString StationNameIndex::normalize(const QString &text)
+{
+    // Se ignoran mayúsculas y tildes para que "Cartago" y "cártago" coincidan
+    QString decomposed = text.normalized(QString::NormalizationForm_D).toLower();
+    QString result;
+    result.reserve(decomposed.size());
+    for (const QChar &c : decomposed)
+    {
+        if (c.category() != QChar::Mark_NonSpacing)
+        {
+            result.append(c);
+        }
+    }
+    return result.simplified();
+}
+
+std::vector<quint64> StationNameIndex::trigramsOf(const QString &key)
+{
+    std::vector<quint64> grams;
+    for (int i = 0; i + 3 <= key.size(); ++i)
+    {
+        grams.push_back(trigramKey(key.constData() + i));
+    }
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+    return grams;
+}
+
+quint64 StationNameIndex::trigramKey(const QChar *chars)
+{
+    return (static_cast<quint64>(chars[0].unicode()) << 32) | (static_cast<quint64>(chars[1].unicode()) << 16) | chars[2].unicode();
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <QString>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class StationNameIndex
+{
+public:
+    void clear();
+    // Carga completa: un solo ordenamiento en vez de una inserción ordenada por estación
+    void rebuild(const std::vector<std::pair<int, QString>> &stations);
+    void insert(int stationId, const QString &name);
+    void remove(int stationId);
+    std::vector<int> search(const QString &query, int limit) const;
+    int size() const;
+    static QString normalize(const QString &text);
+private:
+    std::vector<std::pair<QString, int>> sortedNames;
+    std::unordered_map<quint64, std::vector<int>> trigrams;
+    std::unordered_map<int, QString> keyById;
+    static std::vector<quint64> trigramsOf(const QString &key);
+    static quint64 trigramKey(const QChar *chars);
+};
@@ -0,0 +1,59 @@
+#include "StationSearchModel.h"
+
+StationSearchModel::StationSearchModel(const StationListModel &stations, QObject *parent)
+    : QAbstractListModel(parent), source(stations)
+{
+    // Si cambian las estaciones mientras el usuario escribe, se repite la búsqueda
+    connect(&source, &QAbstractItemModel::modelReset, this, &StationSearchModel::refresh);
+    connect(&source, &QAbstractItemModel::rowsInserted, this, &StationSearchModel::refresh);
+    connect(&source, &QAbstractItemModel::rowsRemoved, this, &StationSearchModel::refresh);
+}
+
+int StationSearchModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+    {
+        return 0;
+    }
+    return static_cast<int>(matches.size());
+}
+
+QVariant StationSearchModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= static_cast<int>(matches.size()))
+    {
+        return QVariant();
+    }
+    int stationId = matches[index.row()];
+    if (role == Qt::UserRole)
+    {
+        return stationId;
+    }
+    if (role == Qt::DisplayRole || role == Qt::EditRole)
+    {
+        return source.stationLabel(stationId);
+    }
+    return QVariant();
+}
+
+void StationSearchModel::setQuery(const QString &text)
+{
+    query = text;
+    refresh();
+}
+
+int StationSearchModel::stationIdAt(int row) const
+{
+    if (row < 0 || row >= static_cast<int>(matches.size()))
+    {
+        return 0;
+    }
+    return matches[row];
+}
+
+void StationSearchModel::refresh()
+{
+    beginResetModel();
+    matches = source.nameIndex().search(query, kResultLimit);
+    endResetModel();
+}
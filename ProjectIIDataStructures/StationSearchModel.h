@@ -0,0 +1,25 @@
+#pragma once
+
+#include "StationListModel.h"
+#include <QAbstractListModel>
+#include <QString>
+#include <vector>
+
+class StationSearchModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit StationSearchModel(const StationListModel &stations, QObject *parent = nullptr);
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    void setQuery(const QString &text);
+    int stationIdAt(int row) const;
+
+private:
+    static constexpr int kResultLimit = 50;
+    const StationListModel &source;
+    QString query;
+    std::vector<int> matches;
+    void refresh();
+};
@@ -0,0 +1,129 @@
+#include "StationTableModel.h"
+#include <algorithm>
+
+StationTableModel::StationTableModel(const TransitManager &transitManager, QObject *parent)
+    : QAbstractTableModel(parent), manager(transitManager)
+{
+}
+
+int StationTableModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+    {
+        return 0;
+    }
+    return static_cast<int>(stationIds.size());
+}
+
+int StationTableModel::columnCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+    {
+        return 0;
+    }
+    return 2;
+}
+
+QVariant StationTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= static_cast<int>(stationIds.size()))
+    {
+        return QVariant();
+    }
+    int stationId = stationIds[index.row()];
+    if (role == Qt::UserRole)
+    {
+        return stationId;
+    }
+    if (role != Qt::DisplayRole)
+    {
+        return QVariant();
+    }
+    if (index.column() == 0)
+    {
+        return QString::number(stationId);
+    }
+    const Station *station = manager.findStation(stationId);
+    return station ? station->getName() : QString();
+}
+
+QVariant StationTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal)
+    {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    return section == 0 ? QString("Código") : QString("Nombre");
+}
+
+void StationTableModel::reload()
+{
+    beginResetModel();
+    stationIds.clear();
+    auto stations = manager.getStations();
+    stationIds.reserve(stations.size());
+    for (const auto &station : stations)
+    {
+        stationIds.push_back(station.getId());
+    }
+    endResetModel();
+}
+
+void StationTableModel::stationAdded(int stationId)
+{
+    if (!manager.findStation(stationId))
+    {
+        return;
+    }
+    auto it = std::lower_bound(stationIds.begin(), stationIds.end(), stationId);
+    if (it != stationIds.end() && *it == stationId)
+    {
+        stationChanged(stationId);
+        return;
+    }
+    int row = static_cast<int>(it - stationIds.begin());
+    beginInsertRows(QModelIndex(), row, row);
+    stationIds.insert(it, stationId);
+    endInsertRows();
+}
+
+void StationTableModel::stationRemoved(int stationId)
+{
+    int row = rowForStation(stationId);
+    if (row < 0)
+    {
+        return;
+    }
+    beginRemoveRows(QModelIndex(), row, row);
+    stationIds.erase(stationIds.begin() + row);
+    endRemoveRows();
+}
+
+void StationTableModel::stationChanged(int stationId)
+{
+    int row = rowForStation(stationId);
+    if (row < 0)
+    {
+        return;
+    }
+    emit dataChanged(index(row, 0), index(row, 1));
+}
+
+int StationTableModel::stationIdAt(int row) const
+{
+    if (row < 0 || row >= static_cast<int>(stationIds.size()))
+    {
+        return -1;
+    }
+    return stationIds[row];
+}
+
+int StationTableModel::rowForStation(int stationId) const
+{
+    auto it = std::lower_bound(stationIds.begin(), stationIds.end(), stationId);
+    if (it == stationIds.end() || *it != stationId)
+    {
+        return -1;
+    }
+    return static_cast<int>(it - stationIds.begin());
+}
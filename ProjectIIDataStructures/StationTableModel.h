@@ -0,0 +1,27 @@
+#pragma once
+
+#include "TransitManager.h"
+#include <QAbstractTableModel>
+#include <vector>
+
+class StationTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit StationTableModel(const TransitManager &transitManager, QObject *parent = nullptr);
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    void reload();
+    void stationAdded(int stationId);
+    void stationRemoved(int stationId);
+    void stationChanged(int stationId);
+    int stationIdAt(int row) const;
+    int rowForStation(int stationId) const;
+
+private:
+    const TransitManager &manager;
+    std::vector<int> stationIds;
+};
@@ -1,7 +1,8 @@
 #include "StationTree.h"
 #include <utility>
 
-StationTree::Node::Node(const Station &station) : data(station), left(nullptr), right(nullptr)
+StationTree::Node::Node(const Station &station, NodePtr leftChild, NodePtr rightChild)
+    : data(station), left(std::move(leftChild)), right(std::move(rightChild))
 {
 }
 
@@ -9,15 +10,12 @@ StationTree::StationTree() : root(nullptr), nodeCount(0)
 {
 }
 
-StationTree::~StationTree()
-{
-    clear();
-}
-
 bool StationTree::insert(const Station &station)
 {
-    if (insert(root, station))
+    NodePtr updated;
+    if (insert(root, station, updated))
     {
+        root = std::move(updated);
         nodeCount++;
         return true;
     }
@@ -26,8 +24,10 @@ bool StationTree::insert(const Station &station)
 
 bool StationTree::remove(int id)
 {
-    if (remove(root, id))
+    NodePtr updated;
+    if (remove(root, id, updated))
     {
+        root = std::move(updated);
         nodeCount--;
         return true;
     }
@@ -36,34 +36,54 @@ bool StationTree::remove(int id)
 
 bool StationTree::find(int id, Station &station) const
 {
-    return find(root, id, station);
+    return find(root.get(), id, station);
+}
+
+const Station *StationTree::lookup(int id) const
+{
+    const Node *current = root.get();
+    while (current)
+    {
+        if (id < current->data.getId())
+        {
+            current = current->left.get();
+        }
+        else if (id > current->data.getId())
+        {
+            current = current->right.get();
+        }
+        else
+        {
+            return &current->data;
+        }
+    }
+    return nullptr;
 }
 
 std::vector<Station> StationTree::inOrder() const
 {
     std::vector<Station> result;
-    inOrder(root, result);
+    inOrder(root.get(), result);
     return result;
 }
 
 std::vector<Station> StationTree::preOrder() const
 {
     std::vector<Station> result;
-    preOrder(root, result);
+    preOrder(root.get(), result);
     return result;
 }
 
 std::vector<Station> StationTree::postOrder() const
 {
     std::vector<Station> result;
-    postOrder(root, result);
+    postOrder(root.get(), result);
     return result;
 }
 
 void StationTree::clear()
 {
-    clear(root);
-    root = nullptr;
+    root.reset();
     nodeCount = 0;
 }
 
@@ -79,77 +99,90 @@ int StationTree::size() const
 
 void StationTree::forEach(const std::function<void(Station &)> &callback)
 {
-    forEach(root, callback);
+    root = forEach(root, callback);
 }
 
-bool StationTree::insert(Node *&node, const Station &station)
+bool StationTree::insert(const NodePtr &node, const Station &station, NodePtr &result)
 {
     if (!node)
     {
-        node = new Node(station);
+        result = std::make_shared<const Node>(station, nullptr, nullptr);
         return true;
     }
+    NodePtr child;
     if (station.getId() < node->data.getId())
     {
-        return insert(node->left, station);
+        if (!insert(node->left, station, child))
+        {
+            return false;
+        }
+        result = std::make_shared<const Node>(node->data, child, node->right);
+        return true;
     }
     if (station.getId() > node->data.getId())
     {
-        return insert(node->right, station);
+        if (!insert(node->right, station, child))
+        {
+            return false;
+        }
+        result = std::make_shared<const Node>(node->data, node->left, child);
+        return true;
     }
     return false;
 }
 
-bool StationTree::remove(Node *&node, int id)
+bool StationTree::remove(const NodePtr &node, int id, NodePtr &result)
 {
     if (!node)
     {
         return false;
     }
+    NodePtr child;
     if (id < node->data.getId())
     {
-        return remove(node->left, id);
+        if (!remove(node->left, id, child))
+        {
+            return false;
+        }
+        result = std::make_shared<const Node>(node->data, child, node->right);
+        return true;
     }
     if (id > node->data.getId())
     {
-        return remove(node->right, id);
-    }
-    if (!node->left && !node->right)
-    {
-        delete node;
-        node = nullptr;
+        if (!remove(node->right, id, child))
+        {
+            return false;
+        }
+        result = std::make_shared<const Node>(node->data, node->left, child);
         return true;
     }
     if (!node->left)
     {
-        Node *temp = node;
-        node = node->right;
-        delete temp;
+        result = node->right;
         return true;
     }
     if (!node->right)
     {
-        Node *temp = node;
-        node = node->left;
-        delete temp;
+        result = node->left;
         return true;
     }
-    Node *minNode = findMin(node->right);
-    node->data = minNode->data;
-    return remove(node->right, minNode->data.getId());
+    const Node *minNode = findMin(node->right.get());
+    remove(node->right, minNode->data.getId(), child);
+    result = std::make_shared<const Node>(minNode->data, node->left, child);
+    return true;
 }
 
-StationTree::Node *StationTree::findMin(Node *node)
+const StationTree::Node *StationTree::findMin(const Node *node)
 {
-    Node *current = node;
+    const Node *current = node;
     while (current && current->left)
     {
-        current = current->left;
+        current = current->left.get();
     }
     return current;
 }
 
-bool StationTree::find(Node *node, int id, Station &station) const
+bool StationTree::find(const Node *node, int id, Station &station) const
 {
     if (!node)
     {
@@ -157,67 +190,58 @@ bool StationTree::find(Node *node, int id, Station &station) const
     }
     if (id < node->data.getId())
     {
-        return find(node->left, id, station);
+        return find(node->left.get(), id, station);
     }
     if (id > node->data.getId())
     {
-        return find(node->right, id, station);
+        return find(node->right.get(), id, station);
     }
     station = node->data;
     return true;
 }
 
-void StationTree::inOrder(Node *node, std::vector<Station> &result) const
+void StationTree::inOrder(const Node *node, std::vector<Station> &result) const
 {
     if (!node)
     {
         return;
     }
-    inOrder(node->left, result);
+    inOrder(node->left.get(), result);
     result.push_back(node->data);
-    inOrder(node->right, result);
+    inOrder(node->right.get(), result);
 }
 
-void StationTree::preOrder(Node *node, std::vector<Station> &result) const
+void StationTree::preOrder(const Node *node, std::vector<Station> &result) const
 {
     if (!node)
     {
         return;
     }
     result.push_back(node->data);
-    preOrder(node->left, result);
-    preOrder(node->right, result);
+    preOrder(node->left.get(), result);
+    preOrder(node->right.get(), result);
 }
 
-void StationTree::postOrder(Node *node, std::vector<Station> &result) const
+void StationTree::postOrder(const Node *node, std::vector<Station> &result) const
 {
     if (!node)
     {
         return;
     }
-    postOrder(node->left, result);
-    postOrder(node->right, result);
+    postOrder(node->left.get(), result);
+    postOrder(node->right.get(), result);
     result.push_back(node->data);
 }
 
-void StationTree::clear(Node *node)
+StationTree::NodePtr StationTree::forEach(const NodePtr &node, const std::function<void(Station &)> &callback)
 {
     if (!node)
     {
-        return;
-    }
-    clear(node->left);
-    clear(node->right);
-    delete node;
-}
-
-void StationTree::forEach(Node *node, const std::function<void(Station &)> &callback)
-{
-    if (!node)
-    {
-        return;
+        return nullptr;
     }
-    callback(node->data);
-    forEach(node->left, callback);
-    forEach(node->right, callback);
+    Station data = node->data;
+    callback(data);
+    NodePtr left = forEach(node->left, callback);
+    NodePtr right = forEach(node->right, callback);
+    return std::make_shared<const Node>(data, left, right);
 }
@@ -2,16 +2,18 @@
 
 #include "Station.h"
 #include <functional>
+#include <memory>
 #include <vector>
 
+// Árbol persistente: las modificaciones copian solo el camino desde la raíz y las copias del árbol comparten los nodos
 class StationTree
 {
 public:
     StationTree();
-    ~StationTree();
     bool insert(const Station &station);
     bool remove(int id);
     bool find(int id, Station &station) const;
+    const Station *lookup(int id) const;
     std::vector<Station> inOrder() const;
     std::vector<Station> preOrder() const;
     std::vector<Station> postOrder() const;
@@ -20,22 +22,23 @@ public:
     int size() const;
     void forEach(const std::function<void(Station &)> &callback);
 private:
+    struct Node;
+    using NodePtr = std::shared_ptr<const Node>;
     struct Node
     {
         Station data;
-        Node *left;
-        Node *right;
-        Node(const Station &station);
+        NodePtr left;
+        NodePtr right;
+        Node(const Station &station, NodePtr leftChild, NodePtr rightChild);
     };
-    Node *root;
+    NodePtr root;
     int nodeCount;
-    bool insert(Node *&node, const Station &station);
-    bool remove(Node *&node, int id);
-    Node *findMin(Node *node);
-    bool find(Node *node, int id, Station &station) const;
-    void inOrder(Node *node, std::vector<Station> &result) const;
-    void preOrder(Node *node, std::vector<Station> &result) const;
-    void postOrder(Node *node, std::vector<Station> &result) const;
-    void clear(Node *node);
-    void forEach(Node *node, const std::function<void(Station &)> &callback);
+    static bool insert(const NodePtr &node, const Station &station, NodePtr &result);
+    static bool remove(const NodePtr &node, int id, NodePtr &result);
+    static const Node *findMin(const Node *node);
+    bool find(const Node *node, int id, Station &station) const;
+    void inOrder(const Node *node, std::vector<Station> &result) const;
+    void preOrder(const Node *node, std::vector<Station> &result) const;
+    void postOrder(const Node *node, std::vector<Station> &result) const;
+    static NodePtr forEach(const NodePtr &node, const std::function<void(Station &)> &callback);
 };
@@ -0,0 +1,94 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(int threadCount)
+    : running(0), stopping(false)
+{
+    if (threadCount <= 0)
+    {
+        threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    workers.reserve(threadCount);
+    for (int i = 0; i < threadCount; ++i)
+    {
+        workers.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    taskAvailable.notify_one();
+}
+
+void ThreadPool::parallelFor(int count, const std::function<void(int begin, int end)> &body)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+    // Bloques contiguos, varios por hilo para repartir mejor las consultas lentas
+    int chunks = std::min(count, size() * 4);
+    int chunkSize = (count + chunks - 1) / chunks;
+    for (int begin = 0; begin < count; begin += chunkSize)
+    {
+        int end = std::min(count, begin + chunkSize);
+        submit([&body, begin, end]() { body(begin, end); });
+    }
+    wait();
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this]() { return tasks.empty() && running == 0; });
+}
+
+int ThreadPool::size() const
+{
+    return static_cast<int>(workers.size());
+}
+
+void ThreadPool::workerLoop()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            taskAvailable.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (tasks.empty())
+            {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+            ++running;
+        }
+        task();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --running;
+            if (tasks.empty() && running == 0)
+            {
+                idle.notify_all();
+            }
+        }
+    }
+}
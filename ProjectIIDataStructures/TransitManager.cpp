@@ -7,13 +7,35 @@
 #include <limits>
 
 TransitManager::TransitManager()
+    : version(0), landmarksEnabled(false), landmarkRoutesVersion(0), hubLabelsEnabled(false), hubLabelsVersion(0), indexWorker(1)
 {
     dataManager.setBasePath(QCoreApplication::applicationDirPath());
+    publishSnapshot();
+}
+
+TransitManager::TransitManager(const QString &dataPath)
+    : dataManager(dataPath), version(0), landmarksEnabled(false), landmarkRoutesVersion(0), hubLabelsEnabled(false), hubLabelsVersion(0), indexWorker(1)
+{
+    publishSnapshot();
+}
+
+TransitManager::~TransitManager()
+{
+    for (const auto &cancel : {landmarkCancel, hubLabelCancel})
+    {
+        if (cancel)
+        {
+            *cancel = true;
+        }
+    }
 }
 
 void TransitManager::initialize()
 {
     dataManager.load(tree, graph);
+    loadLandmarks();
+    loadHubLabels();
+    publishSnapshot();
 }
 
 void TransitManager::saveData()
@@ -49,6 +71,7 @@ bool TransitManager::addStation(int id, const QString &name, const std::optional
     }
     dataManager.appendReportLine(QString("%1 Estación agregada: %2 - %3").arg(QDateTime::currentDateTime().toString("dd/MM/yyyy hh:mm"), QString::number(id), trimmedName));
     saveData();
+    publishSnapshot();
     
     // Si la estación tiene coordenadas, generar rutas automáticas a estaciones cercanas
     if (position.has_value())
@@ -71,6 +94,7 @@ bool TransitManager::removeStation(int id)
         return false;
     }
     graph.removeStation(id);
+    publishSnapshot();
     dataManager.appendReportLine(QString("%1 Estación eliminada: %2 - %3").arg(QDateTime::currentDateTime().toString("dd/MM/yyyy hh:mm"), QString::number(id), station.getName()));
     saveData();
     return true;
@@ -96,6 +120,7 @@ bool TransitManager::addRoute(int fromId, int toId, const std::optional<double>
     {
         return false;
     }
+    publishSnapshot();
     dataManager.appendReportLine(QString("%1 Ruta agregada: %2 ⇄ %3 (%4 minutos)")
                                      .arg(QDateTime::currentDateTime().toString("dd/MM/yyyy hh:mm"),
                                           QString::number(fromId),
@@ -111,6 +136,7 @@ bool TransitManager::removeRoute(int fromId, int toId)
     {
         return false;
     }
+    publishSnapshot();
     dataManager.appendReportLine(QString("%1 Ruta eliminada: %2 ⇄ %3").arg(QDateTime::currentDateTime().toString("dd/MM/yyyy hh:mm"), QString::number(fromId), QString::number(toId)));
     saveData();
     return true;
@@ -157,6 +183,11 @@ std::vector<GraphEdge> TransitManager::getRoutes() const
     return graph.getConnections();
 }
 
+std::vector<GraphEdge> TransitManager::getRoutesOf(int stationId) const
+{
+    return graph.getConnectionsOf(stationId);
+}
+
 std::vector<std::pair<int, int>> TransitManager::getClosures() const
 {
     return graph.getClosures();
@@ -166,6 +197,7 @@ void TransitManager::reloadClosures()
 {
     auto closures = dataManager.loadClosures();
     graph.applyClosures(closures);
+    publishSnapshot();
 }
 
 std::vector<int> TransitManager::runBfs(int startId)
@@ -180,22 +212,129 @@ std::vector<int> TransitManager::runDfs(int startId)
 
 PathDetail TransitManager::runDijkstra(int startId, int endId)
 {
-    return graph.dijkstra(startId, endId);
+    return routeCache.route(graph, startId, endId, RouteAlgorithm::Dijkstra);
+}
+
+std::shared_ptr<const ShortestPathTree> TransitManager::shortestPathTree(int sourceId) const
+{
+    return graph.shortestPathTree(sourceId);
 }
 
 PathDetail TransitManager::runFloyd(int startId, int endId)
 {
-    return graph.floydWarshall(startId, endId);
+    return routeCache.route(graph, startId, endId, RouteAlgorithm::FloydWarshall);
+}
+
+PathDetail TransitManager::runAlt(int startId, int endId)
+{
+    return routeCache.route(graph, startId, endId, RouteAlgorithm::Alt, getLandmarks().get());
+}
+
+std::vector<PathDetail> TransitManager::runKShortestPaths(int startId, int endId, int k)
+{
+    return graph.kShortestPaths(startId, endId, k, QueryOptions(), queryPool());
+}
+
+void TransitManager::setLandmarksEnabled(bool enabled)
+{
+    if (landmarksEnabled == enabled)
+    {
+        return;
+    }
+    landmarksEnabled = enabled;
+    if (!enabled)
+    {
+        if (landmarkCancel)
+        {
+            *landmarkCancel = true;
+        }
+        std::lock_guard<std::mutex> lock(indexMutex);
+        landmarks.reset();
+        landmarkRoutesVersion = 0;
+        return;
+    }
+    loadLandmarks();
+    if (graph.getRoutesVersion() != landmarkRoutesVersion)
+    {
+        scheduleLandmarkRebuild();
+    }
+}
+
+std::shared_ptr<const LandmarkTable> TransitManager::getLandmarks() const
+{
+    std::lock_guard<std::mutex> lock(indexMutex);
+    return landmarks;
+}
+
+void TransitManager::setHubLabelsEnabled(bool enabled)
+{
+    if (hubLabelsEnabled == enabled)
+    {
+        return;
+    }
+    hubLabelsEnabled = enabled;
+    if (!enabled)
+    {
+        if (hubLabelCancel)
+        {
+            *hubLabelCancel = true;
+        }
+        std::lock_guard<std::mutex> lock(indexMutex);
+        hubLabels.reset();
+        hubLabelsVersion = 0;
+        return;
+    }
+    loadHubLabels();
+    if (graph.getVersion() != hubLabelsVersion)
+    {
+        scheduleHubLabelRebuild();
+    }
+}
+
+std::shared_ptr<const HubLabels> TransitManager::getHubLabels() const
+{
+    std::lock_guard<std::mutex> lock(indexMutex);
+    return hubLabels;
+}
+
+void TransitManager::waitForIndexes()
+{
+    indexWorker.wait();
 }
 
 TreeDetail TransitManager::runPrim()
 {
-    return graph.prim();
+    return graph.prim(QueryOptions());
 }
 
+// Devuelve el bosque mantenido entre cambios, con los mismos tramos que kruskal
 TreeDetail TransitManager::runKruskal()
 {
-    return graph.kruskal();
+    return *graph.spanningForest();
+}
+
+TreeDetail TransitManager::runBoruvka()
+{
+    return graph.boruvka(QueryOptions(), queryPool());
+}
+
+HopTable TransitManager::runReachability()
+{
+    std::vector<int> ids;
+    for (const Station &station : graph.getStations())
+    {
+        ids.push_back(station.getId());
+    }
+    return graph.hopCounts(ids, QueryOptions(), queryPool());
+}
+
+ThreadPool *TransitManager::queryPool()
+{
+    if (!searchPool)
+    {
+        searchPool = std::make_unique<ThreadPool>();
+    }
+    return searchPool.get();
 }
 
 QString TransitManager::buildTraversalText(const QString &title, const std::vector<Station> &stations) const
@@ -267,14 +406,19 @@ void TransitManager::saveReportContent(const QString &content)
 
 QString TransitManager::getStationName(int id) const
 {
-    Station station;
-    if (tree.find(id, station))
+    const Station *station = tree.lookup(id);
+    if (station)
     {
-        return station.getName();
+        return station->getName();
     }
     return QString();
 }
 
+const Station *TransitManager::findStation(int id) const
+{
+    return tree.lookup(id);
+}
+
 const StationTree &TransitManager::getTree() const
 {
     return tree;
@@ -285,6 +429,122 @@ const GraphNetwork &TransitManager::getGraph() const
     return graph;
 }
 
+std::shared_ptr<const NetworkSnapshot> TransitManager::snapshot() const
+{
+    return std::atomic_load(&published);
+}
+
+RouteCache &TransitManager::getRouteCache()
+{
+    return routeCache;
+}
+
+void TransitManager::publishSnapshot()
+{
+    // Copiar el árbol y el grafo es barato: comparten nodos y filas con la versión anterior
+    auto next = std::make_shared<NetworkSnapshot>();
+    next->tree = std::make_shared<const StationTree>(tree);
+    next->graph = std::make_shared<const GraphNetwork>(graph);
+    next->version = ++version;
+    std::atomic_store(&published, std::shared_ptr<const NetworkSnapshot>(std::move(next)));
+    if (landmarksEnabled && graph.getRoutesVersion() != landmarkRoutesVersion)
+    {
+        scheduleLandmarkRebuild();
+    }
+    if (hubLabelsEnabled && graph.getVersion() != hubLabelsVersion)
+    {
+        scheduleHubLabelRebuild();
+    }
+}
+
+void TransitManager::scheduleLandmarkRebuild()
+{
+    landmarkRoutesVersion = graph.getRoutesVersion();
+    // La reconstrucción pendiente quedó vieja: se cancela y la nueva trabaja sobre una copia de la red actual
+    if (landmarkCancel)
+    {
+        *landmarkCancel = true;
+    }
+    auto cancel = std::make_shared<std::atomic<bool>>(false);
+    landmarkCancel = cancel;
+    if (tree.size() == 0)
+    {
+        return;
+    }
+    GraphNetwork network = graph;
+    QString path = dataManager.getLandmarksPath();
+    indexWorker.submit([this, network, path, cancel]() {
+        QueryOptions options;
+        options.cancelled = cancel.get();
+        auto table = LandmarkTable::build(network, LandmarkTable::kDefaultLandmarks, LandmarkSelection::Avoid, options);
+        if (!table || *cancel)
+        {
+            return;
+        }
+        table->save(path);
+        std::lock_guard<std::mutex> lock(indexMutex);
+        landmarks = table;
+    });
+}
+
+void TransitManager::scheduleHubLabelRebuild()
+{
+    hubLabelsVersion = graph.getVersion();
+    if (hubLabelCancel)
+    {
+        *hubLabelCancel = true;
+    }
+    auto cancel = std::make_shared<std::atomic<bool>>(false);
+    hubLabelCancel = cancel;
+    if (tree.size() == 0)
+    {
+        return;
+    }
+    GraphNetwork network = graph;
+    QString path = dataManager.getHubLabelsPath();
+    indexWorker.submit([this, network, path, cancel]() {
+        QueryOptions options;
+        options.cancelled = cancel.get();
+        auto labels = HubLabels::build(network, options);
+        if (!labels || *cancel)
+        {
+            return;
+        }
+        labels->save(path);
+        std::lock_guard<std::mutex> lock(indexMutex);
+        hubLabels = labels;
+    });
+}
+
+void TransitManager::loadLandmarks()
+{
+    if (!landmarksEnabled)
+    {
+        return;
+    }
+    // Una tabla guardada para la misma red evita recalcular los landmarks al arrancar
+    if (auto stored = LandmarkTable::load(dataManager.getLandmarksPath(), graph))
+    {
+        std::lock_guard<std::mutex> lock(indexMutex);
+        landmarks = stored;
+        landmarkRoutesVersion = graph.getRoutesVersion();
+    }
+}
+
+void TransitManager::loadHubLabels()
+{
+    if (!hubLabelsEnabled)
+    {
+        return;
+    }
+    if (auto stored = HubLabels::load(dataManager.getHubLabelsPath(), graph))
+    {
+        std::lock_guard<std::mutex> lock(indexMutex);
+        hubLabels = stored;
+        hubLabelsVersion = graph.getVersion();
+    }
+}
+
 void TransitManager::scaleStationPositions(double scaleX, double scaleY)
 {
     if (!std::isfinite(scaleX) || !std::isfinite(scaleY) || scaleX <= 0.0 || scaleY <= 0.0)
@@ -306,6 +566,7 @@ void TransitManager::scaleStationPositions(double scaleX, double scaleY)
         return;
     }
     graph.scaleStationPositions(scaleX, scaleY);
+    publishSnapshot();
     saveData();
 }
 
@@ -423,6 +684,7 @@ void TransitManager::generateAutomaticRoutesForStation(int stationId, int maxCon
     
     if (connectionsAdded > 0)
     {
+        publishSnapshot();
         saveData();
     }
 }
@@ -1,13 +1,24 @@
 #pragma once
 
 #include "DataManager.h"
+#include "HubLabels.h"
+#include "LandmarkTable.h"
+#include "NetworkSnapshot.h"
+#include "RouteCache.h"
+#include "ShortestPathTree.h"
+#include "ThreadPool.h"
 #include <QPointF>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <optional>
 
 class TransitManager
 {
 public:
     TransitManager();
+    explicit TransitManager(const QString &dataPath);
+    ~TransitManager();
     void initialize();
     void saveData();
     bool addStation(int id, const QString &name, const std::optional<QPointF> &position = std::nullopt);
@@ -16,15 +27,33 @@ public:
     bool removeRoute(int fromId, int toId);
     std::vector<Station> getStations() const;
     std::vector<GraphEdge> getRoutes() const;
+    std::vector<GraphEdge> getRoutesOf(int stationId) const;
     std::vector<std::pair<int, int>> getClosures() const;
     void reloadClosures();
     QString dataDirectory() const;
     std::vector<int> runBfs(int startId);
     std::vector<int> runDfs(int startId);
     PathDetail runDijkstra(int startId, int endId);
+    std::shared_ptr<const ShortestPathTree> shortestPathTree(int sourceId) const;
     PathDetail runFloyd(int startId, int endId);
+    PathDetail runAlt(int startId, int endId);
+    // Rutas alternativas para despacho: hasta k caminos sin ciclos ordenados por tiempo
+    std::vector<PathDetail> runKShortestPaths(int startId, int endId, int k);
+    // Landmarks para ALT; desactivados por defecto porque cada cambio de rutas los reconstruye y los guarda en el
+    // directorio de datos. Sin ellos, runAlt resuelve como Dijkstra.
+    void setLandmarksEnabled(bool enabled);
+    // Última tabla de landmarks; puede ser de rutas anteriores mientras se reconstruye (astar la descarta sola)
+    std::shared_ptr<const LandmarkTable> getLandmarks() const;
+    // Etiquetas de hubs para consultas de distancia masivas; desactivadas por defecto porque dependen también de los
+    // cierres y se reconstruyen con cada cambio. Sirven solo si graphVersion() coincide con la del grafo consultado.
+    void setHubLabelsEnabled(bool enabled);
+    std::shared_ptr<const HubLabels> getHubLabels() const;
+    void waitForIndexes();
     TreeDetail runPrim();
     TreeDetail runKruskal();
+    TreeDetail runBoruvka();
+    // Saltos entre todas las estaciones con los cierres vigentes, para revisar qué queda incomunicado
+    HopTable runReachability();
     QString buildTraversalText(const QString &title, const std::vector<Station> &stations) const;
     QString exportTraversals();
     QString buildStationsReport() const;
@@ -32,8 +61,11 @@ public:
     void exportTraversalsToFile(const QString &content);
     void saveReportContent(const QString &content);
     QString getStationName(int id) const;
+    const Station *findStation(int id) const;
     const StationTree &getTree() const;
     const GraphNetwork &getGraph() const;
+    std::shared_ptr<const NetworkSnapshot> snapshot() const;
+    RouteCache &getRouteCache();
     std::optional<double> calculateRouteWeightFromCoordinates(int fromId, int toId) const;
     void scaleStationPositions(double scaleX, double scaleY);
     int getNextAvailableStationId() const;
@@ -43,4 +75,27 @@ private:
     StationTree tree;
     GraphNetwork graph;
     DataManager dataManager;
+    std::shared_ptr<const NetworkSnapshot> published;
+    quint64 version;
+    RouteCache routeCache;
+    // Índices que se reconstruyen en segundo plano; indexMutex protege los punteros publicados
+    mutable std::mutex indexMutex;
+    bool landmarksEnabled;
+    std::shared_ptr<const LandmarkTable> landmarks;
+    quint64 landmarkRoutesVersion;
+    std::shared_ptr<std::atomic<bool>> landmarkCancel;
+    bool hubLabelsEnabled;
+    std::shared_ptr<const HubLabels> hubLabels;
+    quint64 hubLabelsVersion;
+    std::shared_ptr<std::atomic<bool>> hubLabelCancel;
+    // Hilos para las consultas que se reparten (desvíos de kShortestPaths, árboles de expansión); se crean con la primera
+    std::unique_ptr<ThreadPool> searchPool;
+    // Último miembro: se destruye primero y espera a la reconstrucción en curso, que usa los anteriores
+    ThreadPool indexWorker;
+    void publishSnapshot();
+    ThreadPool *queryPool();
+    void scheduleLandmarkRebuild();
+    void scheduleHubLabelRebuild();
+    void loadLandmarks();
+    void loadHubLabels();
 };
@@ -0,0 +1,104 @@
+#include "BenchmarkReport.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+BenchmarkResult BenchmarkReport::summarize(const QString &operation, std::vector<double> samplesUs)
+{
+    BenchmarkResult result;
+    result.operation = operation;
+    result.iterations = static_cast<int>(samplesUs.size());
+    if (samplesUs.empty())
+    {
+        return result;
+    }
+    std::sort(samplesUs.begin(), samplesUs.end());
+    double totalUs = std::accumulate(samplesUs.begin(), samplesUs.end(), 0.0);
+    result.totalMs = totalUs / 1000.0;
+    result.throughputPerSecond = totalUs > 0.0 ? samplesUs.size() * 1e6 / totalUs : 0.0;
+    result.p50Us = percentile(samplesUs, 0.50);
+    result.p90Us = percentile(samplesUs, 0.90);
+    result.p99Us = percentile(samplesUs, 0.99);
+    result.maxUs = samplesUs.back();
+    result.peakRssKb = peakRssKb();
+    return result;
+}
+
+long BenchmarkReport::peakRssKb()
+{
+#if defined(__unix__) || defined(__APPLE__)
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#else
+    return 0;
+#endif
+}
+
+void BenchmarkReport::add(const BenchmarkResult &result)
+{
+    results.push_back(result);
+}
+
+void BenchmarkReport::printTable(std::FILE *out) const
+{
+    std::fprintf(out, "%-10s %8s %8s %-28s %6s %12s %12s %12s %12s %10s\n",
+                 "generador", "estac.", "rutas", "operación", "iter", "ops/s", "p50 us", "p99 us", "max us", "pico KB");
+    for (const auto &result : results)
+    {
+        if (result.skipped)
+        {
+            std::fprintf(out, "%-10s %8d %8d %-28s omitido: %s\n", result.generator.toStdString().c_str(), result.stations, result.edges,
+                         result.operation.toStdString().c_str(), result.note.toStdString().c_str());
+            continue;
+        }
+        std::fprintf(out, "%-10s %8d %8d %-28s %6d %12.1f %12.1f %12.1f %12.1f %10ld\n", result.generator.toStdString().c_str(),
+                     result.stations, result.edges, result.operation.toStdString().c_str(), result.iterations, result.throughputPerSecond,
+                     result.p50Us, result.p99Us, result.maxUs, result.peakRssKb);
+    }
+}
+
+void BenchmarkReport::writeJson(std::FILE *out, unsigned int seed) const
+{
+    std::fprintf(out, "{\n  \"seed\": %u,\n  \"results\": [", seed);
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const auto &result = results[i];
+        std::fprintf(out, "%s\n    {\"generator\": \"%s\", \"stations\": %d, \"edges\": %d, \"operation\": \"%s\", ", i == 0 ? "" : ",",
+                     escape(result.generator).toStdString().c_str(), result.stations, result.edges, escape(result.operation).toStdString().c_str());
+        if (result.skipped)
+        {
+            std::fprintf(out, "\"skipped\": true, \"reason\": \"%s\"}", escape(result.note).toStdString().c_str());
+            continue;
+        }
+        std::fprintf(out,
+                     "\"iterations\": %d, \"total_ms\": %.3f, \"throughput_per_s\": %.3f, \"p50_us\": %.3f, \"p90_us\": %.3f, "
+                     "\"p99_us\": %.3f, \"max_us\": %.3f, \"peak_rss_kb\": %ld}",
+                     result.iterations, result.totalMs, result.throughputPerSecond, result.p50Us, result.p90Us, result.p99Us,
+                     result.maxUs, result.peakRssKb);
+    }
+    std::fprintf(out, "\n  ]\n}\n");
+}
+
+double BenchmarkReport::percentile(const std::vector<double> &sorted, double fraction)
+{
+    // Método del rango más cercano
+    size_t rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+    return sorted[std::min(sorted.size() - 1, rank == 0 ? 0 : rank - 1)];
+}
+
+QString BenchmarkReport::escape(const QString &text)
+{
+    QString result = text;
+    return result.replace("\\", "\\\\").replace("\"", "\\\"");
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QString>
+#include <cstdio>
+#include <vector>
+
+struct BenchmarkResult
+{
+    QString generator;
+    int stations = 0;
+    int edges = 0;
+    QString operation;
+    int iterations = 0;
+    double totalMs = 0.0;
+    double throughputPerSecond = 0.0;
+    double p50Us = 0.0;
+    double p90Us = 0.0;
+    double p99Us = 0.0;
+    double maxUs = 0.0;
+    long peakRssKb = 0;
+    bool skipped = false;
+    QString note;
+};
+
+class BenchmarkReport
+{
+public:
+    static BenchmarkResult summarize(const QString &operation, std::vector<double> samplesUs);
+    static long peakRssKb();
+    void add(const BenchmarkResult &result);
+    void printTable(std::FILE *out) const;
+    void writeJson(std::FILE *out, unsigned int seed) const;
+private:
+    std::vector<BenchmarkResult> results;
+    static double percentile(const std::vector<double> &sorted, double fraction);
+    static QString escape(const QString &text);
+};
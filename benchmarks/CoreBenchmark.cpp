@@ -0,0 +1,381 @@
+#include "AllPairsTable.h"
+#include "BenchmarkReport.h"
+#include "DataManager.h"
+#include "DynamicForest.h"
+#include "GraphNetwork.h"
+#include "HubLabels.h"
+#include "LandmarkTable.h"
+#include "SearchQueues.h"
+#include "ShortestPathTree.h"
+#include "StationTree.h"
+#include "SyntheticCity.h"
+#include "ThreadPool.h"
+#include "TransitManager.h"
+#include <QDir>
+#include <QString>
+#include <QStringList>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+struct Options
+{
+    std::vector<int> sizes{100, 300, 1000};
+    QStringList generators{"grid", "geometric", "hub"};
+    int iterations = 50;
+    int heavyIterations = 3;
+    int maxFloydStations = 1000;
+    double maxMatrixMb = 1024.0;
+    unsigned int seed = 42;
+    QString jsonPath;
+};
+
+void printUsage()
+{
+    std::printf("Uso: TransitBenchmarks [--sizes 100,1000,10000] [--generators grid,geometric,hub]\n"
+                "                         [--iterations N] [--heavy-iterations N] [--max-floyd N]\n"
+                "                         [--max-matrix-mb MB] [--seed N] [--json archivo|-]\n");
+}
+
+bool parseOptions(int argc, char **argv, Options &options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string flag = argv[i];
+        if (flag == "--help" || flag == "-h")
+        {
+            printUsage();
+            return false;
+        }
+        if (i + 1 >= argc)
+        {
+            std::fprintf(stderr, "Falta el valor de %s\n", flag.c_str());
+            return false;
+        }
+        QString value = argv[++i];
+        if (flag == "--sizes")
+        {
+            options.sizes.clear();
+            for (const auto &part : value.split(','))
+            {
+                bool ok = false;
+                int size = part.toInt(&ok);
+                if (ok && size > 0)
+                {
+                    options.sizes.push_back(size);
+                }
+            }
+        }
+        else if (flag == "--generators")
+        {
+            options.generators = value.split(',');
+        }
+        else if (flag == "--iterations")
+        {
+            options.iterations = std::max(1, value.toInt());
+        }
+        else if (flag == "--heavy-iterations")
+        {
+            options.heavyIterations = std::max(1, value.toInt());
+        }
+        else if (flag == "--max-floyd")
+        {
+            options.maxFloydStations = value.toInt();
+        }
+        else if (flag == "--max-matrix-mb")
+        {
+            options.maxMatrixMb = value.toDouble();
+        }
+        else if (flag == "--seed")
+        {
+            options.seed = static_cast<unsigned int>(value.toLongLong());
+        }
+        else if (flag == "--json")
+        {
+            options.jsonPath = value;
+        }
+        else
+        {
+            std::fprintf(stderr, "Opción desconocida: %s\n", flag.c_str());
+            printUsage();
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<double> sample(int iterations, const std::function<void(int)> &operation)
+{
+    std::vector<double> samples;
+    samples.reserve(iterations);
+    for (int i = 0; i < iterations; ++i)
+    {
+        auto start = std::chrono::steady_clock::now();
+        operation(i);
+        samples.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    return samples;
+}
+
+class NetworkBenchmark
+{
+public:
+    NetworkBenchmark(const SyntheticNetwork &network, const Options &options, BenchmarkReport &report)
+        : network(network), options(options), report(report), random(options.seed)
+    {
+    }
+
+    void run()
+    {
+        int count = static_cast<int>(network.stations.size());
+        // La matriz densa (base + cierres) ocupa 2·n² doubles
+        double matrixMb = 2.0 * count * static_cast<double>(count) * sizeof(double) / (1024.0 * 1024.0);
+        if (matrixMb > options.maxMatrixMb)
+        {
+            skip("all", QString("la matriz de adyacencia requiere %1 MB (límite %2 MB)")
+                            .arg(QString::number(matrixMb, 'f', 0), QString::number(options.maxMatrixMb, 'f', 0)));
+            return;
+        }
+        GraphNetwork graph;
+        record("build", sample(1, [&](int) { SyntheticCity::populate(network, graph); }));
+        graph.applyClosures({});
+        std::uniform_int_distribution<int> pick(0, count - 1);
+        auto randomId = [&]() { return network.stations[pick(random)].getId(); };
+
+        record("bfs", sample(options.iterations, [&](int) { graph.bfs(randomId()); }));
+        record("dfs", sample(options.iterations, [&](int) { graph.dfs(randomId()); }));
+        record("hopCounts", sample(options.iterations, [&](int) { graph.hopCounts(randomId()); }));
+        record("dijkstra", sample(options.iterations, [&](int) { graph.dijkstra(randomId(), randomId()); }));
+        PathDetail reused;
+        record("dijkstra (reutilizado)", sample(options.iterations, [&](int) { graph.dijkstra(randomId(), randomId(), QueryOptions(), reused); }));
+        // Misma secuencia de pares para comparar las colas de prioridad entre sí
+        std::vector<std::pair<int, int>> pairs(options.iterations);
+        for (auto &pair : pairs)
+        {
+            pair = {randomId(), randomId()};
+        }
+        record("dijkstra[binario perezoso]", sample(options.iterations, [&](int i) {
+                   graph.dijkstraWith<LazyBinaryHeap>(pairs[i].first, pairs[i].second, QueryOptions(), reused);
+               }));
+        record("dijkstra[binario indexado]", sample(options.iterations, [&](int i) {
+                   graph.dijkstraWith<IndexedDaryHeap<2>>(pairs[i].first, pairs[i].second, QueryOptions(), reused);
+               }));
+        record("dijkstra[4-ario indexado]", sample(options.iterations, [&](int i) {
+                   graph.dijkstraWith<IndexedDaryHeap<4>>(pairs[i].first, pairs[i].second, QueryOptions(), reused);
+               }));
+        record("dijkstra[radix]", sample(options.iterations, [&](int i) {
+                   graph.dijkstraWith<RadixHeap>(pairs[i].first, pairs[i].second, QueryOptions(), reused);
+               }));
+        std::shared_ptr<const LandmarkTable> landmarks;
+        record("landmarks (avoid, 8)", sample(1, [&](int) { landmarks = LandmarkTable::build(graph); }));
+        record("astar[ALT]", sample(options.iterations, [&](int i) { graph.astar(pairs[i].first, pairs[i].second, landmarks.get()); }));
+        std::shared_ptr<const HubLabels> hubLabels;
+        record("hubLabels (construcción)", sample(1, [&](int) { hubLabels = HubLabels::build(graph); }));
+        record("hubLabels distance", sample(options.iterations, [&](int i) { hubLabels->distance(pairs[i].first, pairs[i].second); }));
+        record("hubLabels route", sample(options.iterations, [&](int i) { hubLabels->route(pairs[i].first, pairs[i].second); }));
+        std::fprintf(stderr, "  %s\n", hubLabels->memoryReport().toStdString().c_str());
+        int treeSource = randomId();
+        record("shortestPathTree", sample(options.heavyIterations, [&](int) {
+                   graph.pathTreeCache().clear();
+                   graph.shortestPathTree(treeSource);
+               }));
+        record("pathTo (árbol en caché)", sample(options.iterations, [&](int) { graph.shortestPathTree(treeSource)->pathTo(randomId()); }));
+        // Cerrar un tramo del árbol y reabrirlo: cada consulta repara el árbol anterior en vez de recalcularlo
+        record("shortestPathTree (reparado)", sample(options.heavyIterations, [&](int i) {
+                   std::vector<int> path = graph.shortestPathTree(treeSource)->pathTo(randomId());
+                   graph.applyClosures(i % 2 == 0 && path.size() > 1 ? std::vector<std::pair<int, int>>{{path[0], path[1]}}
+                                                                      : std::vector<std::pair<int, int>>());
+                   graph.shortestPathTree(treeSource);
+               }));
+        graph.applyClosures({});
+        // Tabla de distancias: el costo debe crecer con los orígenes, no con los pares
+        std::vector<int> tableSources(std::min(count, 50));
+        std::vector<int> tableTargets(std::min(count, 200));
+        for (auto &id : tableSources)
+        {
+            id = randomId();
+        }
+        for (auto &id : tableTargets)
+        {
+            id = randomId();
+        }
+        ThreadPool pool;
+        record(QString("distanceTable %1x%2").arg(tableSources.size()).arg(tableTargets.size()), sample(options.heavyIterations, [&](int) {
+                   graph.distanceTable(tableSources, tableTargets, QueryOptions(), &pool);
+               }));
+        // Alcance desde todas las estaciones: un BFS por origen frente a lotes de 256 orígenes por bits
+        std::vector<int> allIds;
+        for (const Station &station : network.stations)
+        {
+            allIds.push_back(station.getId());
+        }
+        record("bfs (todos los orígenes)", sample(options.heavyIterations, [&](int) {
+                   for (int id : allIds)
+                   {
+                       graph.bfs(id);
+                   }
+               }));
+        record("hopCounts (todos los orígenes)", sample(options.heavyIterations, [&](int) { graph.hopCounts(allIds); }));
+        record("hopCounts (todos los orígenes, pool)", sample(options.heavyIterations, [&](int) { graph.hopCounts(allIds, QueryOptions(), &pool); }));
+        record("kShortestPaths (k=8)", sample(options.heavyIterations, [&](int i) { graph.kShortestPaths(pairs[i].first, pairs[i].second, 8); }));
+        record("kShortestPaths (k=8, pool)", sample(options.heavyIterations, [&](int i) {
+                   graph.kShortestPaths(pairs[i].first, pairs[i].second, 8, QueryOptions(), &pool);
+               }));
+        if (count <= options.maxFloydStations)
+        {
+            record("floydWarshall", sample(1, [&](int) {
+                       graph.allPairsCache().clear();
+                       graph.floydWarshall(randomId(), randomId());
+                   }));
+            record("floydWarshall (tabla reparada)", sample(options.heavyIterations, [&](int i) {
+                       std::vector<int> path = graph.floydWarshall(randomId(), randomId()).stations;
+                       graph.applyClosures(i % 2 == 0 && path.size() > 1 ? std::vector<std::pair<int, int>>{{path[0], path[1]}}
+                                                                          : std::vector<std::pair<int, int>>());
+                       graph.floydWarshall(randomId(), randomId());
+                   }));
+            graph.applyClosures({});
+        }
+        else
+        {
+            skip("floydWarshall", QString("más de %1 estaciones").arg(options.maxFloydStations));
+        }
+        record("prim", sample(options.heavyIterations, [&](int) { graph.prim(); }));
+        record("kruskal", sample(options.heavyIterations, [&](int) { graph.kruskal(); }));
+        record("kruskal (pool)", sample(options.heavyIterations, [&](int) { graph.kruskal(QueryOptions(), &pool); }));
+        record("boruvka", sample(options.heavyIterations, [&](int) { graph.boruvka(); }));
+        record("boruvka (pool)", sample(options.heavyIterations, [&](int) { graph.boruvka(QueryOptions(), &pool); }));
+        // Cerrar y reabrir un tramo del bosque: cada consulta actualiza el bosque mantenido en vez de recalcularlo
+        graph.spanningForest();
+        record("spanningForest (actualizado)", sample(options.iterations, [&](int i) {
+                   const std::vector<GraphEdge> &edges = graph.spanningForest()->edges;
+                   const GraphEdge &edge = edges[i % std::max<size_t>(1, edges.size())];
+                   graph.applyClosures(edges.empty() ? std::vector<std::pair<int, int>>()
+                                                     : std::vector<std::pair<int, int>>{{edge.from, edge.to}});
+                   graph.spanningForest();
+               }));
+        graph.applyClosures({});
+        // Solo cierres de tramos del bosque, que buscan reemplazo recorriendo el lado chico; la reapertura queda fuera
+        const SpanningForestCache &forestCache = graph.spanningForestCache();
+        std::vector<GraphEdge> forestEdges = graph.spanningForest()->edges;
+        quint64 rescansBefore = forestCache.rescans();
+        quint64 arcsBefore = forestCache.rescannedArcs();
+        std::vector<double> closeSamples;
+        for (int i = 0; i < options.iterations && !forestEdges.empty(); ++i)
+        {
+            const GraphEdge &edge = forestEdges[random() % forestEdges.size()];
+            graph.applyClosures({{edge.from, edge.to}});
+            auto start = std::chrono::steady_clock::now();
+            graph.spanningForest();
+            closeSamples.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+            graph.applyClosures({});
+            graph.spanningForest();
+        }
+        record("spanningForest (cierre, reexploración)", closeSamples);
+        quint64 rescans = forestCache.rescans() - rescansBefore;
+        quint64 arcs = forestCache.rescannedArcs() - arcsBefore;
+        std::fprintf(stderr, "  reexploración: %.1f tramos por cierre de %lld en la red\n", rescans ? double(arcs) / rescans : 0.0,
+                     static_cast<long long>(2 * graph.getConnections().size()));
+
+        QDir base(QDir::tempPath());
+        QString relative = QString("transit-bench/%1-%2").arg(network.generator).arg(count);
+        QDir(base.filePath(relative)).removeRecursively();
+        base.mkpath(relative);
+        QString directory = base.filePath(relative);
+        StationTree tree;
+        // Insertar en orden aleatorio para que el árbol no degenere en una lista
+        std::vector<Station> shuffled = network.stations;
+        std::shuffle(shuffled.begin(), shuffled.end(), random);
+        for (const auto &station : shuffled)
+        {
+            tree.insert(station);
+        }
+        DataManager dataManager(directory);
+        record("DataManager::save", sample(options.heavyIterations, [&](int) { dataManager.save(tree, graph); }));
+        StationTree loadedTree;
+        GraphNetwork loadedGraph;
+        record("DataManager::load", sample(options.heavyIterations, [&](int) { dataManager.load(loadedTree, loadedGraph); }));
+
+        TransitManager manager(directory);
+        manager.initialize();
+        record("generateAutomaticRoutes", sample(options.heavyIterations, [&](int) {
+                   manager.generateAutomaticRoutesForStation(randomId(), 3);
+               }));
+        QDir(directory).removeRecursively();
+    }
+
+private:
+    const SyntheticNetwork &network;
+    const Options &options;
+    BenchmarkReport &report;
+    std::mt19937 random;
+
+    void record(const QString &operation, const std::vector<double> &samples)
+    {
+        BenchmarkResult result = BenchmarkReport::summarize(operation, samples);
+        result.generator = network.generator;
+        result.stations = static_cast<int>(network.stations.size());
+        result.edges = static_cast<int>(network.edges.size());
+        report.add(result);
+        std::fprintf(stderr, "  %-28s p50 %.1f us\n", operation.toStdString().c_str(), result.p50Us);
+    }
+
+    void skip(const QString &operation, const QString &reason)
+    {
+        BenchmarkResult result;
+        result.generator = network.generator;
+        result.stations = static_cast<int>(network.stations.size());
+        result.edges = static_cast<int>(network.edges.size());
+        result.operation = operation;
+        result.skipped = true;
+        result.note = reason;
+        report.add(result);
+        std::fprintf(stderr, "  %-28s omitido: %s\n", operation.toStdString().c_str(), reason.toStdString().c_str());
+    }
+};
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        return 1;
+    }
+    BenchmarkReport report;
+    for (const auto &generator : options.generators)
+    {
+        for (int size : options.sizes)
+        {
+            std::fprintf(stderr, "%s con %d estaciones\n", generator.toStdString().c_str(), size);
+            SyntheticNetwork network = SyntheticCity::build(generator, size, options.seed);
+            NetworkBenchmark(network, options, report).run();
+        }
+    }
+    if (options.jsonPath.isEmpty())
+    {
+        report.printTable(stdout);
+        return 0;
+    }
+    if (options.jsonPath == "-")
+    {
+        report.writeJson(stdout, options.seed);
+        return 0;
+    }
+    std::FILE *out = std::fopen(options.jsonPath.toStdString().c_str(), "w");
+    if (!out)
+    {
+        std::fprintf(stderr, "No se pudo escribir %s\n", options.jsonPath.toStdString().c_str());
+        return 1;
+    }
+    report.writeJson(out, options.seed);
+    std::fclose(out);
+    report.printTable(stdout);
+    return 0;
+}
@@ -0,0 +1,189 @@
+#include "SyntheticCity.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <unordered_map>
+#include <utility>
+
+SyntheticNetwork SyntheticCity::grid(int stationCount, double spacing)
+{
+    SyntheticNetwork network;
+    network.generator = "grid";
+    int side = std::max(1, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(stationCount)))));
+    network.stations.reserve(stationCount);
+    for (int index = 0; index < stationCount; ++index)
+    {
+        int row = index / side;
+        int column = index % side;
+        network.stations.emplace_back(index + 1, QString("Cuadra %1").arg(index + 1), QPointF(column * spacing, row * spacing));
+    }
+    for (int index = 0; index < stationCount; ++index)
+    {
+        int column = index % side;
+        if (column + 1 < side && index + 1 < stationCount)
+        {
+            network.edges.push_back({index + 1, index + 2, spacing});
+        }
+        if (index + side < stationCount)
+        {
+            network.edges.push_back({index + 1, index + side + 1, spacing});
+        }
+    }
+    return network;
+}
+
+SyntheticNetwork SyntheticCity::randomGeometric(int stationCount, unsigned int seed, int neighbors)
+{
+    SyntheticNetwork network;
+    network.generator = "geometric";
+    std::mt19937 random(seed);
+    // Densidad constante: unas 100 unidades entre estaciones vecinas sin importar el tamaño
+    double side = 100.0 * std::sqrt(static_cast<double>(std::max(1, stationCount)));
+    std::uniform_real_distribution<double> coordinate(0.0, side);
+    network.stations.reserve(stationCount);
+    for (int index = 0; index < stationCount; ++index)
+    {
+        network.stations.emplace_back(index + 1, QString("Parada %1").arg(index + 1), QPointF(coordinate(random), coordinate(random)));
+    }
+    // Celdas de 100 unidades para buscar vecinos cercanos sin comparar todos contra todos
+    const double cellSize = 100.0;
+    int cellsPerSide = static_cast<int>(std::ceil(side / cellSize)) + 1;
+    std::unordered_map<long long, std::vector<int>> cells;
+    auto cellOf = [&](const QPointF &point) {
+        return std::make_pair(static_cast<int>(point.x() / cellSize), static_cast<int>(point.y() / cellSize));
+    };
+    for (int index = 0; index < stationCount; ++index)
+    {
+        auto cell = cellOf(network.stations[index].getPosition());
+        cells[static_cast<long long>(cell.first) * cellsPerSide + cell.second].push_back(index);
+    }
+    std::vector<std::pair<int, int>> seen;
+    for (int index = 0; index < stationCount; ++index)
+    {
+        QPointF origin = network.stations[index].getPosition();
+        auto cell = cellOf(origin);
+        std::vector<std::pair<double, int>> candidates;
+        for (int radius = 1; radius <= cellsPerSide && static_cast<int>(candidates.size()) < neighbors; ++radius)
+        {
+            candidates.clear();
+            for (int dx = -radius; dx <= radius; ++dx)
+            {
+                for (int dy = -radius; dy <= radius; ++dy)
+                {
+                    auto found = cells.find(static_cast<long long>(cell.first + dx) * cellsPerSide + (cell.second + dy));
+                    if (cell.first + dx < 0 || cell.second + dy < 0 || found == cells.end())
+                    {
+                        continue;
+                    }
+                    for (int other : found->second)
+                    {
+                        if (other != index)
+                        {
+                            candidates.emplace_back(manhattan(origin, network.stations[other].getPosition()), other);
+                        }
+                    }
+                }
+            }
+        }
+        int take = std::min(neighbors, static_cast<int>(candidates.size()));
+        std::partial_sort(candidates.begin(), candidates.begin() + take, candidates.end());
+        for (int i = 0; i < take; ++i)
+        {
+            int a = std::min(index, candidates[i].second);
+            int b = std::max(index, candidates[i].second);
+            seen.emplace_back(a, b);
+        }
+    }
+    std::sort(seen.begin(), seen.end());
+    seen.erase(std::unique(seen.begin(), seen.end()), seen.end());
+    network.edges.reserve(seen.size());
+    for (const auto &pair : seen)
+    {
+        double weight = std::max(1.0, manhattan(network.stations[pair.first].getPosition(), network.stations[pair.second].getPosition()));
+        network.edges.push_back({pair.first + 1, pair.second + 1, weight});
+    }
+    return network;
+}
+
+SyntheticNetwork SyntheticCity::hubAndSpoke(int stationCount, unsigned int seed, int spokesPerHub)
+{
+    SyntheticNetwork network;
+    network.generator = "hub";
+    std::mt19937 random(seed);
+    int hubCount = std::max(1, stationCount / (spokesPerHub + 1));
+    double ringRadius = 200.0 * hubCount;
+    std::uniform_real_distribution<double> angle(0.0, 2.0 * 3.14159265358979323846);
+    std::uniform_real_distribution<double> reach(50.0, 400.0);
+    network.stations.reserve(stationCount);
+    for (int hub = 0; hub < hubCount; ++hub)
+    {
+        double theta = 2.0 * 3.14159265358979323846 * hub / hubCount;
+        QPointF position(ringRadius * (1.0 + std::cos(theta)), ringRadius * (1.0 + std::sin(theta)));
+        network.stations.emplace_back(hub + 1, QString("Terminal %1").arg(hub + 1), position);
+    }
+    // Las terminales forman un anillo con algunos atajos entre terminales cercanas
+    for (int hub = 0; hub < hubCount && hubCount > 1; ++hub)
+    {
+        for (int step = 1; step <= std::min(2, hubCount - 1); ++step)
+        {
+            int other = (hub + step) % hubCount;
+            if (step == 2 && hubCount <= 3)
+            {
+                continue;
+            }
+            network.edges.push_back({hub + 1, other + 1, std::max(1.0, manhattan(network.stations[hub].getPosition(), network.stations[other].getPosition()))});
+        }
+    }
+    std::uniform_int_distribution<int> pickHub(0, hubCount - 1);
+    for (int index = hubCount; index < stationCount; ++index)
+    {
+        int hub = (index - hubCount) % hubCount;
+        QPointF center = network.stations[hub].getPosition();
+        double theta = angle(random);
+        double distance = reach(random);
+        QPointF position(center.x() + distance * std::cos(theta), center.y() + distance * std::sin(theta));
+        network.stations.emplace_back(index + 1, QString("Barrio %1").arg(index + 1), position);
+        network.edges.push_back({hub + 1, index + 1, std::max(1.0, manhattan(center, position))});
+        // Algunos barrios tienen una segunda conexión a otra terminal
+        if (hubCount > 1 && (index % 10) == 0)
+        {
+            int other = pickHub(random);
+            if (other != hub)
+            {
+                network.edges.push_back({other + 1, index + 1, std::max(1.0, manhattan(network.stations[other].getPosition(), position))});
+            }
+        }
+    }
+    return network;
+}
+
+SyntheticNetwork SyntheticCity::build(const QString &generator, int stationCount, unsigned int seed)
+{
+    if (generator == "geometric")
+    {
+        return randomGeometric(stationCount, seed);
+    }
+    if (generator == "hub")
+    {
+        return hubAndSpoke(stationCount, seed);
+    }
+    return grid(stationCount);
+}
+
+void SyntheticCity::populate(const SyntheticNetwork &network, GraphNetwork &graph)
+{
+    graph.clear();
+    for (const auto &station : network.stations)
+    {
+        graph.addStation(station);
+    }
+    for (const auto &edge : network.edges)
+    {
+        graph.addConnection(edge.from, edge.to, edge.weight);
+    }
+}
+
+double SyntheticCity::manhattan(const QPointF &a, const QPointF &b)
+{
+    return std::fabs(a.x() - b.x()) + std::fabs(a.y() - b.y());
+}
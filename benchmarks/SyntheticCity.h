@@ -0,0 +1,24 @@
+#pragma once
+
+#include "GraphNetwork.h"
+#include "Station.h"
+#include <QString>
+#include <vector>
+
+struct SyntheticNetwork
+{
+    QString generator;
+    std::vector<Station> stations;
+    std::vector<GraphEdge> edges;
+};
+
+class SyntheticCity
+{
+public:
+    static SyntheticNetwork grid(int stationCount, double spacing = 100.0);
+    static SyntheticNetwork randomGeometric(int stationCount, unsigned int seed, int neighbors = 4);
+    static SyntheticNetwork hubAndSpoke(int stationCount, unsigned int seed, int spokesPerHub = 50);
+    static SyntheticNetwork build(const QString &generator, int stationCount, unsigned int seed);
+    static void populate(const SyntheticNetwork &network, GraphNetwork &graph);
+    static double manhattan(const QPointF &a, const QPointF &b);
+};
@@ -0,0 +1,1111 @@
+#include "AllPairsTable.h"
+#include "DynamicForest.h"
+#include "GraphNetwork.h"
+#include "HubLabels.h"
+#include "LandmarkTable.h"
+#include "RouteCache.h"
+#include "RouterQueries.h"
+#include "RoutingService.h"
+#include "SearchQueues.h"
+#include "ShortestPathTree.h"
+#include "StationTree.h"
+#include "ThreadPool.h"
+#include "TransitManager.h"
+#include <QDir>
+#include <QFile>
+#include <QString>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+int failures = 0;
+
+#define CHECK(condition)                                                              \
+    do                                                                                \
+    {                                                                                 \
+        if (!(condition))                                                             \
+        {                                                                             \
+            std::fprintf(stderr, "%s:%d: fallo: %s\n", __FILE__, __LINE__, #condition); \
+            ++failures;                                                               \
+        }                                                                             \
+    } while (false)
+
+bool nearlyEqual(double a, double b)
+{
+    return std::fabs(a - b) < 1e-9;
+}
+
+QString makeDataDirectory(const char *name)
+{
+    QDir base(QDir::tempPath());
+    QString relative = QString("transit-core-tests/%1").arg(name);
+    QDir(base.filePath(relative)).removeRecursively();
+    base.mkpath(relative);
+    return base.filePath(relative);
+}
+
+// 1 - 2 - 3
+// |       |
+// 4 ----- 5      6 (aislada)
+GraphNetwork buildSampleGraph()
+{
+    GraphNetwork graph;
+    for (int id = 1; id <= 6; ++id)
+    {
+        graph.addStation(Station(id, QString("Estación %1").arg(id)));
+    }
+    graph.addConnection(1, 2, 4.0);
+    graph.addConnection(2, 3, 3.0);
+    graph.addConnection(1, 4, 1.0);
+    graph.addConnection(4, 5, 2.0);
+    graph.addConnection(3, 5, 1.5);
+    graph.applyClosures({});
+    return graph;
+}
+
+void testStationTree()
+{
+    StationTree tree;
+    CHECK(tree.isEmpty());
+    CHECK(tree.insert(Station(5, "Centro")));
+    CHECK(tree.insert(Station(2, "Norte")));
+    CHECK(tree.insert(Station(8, "Sur")));
+    CHECK(!tree.insert(Station(5, "Repetida")));
+    CHECK(tree.size() == 3);
+    const Station *found = tree.lookup(2);
+    CHECK(found != nullptr && found->getName() == "Norte");
+    auto ordered = tree.inOrder();
+    CHECK(ordered.size() == 3 && ordered[0].getId() == 2 && ordered[2].getId() == 8);
+    CHECK(tree.remove(5));
+    CHECK(tree.lookup(5) == nullptr);
+    CHECK(tree.size() == 2);
+}
+
+void testTraversals()
+{
+    GraphNetwork graph = buildSampleGraph();
+    CHECK((graph.bfs(1) == std::vector<int>{1, 2, 4, 3, 5}));
+    CHECK((graph.dfs(1) == std::vector<int>{1, 2, 3, 5, 4}));
+    CHECK((graph.bfs(6) == std::vector<int>{6}));
+    CHECK(graph.bfs(99).empty());
+}
+
+void testShortestPaths()
+{
+    GraphNetwork graph = buildSampleGraph();
+    PathDetail dijkstra = graph.dijkstra(1, 3);
+    CHECK((dijkstra.stations == std::vector<int>{1, 4, 5, 3}));
+    CHECK(nearlyEqual(dijkstra.total, 4.5));
+    PathDetail floyd = graph.floydWarshall(1, 3);
+    CHECK(floyd.stations == dijkstra.stations);
+    CHECK(nearlyEqual(floyd.total, dijkstra.total));
+    CHECK(graph.dijkstra(1, 6).stations.empty());
+    CHECK(std::isinf(graph.dijkstra(1, 6).total));
+
+    graph.applyClosures({{4, 5}});
+    PathDetail detour = graph.dijkstra(1, 3);
+    CHECK((detour.stations == std::vector<int>{1, 2, 3}));
+    CHECK(nearlyEqual(detour.total, 7.0));
+}
+
+void testSpanningTrees()
+{
+    GraphNetwork graph = buildSampleGraph();
+    TreeDetail prim = graph.prim();
+    TreeDetail kruskal = graph.kruskal();
+    CHECK(prim.edges.size() == 4);
+    CHECK(kruskal.edges.size() == 4);
+    CHECK(nearlyEqual(prim.total, 7.5));
+    CHECK(nearlyEqual(kruskal.total, 7.5));
+    // La estación 6 no tiene tramos: es un componente propio con total 0
+    CHECK(prim.componentTotals.size() == 2 && nearlyEqual(prim.componentTotals[0], 7.5) && nearlyEqual(prim.componentTotals[1], 0.0));
+
+    // Dos cierres parten el ciclo 1-2-3-5-4 y otra línea suelta agrega un componente: prim da un bosque que cubre todo
+    graph.addStation(Station(11, "Norte"));
+    graph.addStation(Station(12, "Sur"));
+    graph.addConnection(11, 12, 2.0);
+    graph.applyClosures({{2, 3}, {4, 5}});
+    TreeDetail forest = graph.prim();
+    CHECK(forest.componentTotals.size() == 4 && forest.edges.size() == 4);
+    CHECK(nearlyEqual(forest.total, 8.5) && nearlyEqual(forest.total, graph.kruskal().total));
+    CHECK((forest.componentTotals == std::vector<double>{5.0, 1.5, 0.0, 2.0}));
+}
+
+void testParallelSpanningTrees()
+{
+    // Más tramos que el umbral de reparto en paralelo, con muchos pesos empatados
+    GraphNetwork graph;
+    const int count = 600;
+    for (int id = 1; id <= count; ++id)
+    {
+        graph.addStation(Station(id, QString("Estación %1").arg(id)));
+    }
+    unsigned int state = 2024;
+    auto next = [&state]() {
+        state = state * 1103515245u + 12345u;
+        return static_cast<int>((state >> 16) & 0x7fff);
+    };
+    for (int edge = 0; edge < 20000; ++edge)
+    {
+        int from = next() % count + 1;
+        graph.addConnection(from, (from + next() % 200) % count + 1, 0.5 * (next() % 8 + 1));
+    }
+    graph.applyClosures({{1, 2}, {5, 6}});
+    auto sortedEdges = [](TreeDetail tree) {
+        std::sort(tree.edges.begin(), tree.edges.end(), [](const GraphEdge &a, const GraphEdge &b) {
+            return std::make_pair(a.from, a.to) < std::make_pair(b.from, b.to);
+        });
+        std::vector<std::pair<int, int>> pairs;
+        for (const auto &edge : tree.edges)
+        {
+            pairs.push_back({edge.from, edge.to});
+        }
+        return pairs;
+    };
+    ThreadPool pool(4);
+    TreeDetail prim = graph.prim();
+    TreeDetail kruskal = graph.kruskal();
+    TreeDetail parallelKruskal = graph.kruskal(QueryOptions(), &pool);
+    TreeDetail boruvka = graph.boruvka();
+    TreeDetail parallelBoruvka = graph.boruvka(QueryOptions(), &pool);
+    CHECK(kruskal.edges.size() == prim.edges.size() && nearlyEqual(kruskal.total, prim.total));
+    // El desempate por índices hace que el bosque sea el mismo, no solo su peso
+    CHECK(sortedEdges(kruskal) == sortedEdges(parallelKruskal));
+    CHECK(sortedEdges(kruskal) == sortedEdges(boruvka));
+    CHECK(sortedEdges(kruskal) == sortedEdges(parallelBoruvka));
+    CHECK(kruskal.componentTotals.size() == prim.componentTotals.size());
+    for (size_t component = 0; component < prim.componentTotals.size(); ++component)
+    {
+        CHECK(nearlyEqual(kruskal.componentTotals[component], prim.componentTotals[component]) &&
+              nearlyEqual(boruvka.componentTotals[component], prim.componentTotals[component]));
+    }
+
+    std::atomic<bool> cancelled(true);
+    QueryOptions options;
+    options.cancelled = &cancelled;
+    CHECK(graph.boruvka(options).status == QueryStatus::Cancelled && graph.kruskal(options, &pool).edges.empty());
+}
+
+void testDynamicSpanningForest()
+{
+    GraphNetwork graph;
+    const int count = 40;
+    for (int id = 1; id <= count; ++id)
+    {
+        graph.addStation(Station(id, QString("Estación %1").arg(id)));
+    }
+    unsigned int state = 31337;
+    auto next = [&state]() {
+        state = state * 1103515245u + 12345u;
+        return static_cast<int>((state >> 16) & 0x7fff);
+    };
+    for (int edge = 0; edge < 70; ++edge)
+    {
+        graph.addConnection(next() % count + 1, next() % count + 1, 0.5 * (next() % 8 + 1));
+    }
+    auto sameForest = [](const TreeDetail &a, const TreeDetail &b) {
+        if (a.edges.size() != b.edges.size() || !nearlyEqual(a.total, b.total) || a.componentTotals.size() != b.componentTotals.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < a.edges.size(); ++i)
+        {
+            if (a.edges[i].from != b.edges[i].from || a.edges[i].to != b.edges[i].to)
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+    CHECK(sameForest(*graph.spanningForest(), graph.kruskal()));
+    SpanningForestCache &cache = graph.spanningForestCache();
+    quint64 rebuilds = cache.rebuilds();
+    // Altas, bajas, cambios de peso y cierres, a veces varios entre dos consultas: el bosque mantenido sigue siendo el de kruskal
+    std::vector<std::pair<int, int>> closures;
+    for (int step = 0; step < 300; ++step)
+    {
+        int from = next() % count + 1;
+        int to = next() % count + 1;
+        switch (next() % 4)
+        {
+        case 0:
+            graph.addConnection(from, to, 0.5 * (next() % 8 + 1));
+            break;
+        case 1:
+        {
+            std::vector<GraphEdge> routes = graph.getConnections();
+            if (!routes.empty())
+            {
+                const GraphEdge &route = routes[next() % routes.size()];
+                graph.removeConnection(route.from, route.to);
+            }
+            break;
+        }
+        case 2:
+            closures.push_back({from, to});
+            if (closures.size() > 4)
+            {
+                closures.erase(closures.begin());
+            }
+            graph.applyClosures(closures);
+            break;
+        default:
+            graph.applyClosures({});
+            closures.clear();
+            break;
+        }
+        if (step % 3 != 0)
+        {
+            CHECK(sameForest(*graph.spanningForest(), graph.kruskal()));
+        }
+    }
+    CHECK(cache.rebuilds() == rebuilds && cache.updates() > 100);
+    CHECK(cache.rescans() > 0 && cache.rescannedArcs() >= cache.rescans());
+    CHECK(graph.spanningForest() == graph.spanningForest());
+
+    // Una copia vieja responde bien sin pisar el bosque de la versión actual
+    GraphNetwork old = graph;
+    graph.addConnection(1, count, 0.1);
+    std::shared_ptr<const TreeDetail> current = graph.spanningForest();
+    CHECK(sameForest(*old.spanningForest(), old.kruskal()));
+    CHECK(graph.spanningForest() == current && cache.rebuilds() == rebuilds);
+}
+
+void testCancellation()
+{
+    GraphNetwork graph = buildSampleGraph();
+    std::atomic<bool> cancelled(false);
+    QueryOptions options;
+    options.cancelled = &cancelled;
+    int lastReported = 0;
+    options.progress = [&](int completed, int total) {
+        CHECK(completed > lastReported && completed <= total);
+        lastReported = completed;
+    };
+    CHECK(graph.floydWarshall(1, 3, options).status == QueryStatus::Completed);
+    CHECK(lastReported == 6);
+    cancelled = true;
+    CHECK(graph.dijkstra(1, 3, options).status == QueryStatus::Cancelled);
+    CHECK(graph.floydWarshall(1, 3, options).stations.empty());
+    CHECK(graph.bfs(1, options).status == QueryStatus::Cancelled);
+    CHECK(graph.prim(options).status == QueryStatus::Cancelled);
+    CHECK(graph.kruskal(options).edges.empty());
+}
+
+void testQueryLimits()
+{
+    GraphNetwork graph = buildSampleGraph();
+    QueryOptions limited;
+    limited.maxSettled = 2;
+    TraversalDetail traversal = graph.bfs(1, limited);
+    CHECK(traversal.status == QueryStatus::SettleLimitReached);
+    CHECK((traversal.stations == std::vector<int>{1, 2}));
+    CHECK(graph.dijkstra(1, 3, limited).stations.empty());
+    // Con 1, 4 y 5 asentadas el destino ya tiene una distancia tentativa y su camino
+    QueryOptions threeSettled;
+    threeSettled.maxSettled = 3;
+    PathDetail partialPath = graph.dijkstra(1, 3, threeSettled);
+    CHECK(partialPath.status == QueryStatus::SettleLimitReached);
+    CHECK((partialPath.stations == std::vector<int>{1, 4, 5, 3}));
+    TreeDetail partialTree = graph.prim(limited);
+    CHECK(partialTree.status == QueryStatus::SettleLimitReached);
+    CHECK(partialTree.edges.size() == 1 && nearlyEqual(partialTree.total, 1.0));
+    CHECK(graph.kruskal(limited).edges.size() == 2);
+
+    QueryOptions expired;
+    expired.deadline = std::chrono::steady_clock::now() - std::chrono::milliseconds(1);
+    CHECK(graph.dfs(1, expired).status == QueryStatus::DeadlineExceeded);
+    CHECK(graph.floydWarshall(1, 3, expired).status == QueryStatus::DeadlineExceeded);
+    QueryOptions generous;
+    generous.setTimeBudget(std::chrono::seconds(60));
+    generous.maxSettled = 100;
+    CHECK(graph.dijkstra(1, 3, generous).status == QueryStatus::Completed);
+    CHECK(nearlyEqual(graph.dijkstra(1, 3, generous).total, 4.5));
+}
+
+void testWorkspaceReuse()
+{
+    GraphNetwork small = buildSampleGraph();
+    GraphNetwork large;
+    for (int id = 1; id <= 40; ++id)
+    {
+        large.addStation(Station(id, QString("Estación %1").arg(id)));
+        if (id > 1)
+        {
+            large.addConnection(id - 1, id, 1.0);
+        }
+    }
+    large.applyClosures({});
+    PathDetail path;
+    TraversalDetail traversal;
+    // Consultas alternadas sobre grafos de distinto tamaño no deben ver marcas de la consulta anterior
+    for (int round = 0; round < 3; ++round)
+    {
+        large.dijkstra(1, 40, QueryOptions(), path);
+        CHECK(path.stations.size() == 40 && nearlyEqual(path.total, 39.0));
+        small.dijkstra(1, 3, QueryOptions(), path);
+        CHECK((path.stations == std::vector<int>{1, 4, 5, 3}));
+        small.dfs(1, QueryOptions(), traversal);
+        CHECK((traversal.stations == std::vector<int>{1, 2, 3, 5, 4}));
+        small.bfs(6, QueryOptions(), traversal);
+        CHECK((traversal.stations == std::vector<int>{6}));
+    }
+    // Una búsqueda lanzada desde el informe de progreso de otra usa un espacio de trabajo distinto
+    QueryOptions nested;
+    bool nestedOk = true;
+    nested.progress = [&](int, int) {
+        nestedOk = nestedOk && nearlyEqual(small.dijkstra(2, 4).total, 5.0);
+    };
+    CHECK(nearlyEqual(small.dijkstra(1, 3, nested).total, 4.5));
+    CHECK(nestedOk);
+}
+
+void testSearchQueues()
+{
+    // Red aleatoria con pesos repetidos: todas las colas deben dar la misma distancia que Floyd-Warshall
+    GraphNetwork graph;
+    const int count = 60;
+    for (int id = 1; id <= count; ++id)
+    {
+        graph.addStation(Station(id, QString("Estación %1").arg(id)));
+    }
+    unsigned int state = 12345;
+    auto next = [&state]() {
+        state = state * 1103515245u + 12345u;
+        return static_cast<int>((state >> 16) & 0x7fff);
+    };
+    for (int edge = 0; edge < 150; ++edge)
+    {
+        int from = next() % count + 1;
+        int to = next() % count + 1;
+        graph.addConnection(from, to, 0.5 * (next() % 8 + 1));
+    }
+    graph.applyClosures({{1, 2}, {3, 4}});
+    // Las listas de adyacencia deben seguir a la matriz tras quitar estaciones y tramos
+    graph.removeStation(count / 2);
+    graph.removeStation(5);
+    graph.removeConnection(1, next() % count + 1);
+    PathDetail lazy;
+    PathDetail binary;
+    PathDetail quaternary;
+    PathDetail radix;
+    for (int target = 2; target <= count; target += 7)
+    {
+        double expected = graph.floydWarshall(1, target).total;
+        graph.dijkstraWith<LazyBinaryHeap>(1, target, QueryOptions(), lazy);
+        graph.dijkstraWith<IndexedDaryHeap<2>>(1, target, QueryOptions(), binary);
+        graph.dijkstraWith<IndexedDaryHeap<4>>(1, target, QueryOptions(), quaternary);
+        graph.dijkstraWith<RadixHeap>(1, target, QueryOptions(), radix);
+        CHECK(std::isinf(expected) ? std::isinf(lazy.total) : nearlyEqual(lazy.total, expected));
+        CHECK(std::isinf(expected) ? std::isinf(binary.total) : nearlyEqual(binary.total, expected));
+        CHECK(std::isinf(expected) ? std::isinf(quaternary.total) : nearlyEqual(quaternary.total, expected));
+        CHECK(std::isinf(expected) ? std::isinf(radix.total) : nearlyEqual(radix.total, expected));
+    }
+}
+
+void testDistanceTable()
+{
+    GraphNetwork graph = buildSampleGraph();
+    const std::vector<int> sources{1, 3, 99, 6};
+    const std::vector<int> targets{3, 5, 1, 6, 3};
+    DistanceTable sequential = graph.distanceTable(sources, targets);
+    ThreadPool pool(3);
+    DistanceTable parallel = graph.distanceTable(sources, targets, QueryOptions(), &pool);
+    CHECK(sequential.distances.size() == sources.size() * targets.size());
+    CHECK(sequential.status == QueryStatus::Completed);
+    for (size_t row = 0; row < sources.size(); ++row)
+    {
+        for (size_t column = 0; column < targets.size(); ++column)
+        {
+            double expected = graph.dijkstra(sources[row], targets[column]).total;
+            double actual = sequential.at(row, column);
+            CHECK(std::isinf(expected) ? std::isinf(actual) : nearlyEqual(actual, expected));
+            CHECK(std::isinf(actual) ? std::isinf(parallel.at(row, column)) : nearlyEqual(actual, parallel.at(row, column)));
+        }
+    }
+    CHECK(nearlyEqual(sequential.at(0, 0), 4.5) && nearlyEqual(sequential.at(1, 2), 4.5));
+    CHECK(nearlyEqual(sequential.at(3, 3), 0.0));
+    QueryOptions limited;
+    limited.maxSettled = 1;
+    DistanceTable partial = graph.distanceTable(sources, targets, limited);
+    CHECK(partial.status == QueryStatus::SettleLimitReached);
+    CHECK(std::isinf(partial.at(0, 0)) && nearlyEqual(partial.at(0, 2), 0.0));
+}
+
+void testHopCounts()
+{
+    // Con pesos unitarios los saltos son las distancias. Una parte densa fuerza el recorrido de abajo hacia arriba
+    // y una cadena larga lo devuelve al de arriba hacia abajo; más de kHopBatch orígenes ocupan dos lotes
+    GraphNetwork graph;
+    const int count = 400;
+    std::vector<int> ids;
+    for (int id = 1; id <= count; ++id)
+    {
+        graph.addStation(Station(id, QString("Estación %1").arg(id)));
+        ids.push_back(id);
+    }
+    unsigned int state = 77;
+    auto next = [&state]() {
+        state = state * 1103515245u + 12345u;
+        return static_cast<int>((state >> 16) & 0x7fff);
+    };
+    for (int edge = 0; edge < 3000; ++edge)
+    {
+        graph.addConnection(next() % 200 + 1, next() % 200 + 1, 1.0);
+    }
+    for (int id = 200; id < count - 10; ++id)
+    {
+        graph.addConnection(id, id + 1, 1.0);
+    }
+    graph.applyClosures({{250, 251}, {300, 301}});
+    std::vector<int> sources = ids;
+    sources.push_back(999);
+    HopTable hops = graph.hopCounts(sources);
+    ThreadPool pool(3);
+    HopTable parallel = graph.hopCounts(sources, QueryOptions(), &pool);
+    DistanceTable distances = graph.distanceTable(sources, ids);
+    CHECK(hops.status == QueryStatus::Completed && hops.stations == ids);
+    CHECK(hops.hops == parallel.hops && hops.reached == parallel.reached);
+    bool matches = true;
+    for (size_t row = 0; row < sources.size(); ++row)
+    {
+        int reached = 0;
+        for (size_t column = 0; column < ids.size(); ++column)
+        {
+            double expected = distances.at(row, column);
+            matches = matches && (std::isinf(expected) ? hops.at(row, column) == -1 : hops.at(row, column) == static_cast<int>(expected));
+            reached += std::isinf(expected) ? 0 : 1;
+        }
+        matches = matches && hops.reached[row] == reached;
+        if (row % 20 == 0)
+        {
+            HopTable single = graph.hopCounts(sources[row]);
+            matches = matches && std::equal(single.hops.begin(), single.hops.end(), hops.hops.begin() + row * ids.size()) &&
+                      single.reached[0] == reached;
+        }
+    }
+    CHECK(matches);
+    CHECK(hops.reached.back() == 0 && hops.at(count, 0) == -1);
+    CHECK(hops.at(count - 1, count - 1) == 0 && hops.reached[count - 1] == 1);
+    QueryOptions limited;
+    limited.maxSettled = 1;
+    HopTable partial = graph.hopCounts(250, limited);
+    CHECK(partial.status == QueryStatus::SettleLimitReached && partial.reached[0] == 1);
+    CHECK(graph.hopCounts(sources, limited).status == QueryStatus::SettleLimitReached);
+}
+
+void testShortestPathTree()
+{
+    GraphNetwork graph = buildSampleGraph();
+    auto tree = graph.shortestPathTree(1);
+    CHECK(tree && tree->status() == QueryStatus::Completed);
+    CHECK((tree->pathTo(3) == std::vector<int>{1, 4, 5, 3}));
+    CHECK(nearlyEqual(tree->distanceTo(3), 4.5) && nearlyEqual(tree->distanceTo(1), 0.0));
+    CHECK(!tree->reaches(6) && tree->pathTo(6).empty() && tree->pathTo(99).empty());
+    CHECK(graph.shortestPathTree(99) == nullptr);
+    quint64 hitsBefore = graph.pathTreeCache().hits();
+    CHECK(graph.shortestPathTree(1) == tree);
+    CHECK(graph.pathTreeCache().hits() == hitsBefore + 1);
+
+    // Una copia comparte la caché mientras no cambie; al mutar el original la copia conserva su árbol
+    GraphNetwork copy = graph;
+    graph.applyClosures({{4, 5}});
+    auto detour = graph.shortestPathTree(1);
+    CHECK(detour != tree && nearlyEqual(detour->distanceTo(3), 7.0));
+    CHECK(copy.shortestPathTree(1) == tree);
+    CHECK(nearlyEqual(tree->distanceTo(3), 4.5));
+    CHECK(graph.pathTreeCache().memoryBytes() >= tree->memoryBytes() + detour->memoryBytes());
+
+    graph.pathTreeCache().setCacheLimit(0);
+    CHECK(graph.pathTreeCache().size() == 0 && graph.pathTreeCache().memoryBytes() == 0);
+    CHECK(graph.shortestPathTree(1) != detour);
+}
+
+void testKShortestPaths()
+{
+    GraphNetwork graph;
+    const int count = 10;
+    for (int id = 1; id <= count; ++id)
+    {
+        graph.addStation(Station(id, QString("Estación %1").arg(id)));
+    }
+    unsigned int state = 99;
+    auto next = [&state]() {
+        state = state * 1103515245u + 12345u;
+        return static_cast<int>((state >> 16) & 0x7fff);
+    };
+    for (int edge = 0; edge < 24; ++edge)
+    {
+        graph.addConnection(next() % count + 1, next() % count + 1, 0.5 * (next() % 8 + 1));
+    }
+    graph.applyClosures({{1, 2}});
+
+    // Referencia: todos los caminos simples por fuerza bruta, ordenados por tiempo
+    std::vector<double> expected;
+    std::vector<int> path{1};
+    std::function<void(double)> enumerate = [&](double total) {
+        if (path.back() == count)
+        {
+            expected.push_back(total);
+            return;
+        }
+        for (const auto &edge : graph.getConnectionsOf(path.back()))
+        {
+            int other = edge.from == path.back() ? edge.to : edge.from;
+            double weight = graph.getWeight(path.back(), other);
+            if (std::isfinite(weight) && std::find(path.begin(), path.end(), other) == path.end())
+            {
+                path.push_back(other);
+                enumerate(total + weight);
+                path.pop_back();
+            }
+        }
+    };
+    enumerate(0);
+    std::sort(expected.begin(), expected.end());
+    CHECK(expected.size() > 12);
+
+    ThreadPool pool(4);
+    for (ThreadPool *usedPool : {static_cast<ThreadPool *>(nullptr), &pool})
+    {
+        std::vector<PathDetail> paths = graph.kShortestPaths(1, count, 12, QueryOptions(), usedPool);
+        CHECK(paths.size() == 12);
+        for (size_t rank = 0; rank < paths.size(); ++rank)
+        {
+            const PathDetail &found = paths[rank];
+            CHECK(nearlyEqual(found.total, expected[rank]) && found.status == QueryStatus::Completed);
+            CHECK(found.stations.front() == 1 && found.stations.back() == count);
+            std::vector<int> sorted = found.stations;
+            std::sort(sorted.begin(), sorted.end());
+            CHECK(std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end());
+            double total = 0;
+            for (size_t step = 1; step < found.stations.size(); ++step)
+            {
+                total += graph.getWeight(found.stations[step - 1], found.stations[step]);
+            }
+            CHECK(nearlyEqual(total, found.total));
+        }
+    }
+    // Pedir más caminos de los que existen devuelve todos; sin camino o con el mismo origen y destino, lo trivial
+    CHECK(graph.kShortestPaths(1, count, 100000).size() == expected.size());
+    CHECK(graph.kShortestPaths(3, 3, 5).size() == 1);
+    graph.addStation(Station(count + 1, "Aislada"));
+    CHECK(graph.kShortestPaths(1, count + 1, 3).empty());
+
+    std::atomic<bool> cancelled(true);
+    QueryOptions options;
+    options.cancelled = &cancelled;
+    std::vector<PathDetail> cancelledPaths = graph.kShortestPaths(1, count, 3, options);
+    CHECK(cancelledPaths.size() == 1 && cancelledPaths[0].stations.empty() && cancelledPaths[0].status == QueryStatus::Cancelled);
+
+    QueryOptions limited;
+    limited.maxSettled = 1;
+    std::vector<PathDetail> limitedPaths = graph.kShortestPaths(1, count, 3, limited);
+    CHECK(limitedPaths.size() == 1 && limitedPaths[0].stations.empty());
+    CHECK(limitedPaths[0].status == QueryStatus::SettleLimitReached);
+}
+
+void testIncrementalRepair()
+{
+    GraphNetwork graph;
+    const int count = 40;
+    for (int id = 1; id <= count; ++id)
+    {
+        graph.addStation(Station(id, QString("Estación %1").arg(id)));
+    }
+    unsigned int state = 4242;
+    auto next = [&state]() {
+        state = state * 1103515245u + 12345u;
+        return static_cast<int>((state >> 16) & 0x7fff);
+    };
+    for (int edge = 0; edge < 90; ++edge)
+    {
+        graph.addConnection(next() % count + 1, next() % count + 1, 0.5 * (next() % 8 + 1));
+    }
+    graph.applyClosures({});
+    std::vector<GraphEdge> edges = graph.getConnections();
+    const std::vector<int> sources{1, 17};
+    for (int source : sources)
+    {
+        graph.shortestPathTree(source);
+    }
+    graph.allPairs();
+
+    // Cierres, reaperturas y cambios de peso: lo reparado debe coincidir con una búsqueda nueva
+    for (int round = 0; round < 15; ++round)
+    {
+        if (round % 4 == 3)
+        {
+            const GraphEdge &edge = edges[next() % edges.size()];
+            graph.addConnection(edge.from, edge.to, 0.5 * (next() % 8 + 1));
+        }
+        else
+        {
+            std::vector<std::pair<int, int>> closures;
+            for (int closed = next() % 3; closed > 0; --closed)
+            {
+                const GraphEdge &edge = edges[next() % edges.size()];
+                closures.push_back({edge.from, edge.to});
+            }
+            graph.applyClosures(closures);
+        }
+        auto table = graph.allPairs();
+        for (int source : sources)
+        {
+            auto tree = graph.shortestPathTree(source);
+            CHECK(tree->graphVersion() == graph.getVersion());
+            for (int target = 1; target <= count; ++target)
+            {
+                double expected = graph.dijkstra(source, target).total;
+                std::vector<int> path = tree->pathTo(target);
+                PathDetail route = table->route(source, target);
+                if (std::isinf(expected))
+                {
+                    CHECK(!tree->reaches(target) && route.stations.empty());
+                    continue;
+                }
+                CHECK(nearlyEqual(tree->distanceTo(target), expected) && nearlyEqual(route.total, expected));
+                double treeLength = 0;
+                double routeLength = 0;
+                for (size_t i = 1; i < path.size(); ++i)
+                {
+                    treeLength += graph.getWeight(path[i - 1], path[i]);
+                }
+                for (size_t i = 1; i < route.stations.size(); ++i)
+                {
+                    routeLength += graph.getWeight(route.stations[i - 1], route.stations[i]);
+                }
+                CHECK(path.front() == source && path.back() == target && nearlyEqual(treeLength, expected));
+                CHECK(route.stations.front() == source && nearlyEqual(routeLength, expected));
+            }
+        }
+    }
+    CHECK(graph.pathTreeCache().repairs() == 2 * 15);
+    CHECK(graph.allPairsCache().repairs() == 15);
+
+    // Con otras estaciones los índices cambian y se calcula desde cero
+    quint64 repairs = graph.pathTreeCache().repairs();
+    graph.addStation(Station(count + 1, "Nueva"));
+    CHECK(graph.shortestPathTree(1)->graphVersion() == graph.getVersion());
+    CHECK(graph.pathTreeCache().repairs() == repairs);
+}
+
+void testLandmarks()
+{
+    GraphNetwork graph;
+    const int count = 50;
+    for (int id = 1; id <= count; ++id)
+    {
+        graph.addStation(Station(id, QString("Estación %1").arg(id)));
+    }
+    unsigned int state = 777;
+    auto next = [&state]() {
+        state = state * 1103515245u + 12345u;
+        return static_cast<int>((state >> 16) & 0x7fff);
+    };
+    for (int edge = 0; edge < 110; ++edge)
+    {
+        graph.addConnection(next() % count + 1, next() % count + 1, 0.5 * (next() % 8 + 1));
+    }
+    graph.applyClosures({{1, 2}});
+    for (LandmarkSelection selection : {LandmarkSelection::Farthest, LandmarkSelection::Avoid})
+    {
+        auto landmarks = LandmarkTable::build(graph, 6, selection);
+        CHECK(landmarks && landmarks->landmarkIds().size() == 6 && landmarks->stationCount() == count);
+        // Las cotas nunca superan la distancia real, y A* con ellas encuentra el mismo tiempo que Dijkstra
+        for (int pair = 0; pair < 60; ++pair)
+        {
+            int from = next() % count + 1;
+            int to = next() % count + 1;
+            PathDetail expected = graph.dijkstra(from, to);
+            PathDetail alt = graph.astar(from, to, landmarks.get());
+            CHECK(landmarks->lowerBound(from - 1, to - 1) <= expected.total + 1e-9);
+            CHECK(std::isinf(expected.total) ? alt.stations.empty() : nearlyEqual(alt.total, expected.total));
+        }
+    }
+
+    // Los cierres no invalidan la tabla; un cambio de rutas sí, y astar vuelve a Dijkstra
+    int cachedTrees = graph.pathTreeCache().size();
+    auto landmarks = LandmarkTable::build(graph);
+    CHECK(graph.pathTreeCache().size() == cachedTrees);
+    graph.applyClosures({{3, 4}, {5, 6}});
+    CHECK(landmarks->routesVersion() == graph.getRoutesVersion());
+    graph.addConnection(1, count, 0.1);
+    CHECK(landmarks->routesVersion() != graph.getRoutesVersion());
+    CHECK(nearlyEqual(graph.astar(1, count, landmarks.get()).total, 0.1));
+
+    QString directory = makeDataDirectory("landmarks");
+    QString path = QDir(directory).filePath("landmarks.bin");
+    auto fresh = LandmarkTable::build(graph, 4);
+    CHECK(fresh->save(path));
+    auto loaded = LandmarkTable::load(path, graph);
+    CHECK(loaded && loaded->landmarkIds() == fresh->landmarkIds() && nearlyEqual(loaded->lowerBound(0, 9), fresh->lowerBound(0, 9)));
+    graph.removeConnection(1, count);
+    CHECK(LandmarkTable::load(path, graph) == nullptr);
+
+    // Sin activarlos, TransitManager no calcula landmarks ni escribe el archivo
+    {
+        QString untouched = makeDataDirectory("landmarks_disabled");
+        TransitManager manager(untouched);
+        manager.initialize();
+        manager.addStation(1, "Uno");
+        manager.addStation(2, "Dos");
+        manager.addRoute(1, 2, 2.0);
+        manager.waitForIndexes();
+        CHECK(!manager.getLandmarks() && !QFile::exists(QDir(untouched).filePath("landmarks.bin")));
+        CHECK(nearlyEqual(manager.runAlt(1, 2).total, 2.0));
+    }
+    // Activados, TransitManager reconstruye en segundo plano, guarda junto a los datos y lo vuelve a leer al arrancar
+    {
+        TransitManager manager(directory);
+        manager.setLandmarksEnabled(true);
+        manager.initialize();
+        manager.addStation(1, "Uno");
+        manager.addStation(2, "Dos");
+        manager.addStation(3, "Tres");
+        manager.addRoute(1, 2, 2.0);
+        manager.addRoute(2, 3, 3.0);
+        manager.waitForIndexes();
+        auto table = manager.getLandmarks();
+        CHECK(table && table->routesVersion() == manager.getGraph().getRoutesVersion());
+        CHECK(nearlyEqual(manager.runAlt(1, 3).total, 5.0));
+    }
+    TransitManager restarted(directory);
+    restarted.setLandmarksEnabled(true);
+    restarted.initialize();
+    auto stored = restarted.getLandmarks();
+    CHECK(stored && stored->routesVersion() == restarted.getGraph().getRoutesVersion());
+}
+
+void testHubLabels()
+{
+    GraphNetwork graph;
+    const int count = 60;
+    for (int id = 1; id <= count; ++id)
+    {
+        graph.addStation(Station(id, QString("Estación %1").arg(id)));
+    }
+    unsigned int state = 4242;
+    auto next = [&state]() {
+        state = state * 1103515245u + 12345u;
+        return static_cast<int>((state >> 16) & 0x7fff);
+    };
+    for (int edge = 0; edge < 140; ++edge)
+    {
+        graph.addConnection(next() % count + 1, next() % count + 1, 0.5 * (next() % 8 + 1));
+    }
+    graph.applyClosures({{1, 2}, {7, 8}});
+    auto labels = HubLabels::build(graph);
+    CHECK(labels && labels->stationCount() == count && labels->graphVersion() == graph.getVersion());
+    // Las distancias coinciden con Dijkstra y cada camino recuperado suma su distancia sobre tramos abiertos
+    for (int pair = 0; pair < 200; ++pair)
+    {
+        int from = next() % count + 1;
+        int to = next() % count + 1;
+        PathDetail expected = graph.dijkstra(from, to);
+        double distance = labels->distance(from, to);
+        CHECK(std::isinf(expected.total) ? std::isinf(distance) : nearlyEqual(distance, expected.total));
+        PathDetail path = labels->route(from, to);
+        if (std::isinf(expected.total))
+        {
+            CHECK(path.stations.empty());
+            continue;
+        }
+        CHECK(!path.stations.empty() && path.stations.front() == from && path.stations.back() == to);
+        double total = 0;
+        for (size_t step = 1; step < path.stations.size(); ++step)
+        {
+            total += graph.getWeight(path.stations[step - 1], path.stations[step]);
+        }
+        CHECK(nearlyEqual(total, expected.total) && nearlyEqual(path.total, expected.total));
+    }
+    CHECK(std::isinf(labels->distance(1, count + 1)));
+
+    QString directory = makeDataDirectory("hub_labels");
+    QString path = QDir(directory).filePath("hub_labels.bin");
+    CHECK(labels->save(path));
+    auto loaded = HubLabels::load(path, graph);
+    CHECK(loaded && loaded->labelEntries() == labels->labelEntries() && nearlyEqual(loaded->distance(3, 9), labels->distance(3, 9)));
+    // A diferencia de los landmarks, las etiquetas dependen de los cierres
+    graph.applyClosures({{1, 2}});
+    CHECK(HubLabels::load(path, graph) == nullptr);
+
+    {
+        TransitManager manager(directory);
+        manager.setHubLabelsEnabled(true);
+        manager.initialize();
+        manager.addStation(1, "Uno");
+        manager.addStation(2, "Dos");
+        manager.addStation(3, "Tres");
+        manager.addRoute(1, 2, 2.0);
+        manager.addRoute(2, 3, 3.0);
+        manager.waitForIndexes();
+        auto current = manager.getHubLabels();
+        CHECK(current && current->graphVersion() == manager.getGraph().getVersion() && nearlyEqual(current->distance(1, 3), 5.0));
+    }
+}
+
+void testRouteCache()
+{
+    GraphNetwork graph = buildSampleGraph();
+    RouteCache cache;
+    PathDetail first = cache.route(graph, 1, 3, RouteAlgorithm::Dijkstra);
+    PathDetail second = cache.route(graph, 1, 3, RouteAlgorithm::Dijkstra);
+    CHECK(cache.misses() == 1 && cache.hits() == 1);
+    CHECK(first.stations == second.stations && nearlyEqual(second.total, 4.5));
+    cache.route(graph, 1, 3, RouteAlgorithm::FloydWarshall);
+    CHECK(cache.misses() == 2 && cache.size() == 2);
+
+    // Un cierre cambia la versión del grafo y la ruta vieja ya no coincide
+    graph.applyClosures({{4, 5}});
+    PathDetail detour = cache.route(graph, 1, 3, RouteAlgorithm::Dijkstra);
+    CHECK(cache.misses() == 3 && nearlyEqual(detour.total, 7.0));
+
+    RouteCacheKey key{1, 2, RouteAlgorithm::Dijkstra, graph.getVersion()};
+    PathDetail partial{{1}, 0.0, QueryStatus::Cancelled};
+    cache.insert(key, partial);
+    PathDetail found;
+    CHECK(!cache.find(key, found));
+
+    cache.setCacheLimit(0);
+    CHECK(cache.size() == 0 && cache.memoryBytes() == 0);
+}
+
+// La misma red que buildSampleGraph, cargada en un TransitManager sobre un directorio temporal
+void populateSampleManager(TransitManager &manager)
+{
+    manager.initialize();
+    for (int id = 1; id <= 6; ++id)
+    {
+        manager.addStation(id, QString("Estación %1").arg(id));
+    }
+    manager.addRoute(1, 2, 4.0);
+    manager.addRoute(2, 3, 3.0);
+    manager.addRoute(1, 4, 1.0);
+    manager.addRoute(4, 5, 2.0);
+    manager.addRoute(3, 5, 1.5);
+}
+
+void testRouterQueries()
+{
+    int origin = 0;
+    int destination = 0;
+    CHECK(parseRouterQuery("1,3", origin, destination) && origin == 1 && destination == 3);
+    CHECK(parseRouterQuery("  4;5\r", origin, destination) && origin == 4 && destination == 5);
+    CHECK(parseRouterQuery("6 2", origin, destination) && origin == 6 && destination == 2);
+    CHECK(!parseRouterQuery("# 1,2", origin, destination));
+    CHECK(!parseRouterQuery("", origin, destination));
+    CHECK(!parseRouterQuery("1,x", origin, destination));
+
+    TransitManager manager(makeDataDirectory("router"));
+    populateSampleManager(manager);
+    const GraphNetwork &graph = manager.getGraph();
+    // Las columnas de CSV son origin,destination,status,total,path; el camino va separado por espacios
+    auto csvPath = [](const std::string &line) {
+        size_t pathStart = line.rfind(',') + 1;
+        std::vector<int> path;
+        std::istringstream stream(line.substr(pathStart));
+        int id = 0;
+        while (stream >> id)
+        {
+            path.push_back(id);
+        }
+        return path;
+    };
+    std::vector<int> ids{1, 2, 3, 4, 5, 6, 99};
+    for (int from : ids)
+    {
+        for (int to : ids)
+        {
+            RouterQuery query{1, from, to};
+            std::string csv = formatRouterResult(query, graph, OutputFormat::Csv, RouterLimits());
+            std::string json = formatRouterResult(query, graph, OutputFormat::JsonLines, RouterLimits());
+            std::string prefix = std::to_string(from) + "," + std::to_string(to) + ",";
+            CHECK(csv.compare(0, prefix.size(), prefix) == 0 && csv.back() == '\n');
+            csv.pop_back();
+            if (from == 99 || to == 99)
+            {
+                CHECK(csv == prefix + "unknown_station,,");
+                continue;
+            }
+            PathDetail expected = manager.runDijkstra(from, to);
+            CHECK(csvPath(csv) == expected.stations);
+            std::string path;
+            for (size_t i = 0; i < expected.stations.size(); ++i)
+            {
+                path += (i == 0 ? "" : ",") + std::to_string(expected.stations[i]);
+            }
+            if (expected.stations.empty())
+            {
+                CHECK(csv == prefix + "unreachable,,");
+                CHECK(json.find("\"status\":\"unreachable\",\"total\":null,\"path\":[]") != std::string::npos);
+                continue;
+            }
+            char total[64];
+            std::snprintf(total, sizeof(total), "%.4f", expected.total);
+            CHECK(csv.find(std::string(",ok,") + total + ",") != std::string::npos);
+            CHECK(json.find(std::string("\"status\":\"ok\",\"total\":") + total + ",\"path\":[" + path + "]}") != std::string::npos);
+        }
+    }
+    RouterLimits limits;
+    limits.maxSettled = 1;
+    CHECK(formatRouterResult({1, 1, 3}, graph, OutputFormat::Csv, limits).find(",settle_limit,") != std::string::npos);
+}
+
+void testRoutingService()
+{
+    ServiceRequest tagged = RoutingService::parse("@abc path 1 3");
+    CHECK(tagged.tag == "abc" && tagged.command == "PATH" && !tagged.mutation);
+    CHECK(tagged.args == std::vector<std::string>({"1", "3"}));
+    CHECK(RoutingService::parse("add_route 1 6 2").mutation);
+    CHECK(RoutingService::parse("  ").command.empty());
+
+    TransitManager manager(makeDataDirectory("service"));
+    populateSampleManager(manager);
+    RoutingService service(manager);
+    // Con una sola estación asentada la búsqueda se corta y la respuesta lo indica
+    service.setQueryBudget(std::chrono::microseconds(0), 1);
+    std::string limited = service.query(RoutingService::parse("DISTANCE 1 3"));
+    CHECK(limited.find("\"complete\":false,\"status\":\"settle_limit\"") != std::string::npos);
+    service.setQueryBudget(std::chrono::microseconds(0), 0);
+    std::string full = service.query(RoutingService::parse("PATH 1 3"));
+    CHECK(full.find("\"path\":[1,4,5,3],\"complete\":true") != std::string::npos);
+    CHECK(service.query(RoutingService::parse("FOO")).find("\"ok\":false") != std::string::npos);
+
+    CHECK(service.mutate(RoutingService::parse("ADD_ROUTE 1 2")).find("\"ok\":false") != std::string::npos);
+    CHECK(service.mutate(RoutingService::parse("ADD_ROUTE 1 x 3")).find("\"ok\":false") != std::string::npos);
+    CHECK(service.mutate(RoutingService::parse("ADD_ROUTE 1 6 2.5abc")).find("\"ok\":false") != std::string::npos);
+    CHECK(service.query(RoutingService::parse("PATH 1 6")).find("\"reachable\":false") != std::string::npos);
+
+    // Una consulta justo después de una mutación de la misma conexión debe ver la ruta nueva
+    ThreadPool readers(4);
+    ThreadPool writer(1);
+    auto pendingMutations = std::make_shared<std::atomic<int>>(0);
+    std::mutex repliesMutex;
+    std::vector<std::string> replies;
+    auto reply = [&](const std::string &response) {
+        std::lock_guard<std::mutex> lock(repliesMutex);
+        replies.push_back(response);
+    };
+    auto arrival = std::chrono::steady_clock::now();
+    service.dispatch(RoutingService::parse("ADD_ROUTE 1 6 2.5"), 1, arrival, pendingMutations, readers, writer, reply);
+    service.dispatch(RoutingService::parse("@after PATH 1 6"), 2, arrival, pendingMutations, readers, writer, reply);
+    writer.wait();
+    readers.wait();
+    CHECK(*pendingMutations == 0);
+    CHECK(replies.size() == 2);
+    for (const std::string &response : replies)
+    {
+        CHECK(response.back() == '\n' && response.find("\"latency_us\":") != std::string::npos);
+        if (response.compare(0, 8, "{\"seq\":1") == 0)
+        {
+            CHECK(response.find("\"ok\":true") != std::string::npos && response.find("\"tag\"") == std::string::npos);
+        }
+        else
+        {
+            CHECK(response.compare(0, 23, "{\"seq\":2,\"tag\":\"after\",") == 0);
+            CHECK(response.find("\"total\":2.5000,\"path\":[1,6]") != std::string::npos);
+        }
+    }
+}
+
+void testPersistence()
+{
+    QString directory = makeDataDirectory("persistence");
+    {
+        TransitManager manager(directory);
+        manager.initialize();
+        CHECK(manager.addStation(10, "Alajuela"));
+        CHECK(manager.addStation(20, "Heredia"));
+        CHECK(manager.addStation(30, "Cartago"));
+        CHECK(manager.addRoute(10, 20, 12.5));
+        CHECK(manager.addRoute(20, 30, 20.0));
+        CHECK(!manager.addRoute(10, 99, 5.0));
+        manager.saveData();
+    }
+    TransitManager reloaded(directory);
+    reloaded.initialize();
+    CHECK(reloaded.getStations().size() == 3);
+    CHECK(reloaded.getStationName(20) == "Heredia");
+    CHECK(reloaded.getRoutes().size() == 2);
+    CHECK(nearlyEqual(reloaded.getGraph().getWeight(10, 20), 12.5));
+    CHECK(reloaded.removeStation(20));
+    CHECK(reloaded.getRoutes().empty());
+}
+
+void testSnapshots()
+{
+    StationTree original;
+    original.insert(Station(2, "B"));
+    original.insert(Station(1, "A"));
+    StationTree copy = original;
+    copy.insert(Station(3, "C"));
+    copy.remove(1);
+    CHECK(original.size() == 2 && original.lookup(1) != nullptr && original.lookup(3) == nullptr);
+    CHECK(copy.size() == 2 && copy.lookup(1) == nullptr && copy.lookup(3) != nullptr);
+
+    QString directory = makeDataDirectory("snapshots");
+    TransitManager manager(directory);
+    manager.initialize();
+    manager.addStation(1, "Uno");
+    manager.addStation(2, "Dos");
+    manager.addRoute(1, 2, 5.0);
+    auto before = manager.snapshot();
+    manager.addStation(3, "Tres");
+    manager.addRoute(2, 3, 1.0);
+    manager.removeRoute(1, 2);
+    auto after = manager.snapshot();
+    CHECK(after->version > before->version);
+    CHECK(before->tree->size() == 2 && before->tree->lookup(3) == nullptr);
+    CHECK(nearlyEqual(before->graph->getWeight(1, 2), 5.0));
+    CHECK(before->graph->getConnections().size() == 1);
+    CHECK(std::isinf(after->graph->getWeight(1, 2)));
+    CHECK(after->tree->size() == 3);
+    CHECK(nearlyEqual(after->graph->dijkstra(2, 3).total, 1.0));
+}
+}
+
+int main()
+{
+    const std::vector<std::pair<const char *, std::function<void()>>> tests = {
+        {"StationTree", testStationTree},
+        {"Traversals", testTraversals},
+        {"ShortestPaths", testShortestPaths},
+        {"SpanningTrees", testSpanningTrees},
+        {"ParallelMst", testParallelSpanningTrees},
+        {"DynamicMst", testDynamicSpanningForest},
+        {"Cancellation", testCancellation},
+        {"QueryLimits", testQueryLimits},
+        {"WorkspaceReuse", testWorkspaceReuse},
+        {"SearchQueues", testSearchQueues},
+        {"DistanceTable", testDistanceTable},
+        {"HopCounts", testHopCounts},
+        {"ShortestPathTree", testShortestPathTree},
+        {"KShortestPaths", testKShortestPaths},
+        {"IncrementalRepair", testIncrementalRepair},
+        {"Landmarks", testLandmarks},
+        {"HubLabels", testHubLabels},
+        {"RouteCache", testRouteCache},
+        {"RouterQueries", testRouterQueries},
+        {"RoutingService", testRoutingService},
+        {"Persistence", testPersistence},
+        {"Snapshots", testSnapshots},
+    };
+    for (const auto &test : tests)
+    {
+        int before = failures;
+        test.second();
+        std::printf("%-16s %s\n", test.first, failures == before ? "ok" : "FALLO");
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+#include "RouterQueries.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+
+bool parseRouterQuery(const std::string &line, int &origin, int &destination)
+{
+    const char *cursor = line.c_str();
+    while (*cursor == ' ' || *cursor == '\t')
+    {
+        ++cursor;
+    }
+    if (*cursor == '\0' || *cursor == '#' || *cursor == '\r')
+    {
+        return false;
+    }
+    char *end = nullptr;
+    long first = std::strtol(cursor, &end, 10);
+    if (end == cursor)
+    {
+        return false;
+    }
+    cursor = end;
+    while (*cursor == ' ' || *cursor == '\t' || *cursor == ',' || *cursor == ';')
+    {
+        ++cursor;
+    }
+    long second = std::strtol(cursor, &end, 10);
+    if (end == cursor)
+    {
+        return false;
+    }
+    origin = static_cast<int>(first);
+    destination = static_cast<int>(second);
+    return true;
+}
+
+std::string formatRouterResult(const RouterQuery &query, const GraphNetwork &graph, OutputFormat format, const RouterLimits &limits)
+{
+    const char *status = "ok";
+    // Un resultado por hilo: dijkstra reutiliza su capacidad en cada consulta
+    thread_local PathDetail detail;
+    detail.stations.clear();
+    detail.total = std::numeric_limits<double>::infinity();
+    if (!graph.hasStation(query.origin) || !graph.hasStation(query.destination))
+    {
+        status = "unknown_station";
+    }
+    else
+    {
+        // El plazo es por consulta y empieza a contar al iniciarla
+        QueryOptions options;
+        if (limits.deadlineMs > 0)
+        {
+            options.setTimeBudget(std::chrono::milliseconds(limits.deadlineMs));
+        }
+        options.maxSettled = limits.maxSettled;
+        graph.dijkstra(query.origin, query.destination, options, detail);
+        if (detail.status != QueryStatus::Completed)
+        {
+            status = queryStatusName(detail.status);
+        }
+        else if (detail.stations.empty())
+        {
+            status = "unreachable";
+        }
+    }
+    char number[64];
+    std::string line;
+    line.reserve(64 + detail.stations.size() * 8);
+    if (format == OutputFormat::Csv)
+    {
+        line += std::to_string(query.origin) + "," + std::to_string(query.destination) + "," + status + ",";
+        if (!detail.stations.empty())
+        {
+            std::snprintf(number, sizeof(number), "%.4f", detail.total);
+            line += number;
+        }
+        line += ",";
+        for (size_t i = 0; i < detail.stations.size(); ++i)
+        {
+            if (i > 0)
+            {
+                line += ' ';
+            }
+            line += std::to_string(detail.stations[i]);
+        }
+    }
+    else
+    {
+        line += "{\"origin\":" + std::to_string(query.origin) + ",\"destination\":" + std::to_string(query.destination) +
+                ",\"status\":\"" + status + "\",\"total\":";
+        if (detail.stations.empty())
+        {
+            line += "null";
+        }
+        else
+        {
+            std::snprintf(number, sizeof(number), "%.4f", detail.total);
+            line += number;
+        }
+        line += ",\"path\":[";
+        for (size_t i = 0; i < detail.stations.size(); ++i)
+        {
+            if (i > 0)
+            {
+                line += ',';
+            }
+            line += std::to_string(detail.stations[i]);
+        }
+        line += "]}";
+    }
+    line += '\n';
+    return line;
+}
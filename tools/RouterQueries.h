@@ -0,0 +1,31 @@
+#pragma once
+
+#include "GraphNetwork.h"
+#include <string>
+
+// Lectura de pares y formato de salida de TransitRouter, aparte del programa para poder probarlos
+
+enum class OutputFormat
+{
+    Csv,
+    JsonLines
+};
+
+struct RouterQuery
+{
+    long lineNumber;
+    int origin;
+    int destination;
+};
+
+// Límites por consulta; 0 = sin límite
+struct RouterLimits
+{
+    long long deadlineMs = 0;
+    int maxSettled = 0;
+};
+
+// Acepta "origen,destino", "origen;destino" u "origen destino"; ignora líneas vacías y comentarios
+bool parseRouterQuery(const std::string &line, int &origin, int &destination);
+// Una línea de salida con la semántica de TransitManager::runDijkstra: el mismo camino y total, o el estado que lo impidió
+std::string formatRouterResult(const RouterQuery &query, const GraphNetwork &graph, OutputFormat format, const RouterLimits &limits);
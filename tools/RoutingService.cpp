@@ -0,0 +1,464 @@
+#include "RoutingService.h"
+#include "ThreadPool.h"
+#include <QString>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <sstream>
+
+RoutingService::RoutingService(TransitManager &transitManager)
+    : manager(transitManager), queriesServed(0), mutationsApplied(0), partialResults(0), queryTimeBudget(0), queryMaxSettled(0)
+{
+}
+
+void RoutingService::setQueryBudget(std::chrono::microseconds timeBudget, int maxSettled)
+{
+    queryTimeBudget = timeBudget;
+    queryMaxSettled = maxSettled;
+}
+
+QueryOptions RoutingService::queryOptions() const
+{
+    QueryOptions options;
+    if (queryTimeBudget.count() > 0)
+    {
+        options.setTimeBudget(queryTimeBudget);
+    }
+    options.maxSettled = queryMaxSettled;
+    return options;
+}
+
+std::string RoutingService::statusFields(QueryStatus status)
+{
+    if (status == QueryStatus::Completed)
+    {
+        return "\"complete\":true";
+    }
+    ++partialResults;
+    return std::string("\"complete\":false,\"status\":\"") + queryStatusName(status) + "\"";
+}
+
+ServiceRequest RoutingService::parse(const std::string &line)
+{
+    ServiceRequest request;
+    std::istringstream stream(line);
+    std::string token;
+    if (!(stream >> token))
+    {
+        return request;
+    }
+    // Un prefijo "@etiqueta" opcional se devuelve en la respuesta para emparejar solicitudes en cola
+    if (token.size() > 1 && token[0] == '@')
+    {
+        request.tag = token.substr(1);
+        if (!(stream >> token))
+        {
+            return request;
+        }
+    }
+    std::transform(token.begin(), token.end(), token.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    request.command = token;
+    std::getline(stream, request.text);
+    size_t start = request.text.find_first_not_of(" \t");
+    request.text = start == std::string::npos ? std::string() : request.text.substr(start);
+    std::istringstream rest(request.text);
+    while (rest >> token)
+    {
+        request.args.push_back(token);
+    }
+    request.mutation = request.command == "ADD_STATION" || request.command == "REMOVE_STATION" || request.command == "ADD_ROUTE" ||
+                       request.command == "REMOVE_ROUTE" || request.command == "RELOAD_CLOSURES" || request.command == "SAVE";
+    return request;
+}
+
+std::string RoutingService::query(const ServiceRequest &request)
+{
+    std::shared_ptr<const NetworkSnapshot> current = manager.snapshot();
+    ++queriesServed;
+    if (request.command == "PATH")
+    {
+        return runPath(*current, request);
+    }
+    if (request.command == "DISTANCE")
+    {
+        return runDistance(*current, request);
+    }
+    if (request.command == "BFS" || request.command == "DFS")
+    {
+        return runTraversal(*current, request);
+    }
+    if (request.command == "REACH")
+    {
+        return runReach(*current, request);
+    }
+    if (request.command == "MST")
+    {
+        return runTree(*current, request);
+    }
+    if (request.command == "STATS")
+    {
+        return runStats(*current);
+    }
+    if (request.command == "PING")
+    {
+        return "\"ok\":true,\"result\":\"pong\"";
+    }
+    return error("comando desconocido: " + request.command);
+}
+
+std::string RoutingService::mutate(const ServiceRequest &request)
+{
+    std::lock_guard<std::mutex> lock(writerLock);
+    bool applied = false;
+    int first = 0;
+    int second = 0;
+    if (request.command == "ADD_STATION")
+    {
+        if (!parseId(request.args, 0, first) || request.args.size() < 2)
+        {
+            return error("uso: ADD_STATION <id> <nombre>");
+        }
+        std::string name = request.text.substr(request.text.find(request.args[0]) + request.args[0].size());
+        applied = manager.addStation(first, QString::fromStdString(name));
+    }
+    else if (request.command == "REMOVE_STATION")
+    {
+        if (!parseId(request.args, 0, first))
+        {
+            return error("uso: REMOVE_STATION <id>");
+        }
+        applied = manager.removeStation(first);
+    }
+    else if (request.command == "ADD_ROUTE")
+    {
+        char *end = nullptr;
+        double weight = request.args.size() >= 3 ? std::strtod(request.args[2].c_str(), &end) : 0.0;
+        if (!parseId(request.args, 0, first) || !parseId(request.args, 1, second) || request.args.size() < 3 || *end != '\0')
+        {
+            return error("uso: ADD_ROUTE <origen> <destino> <minutos>");
+        }
+        applied = manager.addRoute(first, second, weight);
+    }
+    else if (request.command == "REMOVE_ROUTE")
+    {
+        if (!parseId(request.args, 0, first) || !parseId(request.args, 1, second))
+        {
+            return error("uso: REMOVE_ROUTE <origen> <destino>");
+        }
+        applied = manager.removeRoute(first, second);
+    }
+    else if (request.command == "RELOAD_CLOSURES")
+    {
+        manager.reloadClosures();
+        applied = true;
+    }
+    else if (request.command == "SAVE")
+    {
+        manager.saveData();
+        applied = true;
+    }
+    else
+    {
+        return error("comando desconocido: " + request.command);
+    }
+    if (!applied)
+    {
+        return error("la operación fue rechazada");
+    }
+    ++mutationsApplied;
+    return "\"ok\":true";
+}
+
+void RoutingService::dispatch(const ServiceRequest &request, long long sequence, std::chrono::steady_clock::time_point arrival,
+                              std::shared_ptr<std::atomic<int>> pendingMutations, ThreadPool &readers, ThreadPool &writer,
+                              std::function<void(const std::string &)> reply)
+{
+    // Mientras la conexión tenga mutaciones pendientes, sus consultas van detrás de ellas en la cola del escritor
+    bool viaWriter = request.mutation || *pendingMutations > 0;
+    if (request.mutation)
+    {
+        ++*pendingMutations;
+    }
+    auto job = [this, request, sequence, arrival, pendingMutations, reply]() {
+        std::string body = request.mutation ? mutate(request) : query(request);
+        long long latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - arrival).count();
+        std::string response = "{\"seq\":" + std::to_string(sequence);
+        if (!request.tag.empty())
+        {
+            response += ",\"tag\":\"" + escape(request.tag) + "\"";
+        }
+        response += "," + body + ",\"latency_us\":" + std::to_string(latency) + "}\n";
+        if (request.mutation)
+        {
+            --*pendingMutations;
+        }
+        reply(response);
+    };
+    if (viaWriter)
+    {
+        writer.submit(job);
+    }
+    else
+    {
+        readers.submit(job);
+    }
+}
+
+std::string RoutingService::error(const std::string &message)
+{
+    return "\"ok\":false,\"error\":\"" + escape(message) + "\"";
+}
+
+std::string RoutingService::escape(const std::string &text)
+{
+    std::string result;
+    result.reserve(text.size());
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            result += '\\';
+            result += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            char buffer[8];
+            std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+            result += buffer;
+        }
+        else
+        {
+            result += c;
+        }
+    }
+    return result;
+}
+
+std::string RoutingService::runPath(const NetworkSnapshot &snapshot, const ServiceRequest &request)
+{
+    int origin = 0;
+    int destination = 0;
+    if (!parseId(request.args, 0, origin) || !parseId(request.args, 1, destination))
+    {
+        return error("uso: PATH <origen> <destino> [dijkstra|floyd|alt|hub]");
+    }
+    const GraphNetwork &graph = *snapshot.graph;
+    if (!graph.hasStation(origin) || !graph.hasStation(destination))
+    {
+        return error("estación desconocida");
+    }
+    // Con etiquetas de hubs al día el camino sale de ellas sin búsqueda; si no, se resuelve con Dijkstra
+    if (request.args.size() >= 3 && (request.args[2] == "hub" || request.args[2] == "HUB"))
+    {
+        auto labels = manager.getHubLabels();
+        if (labels && labels->graphVersion() == graph.getVersion())
+        {
+            PathDetail detail = labels->route(origin, destination);
+            if (detail.stations.empty())
+            {
+                return "\"ok\":true,\"result\":{\"reachable\":false," + statusFields(detail.status) + "}";
+            }
+            return "\"ok\":true,\"result\":{\"reachable\":true,\"total\":" + formatNumber(detail.total) + ",\"path\":" +
+                   formatIds(detail.stations) + "," + statusFields(detail.status) + "}";
+        }
+    }
+    RouteAlgorithm algorithm = RouteAlgorithm::Dijkstra;
+    if (request.args.size() >= 3 && (request.args[2] == "floyd" || request.args[2] == "FLOYD"))
+    {
+        algorithm = RouteAlgorithm::FloydWarshall;
+    }
+    else if (request.args.size() >= 3 && (request.args[2] == "alt" || request.args[2] == "ALT"))
+    {
+        algorithm = RouteAlgorithm::Alt;
+    }
+    // Los pares repetidos salen de la caché de rutas; la versión del grafo evita servir rutas de otra red
+    RouteCacheKey key{origin, destination, algorithm, graph.getVersion()};
+    RouteCache &cache = manager.getRouteCache();
+    PathDetail detail;
+    if (!cache.find(key, detail))
+    {
+        QueryOptions options = queryOptions();
+        switch (algorithm)
+        {
+        case RouteAlgorithm::FloydWarshall:
+            detail = graph.floydWarshall(origin, destination, options);
+            break;
+        case RouteAlgorithm::Alt:
+            // Si los landmarks todavía son de otras rutas, astar los ignora y resuelve como Dijkstra
+            detail = graph.astar(origin, destination, manager.getLandmarks().get(), options);
+            break;
+        default:
+            detail = graph.dijkstra(origin, destination, options);
+            break;
+        }
+        cache.insert(key, detail);
+    }
+    std::string status = statusFields(detail.status);
+    if (detail.stations.empty())
+    {
+        return "\"ok\":true,\"result\":{\"reachable\":false," + status + "}";
+    }
+    return "\"ok\":true,\"result\":{\"reachable\":true,\"total\":" + formatNumber(detail.total) + ",\"path\":" + formatIds(detail.stations) + "," + status + "}";
+}
+
+std::string RoutingService::runDistance(const NetworkSnapshot &snapshot, const ServiceRequest &request)
+{
+    int origin = 0;
+    int destination = 0;
+    if (!parseId(request.args, 0, origin) || !parseId(request.args, 1, destination))
+    {
+        return error("uso: DISTANCE <origen> <destino>");
+    }
+    const GraphNetwork &graph = *snapshot.graph;
+    if (!graph.hasStation(origin) || !graph.hasStation(destination))
+    {
+        return error("estación desconocida");
+    }
+    auto labels = manager.getHubLabels();
+    bool indexed = labels && labels->graphVersion() == graph.getVersion();
+    PathDetail detail;
+    if (indexed)
+    {
+        detail.total = labels->distance(origin, destination);
+    }
+    else
+    {
+        graph.dijkstra(origin, destination, queryOptions(), detail);
+    }
+    std::string fields = std::string(",\"source\":\"") + (indexed ? "hub_labels" : "dijkstra") + "\"," + statusFields(detail.status);
+    if (std::isinf(detail.total))
+    {
+        return "\"ok\":true,\"result\":{\"reachable\":false" + fields + "}";
+    }
+    return "\"ok\":true,\"result\":{\"reachable\":true,\"total\":" + formatNumber(detail.total) + fields + "}";
+}
+
+std::string RoutingService::runTraversal(const NetworkSnapshot &snapshot, const ServiceRequest &request)
+{
+    int start = 0;
+    if (!parseId(request.args, 0, start))
+    {
+        return error("uso: " + request.command + " <inicio>");
+    }
+    const GraphNetwork &graph = *snapshot.graph;
+    if (!graph.hasStation(start))
+    {
+        return error("estación desconocida");
+    }
+    QueryOptions options = queryOptions();
+    TraversalDetail detail = request.command == "BFS" ? graph.bfs(start, options) : graph.dfs(start, options);
+    return "\"ok\":true,\"result\":{\"order\":" + formatIds(detail.stations) + "," + statusFields(detail.status) + "}";
+}
+
+std::string RoutingService::runReach(const NetworkSnapshot &snapshot, const ServiceRequest &request)
+{
+    int origin = 0;
+    int destination = 0;
+    if (!parseId(request.args, 0, origin) || !parseId(request.args, 1, destination))
+    {
+        return error("uso: REACH <origen> <destino>");
+    }
+    const GraphNetwork &graph = *snapshot.graph;
+    if (!graph.hasStation(origin) || !graph.hasStation(destination))
+    {
+        return error("estación desconocida");
+    }
+    HopTable table = graph.hopCounts(origin, queryOptions());
+    size_t column = std::find(table.stations.begin(), table.stations.end(), destination) - table.stations.begin();
+    int hops = table.at(0, column);
+    bool reachable = hops >= 0;
+    // Un recorrido parcial que ya encontró el destino es una respuesta completa
+    QueryStatus status = reachable ? QueryStatus::Completed : table.status;
+    return std::string("\"ok\":true,\"result\":{\"reachable\":") + (reachable ? "true" : "false") + ",\"hops\":" + std::to_string(hops) +
+           "," + statusFields(status) + "}";
+}
+
+std::string RoutingService::runTree(const NetworkSnapshot &snapshot, const ServiceRequest &request)
+{
+    bool kruskal = !request.args.empty() && (request.args[0] == "kruskal" || request.args[0] == "KRUSKAL");
+    bool boruvka = !request.args.empty() && (request.args[0] == "boruvka" || request.args[0] == "BORUVKA");
+    const GraphNetwork &graph = *snapshot.graph;
+    QueryOptions options = queryOptions();
+    // Las consultas ya corren en el pool del servicio: aquí cada árbol se calcula en un solo hilo
+    TreeDetail detail = kruskal ? graph.kruskal(options) : boruvka ? graph.boruvka(options) : graph.prim(options);
+    std::string edges = "[";
+    for (size_t i = 0; i < detail.edges.size(); ++i)
+    {
+        const auto &edge = detail.edges[i];
+        edges += (i == 0 ? "[" : ",[") + std::to_string(edge.from) + "," + std::to_string(edge.to) + "," + formatNumber(edge.weight) + "]";
+    }
+    edges += "]";
+    std::string components = "[";
+    for (size_t i = 0; i < detail.componentTotals.size(); ++i)
+    {
+        components += (i == 0 ? "" : ",") + formatNumber(detail.componentTotals[i]);
+    }
+    components += "]";
+    return "\"ok\":true,\"result\":{\"total\":" + formatNumber(detail.total) + ",\"edges\":" + edges + ",\"components\":" + components +
+           "," + statusFields(detail.status) + "}";
+}
+
+std::string RoutingService::runStats(const NetworkSnapshot &snapshot) const
+{
+    const GraphNetwork &graph = *snapshot.graph;
+    std::string hubLabelFields;
+    if (auto labels = manager.getHubLabels())
+    {
+        hubLabelFields = ",\"hub_label_entries\":" + std::to_string(labels->labelEntries()) +
+                         ",\"hub_label_bytes\":" + std::to_string(labels->memoryBytes()) +
+                         ",\"hub_labels_current\":" + (labels->graphVersion() == graph.getVersion() ? "true" : "false");
+    }
+    return "\"ok\":true,\"result\":{\"stations\":" + std::to_string(graph.getStations().size()) +
+           ",\"routes\":" + std::to_string(graph.getConnections().size()) +
+           ",\"closures\":" + std::to_string(graph.getClosures().size()) +
+           ",\"queries\":" + std::to_string(queriesServed.load()) +
+           ",\"mutations\":" + std::to_string(mutationsApplied.load()) +
+           ",\"partial\":" + std::to_string(partialResults.load()) +
+           ",\"route_cache_hits\":" + std::to_string(manager.getRouteCache().hits()) +
+           ",\"route_cache_misses\":" + std::to_string(manager.getRouteCache().misses()) + hubLabelFields +
+           ",\"version\":" + std::to_string(snapshot.version) + "}";
+}
+
+bool RoutingService::parseId(const std::vector<std::string> &args, size_t index, int &value)
+{
+    if (index >= args.size())
+    {
+        return false;
+    }
+    char *end = nullptr;
+    long parsed = std::strtol(args[index].c_str(), &end, 10);
+    if (end == args[index].c_str() || *end != '\0')
+    {
+        return false;
+    }
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+std::string RoutingService::formatIds(const std::vector<int> &ids)
+{
+    std::string result = "[";
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+        if (i > 0)
+        {
+            result += ',';
+        }
+        result += std::to_string(ids[i]);
+    }
+    result += "]";
+    return result;
+}
+
+std::string RoutingService::formatNumber(double value)
+{
+    if (!std::isfinite(value))
+    {
+        return "null";
+    }
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "%.4f", value);
+    return buffer;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "TransitManager.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct ServiceRequest
+{
+    std::string tag;
+    std::string command;
+    std::vector<std::string> args;
+    std::string text;
+    bool mutation = false;
+};
+
+class ThreadPool;
+
+class RoutingService
+{
+public:
+    explicit RoutingService(TransitManager &transitManager);
+    static ServiceRequest parse(const std::string &line);
+    // Las consultas leen la instantánea publicada sin bloquear; las mutaciones se serializan con writerLock
+    std::string query(const ServiceRequest &request);
+    std::string mutate(const ServiceRequest &request);
+    static std::string error(const std::string &message);
+    static std::string escape(const std::string &text);
+    // Presupuesto por consulta; al agotarse se responde con el resultado parcial y su estado
+    void setQueryBudget(std::chrono::microseconds timeBudget, int maxSettled);
+    // Encola la solicitud: las mutaciones van al escritor, y también las consultas de una conexión con mutaciones
+    // pendientes (pendingMutations), así cada cliente lee lo que escribió. reply recibe la respuesta completa con seq,
+    // la etiqueta y la latencia medida desde arrival
+    void dispatch(const ServiceRequest &request, long long sequence, std::chrono::steady_clock::time_point arrival,
+                  std::shared_ptr<std::atomic<int>> pendingMutations, ThreadPool &readers, ThreadPool &writer,
+                  std::function<void(const std::string &)> reply);
+private:
+    TransitManager &manager;
+    std::mutex writerLock;
+    std::atomic<long long> queriesServed;
+    std::atomic<long long> mutationsApplied;
+    std::atomic<long long> partialResults;
+    std::chrono::microseconds queryTimeBudget;
+    int queryMaxSettled;
+    QueryOptions queryOptions() const;
+    std::string runPath(const NetworkSnapshot &snapshot, const ServiceRequest &request);
+    std::string runDistance(const NetworkSnapshot &snapshot, const ServiceRequest &request);
+    std::string runTraversal(const NetworkSnapshot &snapshot, const ServiceRequest &request);
+    std::string runReach(const NetworkSnapshot &snapshot, const ServiceRequest &request);
+    std::string runTree(const NetworkSnapshot &snapshot, const ServiceRequest &request);
+    std::string runStats(const NetworkSnapshot &snapshot) const;
+    static bool parseId(const std::vector<std::string> &args, size_t index, int &value);
+    static std::string formatIds(const std::vector<int> &ids);
+    static std::string formatNumber(double value);
+    std::string statusFields(QueryStatus status);
+};
@@ -0,0 +1,173 @@
+#include "RouterQueries.h"
+#include "ThreadPool.h"
+#include "TransitManager.h"
+#include <QDir>
+#include <QString>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+struct Options
+{
+    QString dataPath = QDir::currentPath();
+    std::string inputPath;
+    OutputFormat format = OutputFormat::Csv;
+    int threads = 0;
+    int batchSize = 4096;
+    RouterLimits limits;
+};
+
+void printUsage()
+{
+    std::fprintf(stderr, "Uso: TransitRouter [--data DIRECTORIO] [--input ARCHIVO] [--format csv|jsonl]\n"
+                         "                    [--threads N] [--batch N] [--deadline-ms N] [--max-settled N]\n"
+                         "Lee pares origen,destino (uno por línea) desde la entrada estándar o ARCHIVO.\n"
+                         "Con límites, las consultas que los agotan informan deadline_exceeded o settle_limit\n"
+                         "y, si lo hay, el mejor camino encontrado hasta ese momento.\n");
+}
+
+bool parseOptions(int argc, char **argv, Options &options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string flag = argv[i];
+        if (flag == "--help" || flag == "-h")
+        {
+            printUsage();
+            return false;
+        }
+        if (i + 1 >= argc)
+        {
+            std::fprintf(stderr, "Falta el valor de %s\n", flag.c_str());
+            return false;
+        }
+        std::string value = argv[++i];
+        if (flag == "--data")
+        {
+            options.dataPath = QString::fromStdString(value);
+        }
+        else if (flag == "--input")
+        {
+            options.inputPath = value;
+        }
+        else if (flag == "--format")
+        {
+            if (value != "csv" && value != "jsonl")
+            {
+                std::fprintf(stderr, "Formato desconocido: %s\n", value.c_str());
+                return false;
+            }
+            options.format = value == "csv" ? OutputFormat::Csv : OutputFormat::JsonLines;
+        }
+        else if (flag == "--threads")
+        {
+            options.threads = std::atoi(value.c_str());
+        }
+        else if (flag == "--batch")
+        {
+            options.batchSize = std::max(1, std::atoi(value.c_str()));
+        }
+        else if (flag == "--deadline-ms")
+        {
+            options.limits.deadlineMs = std::max(0LL, std::atoll(value.c_str()));
+        }
+        else if (flag == "--max-settled")
+        {
+            options.limits.maxSettled = std::max(0, std::atoi(value.c_str()));
+        }
+        else
+        {
+            std::fprintf(stderr, "Opción desconocida: %s\n", flag.c_str());
+            printUsage();
+            return false;
+        }
+    }
+    return true;
+}
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        return 1;
+    }
+    std::ifstream file;
+    if (!options.inputPath.empty())
+    {
+        file.open(options.inputPath);
+        if (!file.is_open())
+        {
+            std::fprintf(stderr, "No se pudo abrir %s\n", options.inputPath.c_str());
+            return 1;
+        }
+    }
+    std::istream &input = options.inputPath.empty() ? std::cin : file;
+    std::ios::sync_with_stdio(false);
+
+    TransitManager manager(options.dataPath);
+    manager.initialize();
+    const GraphNetwork &graph = manager.getGraph();
+    std::fprintf(stderr, "Red cargada: %zu estaciones, %zu rutas\n", graph.getStations().size(), graph.getConnections().size());
+
+    ThreadPool pool(options.threads);
+    if (options.format == OutputFormat::Csv)
+    {
+        std::fputs("origin,destination,status,total,path\n", stdout);
+    }
+    // Las consultas se procesan por lotes de tamaño fijo: la memoria no depende del largo de la entrada
+    std::vector<RouterQuery> batch;
+    std::vector<std::string> results;
+    batch.reserve(options.batchSize);
+    std::string line;
+    long lineNumber = 0;
+    long answered = 0;
+    long ignored = 0;
+    bool exhausted = false;
+    while (!exhausted)
+    {
+        batch.clear();
+        while (static_cast<int>(batch.size()) < options.batchSize)
+        {
+            if (!std::getline(input, line))
+            {
+                exhausted = true;
+                break;
+            }
+            ++lineNumber;
+            int origin = 0;
+            int destination = 0;
+            if (parseRouterQuery(line, origin, destination))
+            {
+                batch.push_back({lineNumber, origin, destination});
+            }
+            else if (line.find_first_not_of(" \t\r") != std::string::npos && line[line.find_first_not_of(" \t\r")] != '#')
+            {
+                std::fprintf(stderr, "Línea %ld ignorada: %s\n", lineNumber, line.c_str());
+                ++ignored;
+            }
+        }
+        results.assign(batch.size(), std::string());
+        pool.parallelFor(static_cast<int>(batch.size()), [&](int begin, int end) {
+            for (int i = begin; i < end; ++i)
+            {
+                results[i] = formatRouterResult(batch[i], graph, options.format, options.limits);
+            }
+        });
+        for (const auto &result : results)
+        {
+            std::fwrite(result.data(), 1, result.size(), stdout);
+        }
+        answered += static_cast<long>(batch.size());
+    }
+    std::fflush(stdout);
+    std::fprintf(stderr, "Consultas respondidas: %ld, líneas ignoradas: %ld\n", answered, ignored);
+    return 0;
+}
@@ -0,0 +1,293 @@
+#include "RoutingService.h"
+#include "ThreadPool.h"
+#include "TransitManager.h"
+#include <QDir>
+#include <QString>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+constexpr size_t kMaxLineLength = 64 * 1024;
+constexpr int kMaxInFlightPerConnection = 1024;
+
+std::atomic<bool> stopRequested(false);
+
+void handleSignal(int)
+{
+    stopRequested = true;
+}
+
+struct Options
+{
+    QString dataPath = QDir::currentPath();
+    std::string socketPath = "/tmp/transit-routing.sock";
+    int threads = 0;
+    long long deadlineMs = 0;
+    int maxSettled = 0;
+    bool hubLabels = false;
+    bool landmarks = false;
+};
+
+// Cada conexión puede tener muchas solicitudes en curso; las respuestas se escriben completas bajo writeMutex
+struct Connection
+{
+    explicit Connection(int socketFd) : fd(socketFd), nextSequence(0), inFlight(0), pendingMutations(0)
+    {
+    }
+    ~Connection()
+    {
+        ::close(fd);
+    }
+    int fd;
+    std::string pending;
+    std::mutex writeMutex;
+    long long nextSequence;
+    std::atomic<int> inFlight;
+    std::atomic<int> pendingMutations;
+    std::atomic<bool> broken{false};
+
+    void send(const std::string &message)
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        size_t offset = 0;
+        while (offset < message.size() && !broken)
+        {
+            ssize_t written = ::send(fd, message.data() + offset, message.size() - offset, MSG_NOSIGNAL);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                broken = true;
+                break;
+            }
+            offset += static_cast<size_t>(written);
+        }
+    }
+};
+
+void printUsage()
+{
+    std::fprintf(stderr, "Uso: TransitServer [--data DIRECTORIO] [--socket RUTA] [--threads N]\n"
+                         "                    [--deadline-ms N] [--max-settled N] [--hub-labels 0|1]\n"
+                         "                    [--landmarks 0|1]\n"
+                         "Protocolo: una solicitud por línea, opcionalmente precedida por @etiqueta.\n"
+                         "  PATH <origen> <destino> [dijkstra|floyd|alt|hub]   DISTANCE <origen> <destino>\n"
+                         "  BFS <inicio>   DFS <inicio>\n"
+                         "  REACH <origen> <destino>   MST [prim|kruskal|boruvka]   STATS   PING\n"
+                         "  ADD_STATION <id> <nombre>   REMOVE_STATION <id>\n"
+                         "  ADD_ROUTE <origen> <destino> <minutos>   REMOVE_ROUTE <origen> <destino>\n"
+                         "  RELOAD_CLOSURES   SAVE\n");
+}
+
+bool parseOptions(int argc, char **argv, Options &options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string flag = argv[i];
+        if (flag == "--help" || flag == "-h" || i + 1 >= argc)
+        {
+            printUsage();
+            return false;
+        }
+        std::string value = argv[++i];
+        if (flag == "--data")
+        {
+            options.dataPath = QString::fromStdString(value);
+        }
+        else if (flag == "--socket")
+        {
+            options.socketPath = value;
+        }
+        else if (flag == "--threads")
+        {
+            options.threads = std::atoi(value.c_str());
+        }
+        else if (flag == "--deadline-ms")
+        {
+            options.deadlineMs = std::max(0LL, std::atoll(value.c_str()));
+        }
+        else if (flag == "--max-settled")
+        {
+            options.maxSettled = std::max(0, std::atoi(value.c_str()));
+        }
+        else if (flag == "--hub-labels")
+        {
+            options.hubLabels = value != "0";
+        }
+        else if (flag == "--landmarks")
+        {
+            options.landmarks = value != "0";
+        }
+        else
+        {
+            printUsage();
+            return false;
+        }
+    }
+    return true;
+}
+
+int openListener(const std::string &path)
+{
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path))
+    {
+        std::fprintf(stderr, "Ruta de socket demasiado larga: %s\n", path.c_str());
+        return -1;
+    }
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        std::perror("socket");
+        return -1;
+    }
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    ::unlink(path.c_str());
+    if (::bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 || ::listen(fd, 64) < 0)
+    {
+        std::perror("bind/listen");
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        return 1;
+    }
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    TransitManager manager(options.dataPath);
+    manager.setHubLabelsEnabled(options.hubLabels);
+    manager.setLandmarksEnabled(options.landmarks);
+    manager.initialize();
+    RoutingService service(manager);
+    service.setQueryBudget(std::chrono::milliseconds(options.deadlineMs), options.maxSettled);
+    int listener = openListener(options.socketPath);
+    if (listener < 0)
+    {
+        return 1;
+    }
+    // Las consultas se reparten entre varios hilos; todas las mutaciones pasan por un único escritor en orden de llegada
+    ThreadPool readers(options.threads);
+    ThreadPool writer(1);
+    std::fprintf(stderr, "Escuchando en %s con %d hilos de consulta\n", options.socketPath.c_str(), readers.size());
+
+    std::unordered_map<int, std::shared_ptr<Connection>> connections;
+    std::vector<pollfd> descriptors;
+    char buffer[16 * 1024];
+    while (!stopRequested)
+    {
+        descriptors.clear();
+        descriptors.push_back({listener, POLLIN, 0});
+        for (const auto &entry : connections)
+        {
+            // Si el cliente encola demasiado sin leer respuestas, se deja de leer su socket hasta que se vacíe
+            short events = entry.second->inFlight < kMaxInFlightPerConnection ? POLLIN : 0;
+            descriptors.push_back({entry.first, events, 0});
+        }
+        int ready = ::poll(descriptors.data(), descriptors.size(), 100);
+        if (ready < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            std::perror("poll");
+            break;
+        }
+        if (descriptors[0].revents & POLLIN)
+        {
+            int client = ::accept(listener, nullptr, nullptr);
+            if (client >= 0)
+            {
+                connections[client] = std::make_shared<Connection>(client);
+            }
+        }
+        for (size_t i = 1; i < descriptors.size(); ++i)
+        {
+            if (descriptors[i].revents == 0)
+            {
+                continue;
+            }
+            auto found = connections.find(descriptors[i].fd);
+            if (found == connections.end())
+            {
+                continue;
+            }
+            std::shared_ptr<Connection> connection = found->second;
+            ssize_t received = (descriptors[i].revents & (POLLIN | POLLHUP)) ? ::recv(connection->fd, buffer, sizeof(buffer), 0) : -1;
+            if (received <= 0 || connection->broken)
+            {
+                // Las tareas pendientes conservan la conexión hasta terminar; luego se cierra el socket
+                connections.erase(found);
+                continue;
+            }
+            connection->pending.append(buffer, static_cast<size_t>(received));
+            size_t start = 0;
+            size_t newline = 0;
+            while ((newline = connection->pending.find('\n', start)) != std::string::npos)
+            {
+                std::string line = connection->pending.substr(start, newline - start);
+                start = newline + 1;
+                if (!line.empty() && line.back() == '\r')
+                {
+                    line.pop_back();
+                }
+                if (line.find_first_not_of(" \t") == std::string::npos)
+                {
+                    continue;
+                }
+                auto arrival = std::chrono::steady_clock::now();
+                long long sequence = ++connection->nextSequence;
+                ServiceRequest request = RoutingService::parse(line);
+                ++connection->inFlight;
+                // El contador de mutaciones comparte la vida de la conexión mientras haya tareas pendientes
+                std::shared_ptr<std::atomic<int>> pendingMutations(connection, &connection->pendingMutations);
+                service.dispatch(request, sequence, arrival, pendingMutations, readers, writer, [connection](const std::string &response) {
+                    connection->send(response);
+                    --connection->inFlight;
+                });
+            }
+            connection->pending.erase(0, start);
+            if (connection->pending.size() > kMaxLineLength)
+            {
+                connection->send("{\"ok\":false,\"error\":\"línea demasiado larga\"}\n");
+                connections.erase(found);
+            }
+        }
+    }
+    std::fprintf(stderr, "Deteniendo el servidor\n");
+    ::close(listener);
+    readers.wait();
+    writer.wait();
+    connections.clear();
+    ::unlink(options.socketPath.c_str());
+    return 0;
+}